@@ -11,10 +11,34 @@
 #include "MyDB_Table.h"
 #include "MyDB_TableReaderWriter.h"
 #include "MyDB_BPlusTreeReaderWriter.h"
+#include "MyDB_SecondaryIndex.h"
 #include "MyDB_Schema.h"
 #include "QUnit.h"
 #include "Sorting.h"
+#include <chrono>
 #include <iostream>
+#include <math.h>
+
+// the schema of supplier.tbl
+MyDB_SchemaPtr makeSupplierSchema () {
+	MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema> ();
+	mySchema->appendAtt (make_pair ("suppkey", make_shared <MyDB_IntAttType> ()));
+	mySchema->appendAtt (make_pair ("name", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair ("address", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair ("nationkey", make_shared <MyDB_IntAttType> ()));
+	mySchema->appendAtt (make_pair ("phone", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair ("acctbal", make_shared <MyDB_DoubleAttType> ()));
+	mySchema->appendAtt (make_pair ("comment", make_shared <MyDB_StringAttType> ()));
+	return mySchema;
+}
+
+// creates a heap table with the given name in the given buffer manager, and loads supplier.tbl into it
+MyDB_TableReaderWriterPtr loadSupplierHeap (MyDB_BufferManagerPtr myMgr, string name) {
+	MyDB_TablePtr heapTable = make_shared <MyDB_Table> (name, name + ".bin", makeSupplierSchema ());
+	MyDB_TableReaderWriterPtr supplierHeap = make_shared <MyDB_TableReaderWriter> (heapTable, myMgr);
+	supplierHeap->loadFromTextFile ("supplier.tbl");
+	return supplierHeap;
+}
 
 int main () {
 
@@ -25,14 +49,7 @@ int main () {
 		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
 
 		// now make a schema
-		MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema> ();
-		mySchema->appendAtt (make_pair ("suppkey", make_shared <MyDB_IntAttType> ()));
-		mySchema->appendAtt (make_pair ("name", make_shared <MyDB_StringAttType> ()));
-		mySchema->appendAtt (make_pair ("address", make_shared <MyDB_StringAttType> ()));
-		mySchema->appendAtt (make_pair ("nationkey", make_shared <MyDB_IntAttType> ()));
-		mySchema->appendAtt (make_pair ("phone", make_shared <MyDB_StringAttType> ()));
-		mySchema->appendAtt (make_pair ("acctbal", make_shared <MyDB_DoubleAttType> ()));
-		mySchema->appendAtt (make_pair ("comment", make_shared <MyDB_StringAttType> ()));
+		MyDB_SchemaPtr mySchema = makeSupplierSchema ();
 
 		// use the schema to create a table
 		MyDB_TablePtr myTable = make_shared <MyDB_Table> ("supplier", "supplier.bin", mySchema);
@@ -40,7 +57,9 @@ int main () {
 		MyDB_BPlusTreeReaderWriter supplierTable ("suppkey", myTable, myMgr);
 
 		// load it from a text file
+		auto start = chrono :: steady_clock :: now ();
 		supplierTable.loadFromTextFile ("supplierBig.tbl");
+		double appendSecs = chrono :: duration <double> (chrono :: steady_clock :: now () - start).count ();
 
                 // there should be 320000 records
                 MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
@@ -92,6 +111,482 @@ int main () {
        	         		QUNIT_IS_EQUAL (counter, 32 * (highBound - lowBound + 1));
 			}
 		}
+
+		// the leaves of a tree built by appending are sorted and linked in order, so a scan
+		// of the whole key range sees every record, in order
+		{
+			MyDB_IntAttValPtr low = make_shared <MyDB_IntAttVal> ();
+			low->set (-1);
+			MyDB_IntAttValPtr high = make_shared <MyDB_IntAttVal> ();
+			high->set (10000);
+			myIter = supplierTable.getRangeIteratorAlt (low, high);
+			int counter = 0;
+			int lastKey = -1;
+			bool inOrder = true;
+			while (myIter->advance ()) {
+				myIter->getCurrent (temp);
+				if (temp->getAtt (0)->toInt () < lastKey)
+					inOrder = false;
+				lastKey = temp->getAtt (0)->toInt ();
+				counter++;
+			}
+			QUNIT_IS_EQUAL (counter, 320000);
+			QUNIT_IS_TRUE (inOrder);
+		}
+
+		// look up single keys; each suppkey is in the file 32 times
+		{
+			vector <MyDB_RecordPtr> matches;
+			MyDB_IntAttValPtr key = make_shared <MyDB_IntAttVal> ();
+			bool allRight = true;
+			auto start = chrono :: steady_clock :: now ();
+			for (int i = 0; i < 10000; i++) {
+				srand48 (i);
+				key->set (lrand48 () % 10000);
+				size_t numMatches = supplierTable.lookup (key, matches);
+				if (numMatches != 32)
+					allRight = false;
+				for (size_t j = 0; j < numMatches; j++)
+					if (matches[j]->getAtt (0)->toInt () != key->toInt ())
+						allRight = false;
+			}
+			auto middle = chrono :: steady_clock :: now ();
+			for (int i = 0; i < 10000; i++) {
+				srand48 (i);
+				key->set (lrand48 () % 10000);
+				myIter = supplierTable.getRangeIteratorAlt (key, key);
+				while (myIter->advance ())
+					myIter->getCurrent (temp);
+			}
+			auto end = chrono :: steady_clock :: now ();
+			cout << "10000 lookups: " << chrono :: duration <double> (middle - start).count () << " secs; as range queries: "
+				<< chrono :: duration <double> (end - middle).count () << " secs\n";
+			QUNIT_IS_TRUE (allRight);
+
+			// keys that are not there
+			key->set (-5);
+			QUNIT_IS_EQUAL (supplierTable.lookup (key, matches), 0);
+			key->set (10000);
+			QUNIT_IS_EQUAL (supplierTable.lookup (key, matches), 0);
+
+			// and look up a batch of keys, some of them more than once, and some missing
+			vector <MyDB_AttValPtr> keys;
+			for (int i = 0; i < 2000; i++) {
+				MyDB_IntAttValPtr key = make_shared <MyDB_IntAttVal> ();
+				key->set ((i * 7919) % 12000);
+				keys.push_back (key);
+			}
+			vector <int> counts (keys.size (), 0);
+			int lastKey = -1;
+			bool inOrder = true;
+			supplierTable.lookup (keys, temp, [&] (size_t i) {
+				if (temp->getAtt (0)->toInt () != keys[i]->toInt () || keys[i]->toInt () < lastKey)
+					inOrder = false;
+				lastKey = keys[i]->toInt ();
+				counts[i]++;
+			});
+			allRight = true;
+			for (size_t i = 0; i < keys.size (); i++)
+				if (counts[i] != (keys[i]->toInt () < 10000 ? 32 : 0))
+					allRight = false;
+			QUNIT_IS_TRUE (allRight);
+			QUNIT_IS_TRUE (inOrder);
+		}
+
+		// now build the same tree bottom-up, and compare it with the one built by appending
+		MyDB_TablePtr bulkTable = make_shared <MyDB_Table> ("supplierBulk", "supplierBulk.bin", mySchema);
+		MyDB_BPlusTreeReaderWriter bulkTree ("suppkey", bulkTable, myMgr);
+		start = chrono :: steady_clock :: now ();
+		pair <vector <size_t>, size_t> res = bulkTree.bulkLoadFromTextFile ("supplierBig.tbl", 1);
+		double bulkSecs = chrono :: duration <double> (chrono :: steady_clock :: now () - start).count ();
+		cout << "append: " << appendSecs << " secs, " << supplierTable.getNumPages () << " pages\n";
+		cout << "bulk load: " << bulkSecs << " secs, " << bulkTree.getNumPages () << " pages\n";
+		QUNIT_IS_EQUAL (res.second, 320000);
+		QUNIT_IS_EQUAL (res.first[3], 25);
+		QUNIT_IS_TRUE (bulkTree.getNumPages () < supplierTable.getNumPages ());
+
+		// a full scan sees every record, and a sorted range scan sees them in order
+		counter = 0;
+		myIter = bulkTree.getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			counter++;
+		}
+		QUNIT_IS_EQUAL (counter, 320000);
+
+		MyDB_IntAttValPtr low = make_shared <MyDB_IntAttVal> ();
+		low->set (0);
+		MyDB_IntAttValPtr high = make_shared <MyDB_IntAttVal> ();
+		high->set (9999);
+		myIter = bulkTree.getSortedRangeIteratorAlt (low, high);
+		counter = 0;
+		int lastKey = -1;
+		bool inOrder = true;
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			if (temp->getAtt (0)->toInt () < lastKey)
+				inOrder = false;
+			lastKey = temp->getAtt (0)->toInt ();
+			counter++;
+		}
+		QUNIT_IS_EQUAL (counter, 320000);
+		QUNIT_IS_TRUE (inOrder);
+
+		// rebuild the tree from the first one, with half-full pages; every range has to come out
+		// the same, including the ones whose bounds fall on the keys that separate the pages
+		res = bulkTree.bulkLoad (supplierTable, 0.5);
+		QUNIT_IS_EQUAL (res.second, 320000);
+		cout << "bulk load at 0.5: " << bulkTree.getNumPages () << " pages\n";
+		for (int i = 0; i < 100; i++) {
+			srand48 (i);
+			int lowBound = lrand48 () % 10000;
+			int highBound = lowBound + lrand48 () % 100;
+			low->set (lowBound);
+			high->set (highBound);
+			myIter = bulkTree.getRangeIteratorAlt (low, high);
+			counter = 0;
+			while (myIter->advance ()) {
+				myIter->getCurrent (temp);
+				counter++;
+			}
+			QUNIT_IS_EQUAL (counter, 32 * (min (highBound, 9999) - lowBound + 1));
+		}
+
+		// appending to a tree that was bulk loaded still works
+		MyDB_RecordPtr newRec = bulkTree.getEmptyRecord ();
+		newRec->fromString ("5000|Supplier#000005000|addr|3|13-000-000-0000|10.00|new|");
+		for (int i = 0; i < 10000; i++)
+			bulkTree.append (newRec);
+		low->set (5000);
+		high->set (5000);
+		myIter = bulkTree.getRangeIteratorAlt (low, high);
+		counter = 0;
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			counter++;
+		}
+		QUNIT_IS_EQUAL (counter, 10032);
+	}
+
+	{
+		// with tiny pages, a tree has several levels of directory pages, and a key with many
+		// duplicates is spread over many leaves and directory entries
+		MyDB_SchemaPtr mySchema = makeSupplierSchema ();
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile2");
+		MyDB_TableReaderWriterPtr supplierHeap = loadSupplierHeap (myMgr, "supplierHeap");
+
+		// count the records with each nation key
+		vector <int> counts (25, 0);
+		MyDB_RecordPtr temp = supplierHeap->getEmptyRecord ();
+		MyDB_RecordIteratorAltPtr myIter = supplierHeap->getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			counts[temp->getAtt (3)->toInt ()]++;
+		}
+
+		MyDB_TablePtr treeTable = make_shared <MyDB_Table> ("supplierNation", "supplierNation.bin", mySchema);
+		MyDB_BPlusTreeReaderWriter nationTree ("nationkey", treeTable, myMgr);
+		myIter = supplierHeap->getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			nationTree.append (temp);
+		}
+
+		// every range of nation keys has to have the right number of records
+		MyDB_IntAttValPtr low = make_shared <MyDB_IntAttVal> ();
+		MyDB_IntAttValPtr high = make_shared <MyDB_IntAttVal> ();
+		bool allRight = true;
+		for (int lowBound = 0; lowBound < 25; lowBound++) {
+			int expected = 0;
+			for (int highBound = lowBound; highBound < 25; highBound += 3) {
+				for (int i = highBound - 2; i <= highBound; i++)
+					expected += (i >= lowBound ? counts[i] : 0);
+				low->set (lowBound);
+				high->set (highBound);
+				myIter = nationTree.getRangeIteratorAlt (low, high);
+				int counter = 0;
+				while (myIter->advance ()) {
+					myIter->getCurrent (temp);
+					counter++;
+				}
+				if (counter != expected)
+					allRight = false;
+			}
+		}
+		QUNIT_IS_TRUE (allRight);
+
+		// and the same has to hold for a tree that is bulk loaded
+		nationTree.bulkLoad (*supplierHeap, 0.7);
+		low->set (7);
+		high->set (7);
+		myIter = nationTree.getSortedRangeIteratorAlt (low, high);
+		int counter = 0;
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			counter++;
+		}
+		QUNIT_IS_EQUAL (counter, counts[7]);
+	}
+
+	{
+		// the directory pages of a tree on a string are prefix compressed, and only as much of each
+		// key as is needed goes into the directory; every key has to be found, whether the keys are
+		// appended in order (the names), out of order (the addresses), or bulk loaded
+		MyDB_SchemaPtr mySchema = makeSupplierSchema ();
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile2");
+		MyDB_TableReaderWriterPtr supplierHeap = loadSupplierHeap (myMgr, "supplierStrings");
+
+		for (string att : vector <string> {"name", "address"}) {
+			int whichAtt = mySchema->getAttByName (att).first;
+			MyDB_TablePtr treeTable = make_shared <MyDB_Table> ("supplierBy" + att, "supplierBy" + att + ".bin", mySchema);
+			MyDB_BPlusTreeReaderWriter stringTree (att, treeTable, myMgr);
+			MyDB_RecordPtr temp = supplierHeap->getEmptyRecord ();
+			MyDB_RecordIteratorAltPtr myIter = supplierHeap->getIteratorAlt ();
+			while (myIter->advance ()) {
+				myIter->getCurrent (temp);
+				stringTree.append (temp);
+			}
+
+			for (int pass = 0; pass < 2; pass++) {
+
+				// look up every key, along with a key that is a prefix of it, which is not in the tree
+				bool allFound = true;
+				int numRecs = 0;
+				vector <MyDB_RecordPtr> matches;
+				MyDB_StringAttValPtr key = make_shared <MyDB_StringAttVal> ();
+				myIter = supplierHeap->getIteratorAlt ();
+				while (myIter->advance ()) {
+					myIter->getCurrent (temp);
+					string val = temp->getAtt (whichAtt)->toString ();
+					key->set (val);
+					size_t numMatches = stringTree.lookup (key, matches);
+					if (numMatches < 1 || matches[0]->getAtt (whichAtt)->toString () != val)
+						allFound = false;
+					key->set (val.substr (0, val.size () - 1));
+					numMatches = stringTree.lookup (key, matches);
+					for (size_t i = 0; i < numMatches; i++)
+						if (matches[i]->getAtt (whichAtt)->toString () != key->toString ())
+							allFound = false;
+					numRecs++;
+				}
+				QUNIT_IS_TRUE (allFound);
+				QUNIT_IS_EQUAL (numRecs, 10000);
+
+				// and a range has to come back in order
+				MyDB_StringAttValPtr low = make_shared <MyDB_StringAttVal> ();
+				MyDB_StringAttValPtr high = make_shared <MyDB_StringAttVal> ();
+				low->set ("Supplier#000001");
+				high->set ("Supplier#000005");
+				if (att == "address") {
+					low->set ("B");
+					high->set ("Q");
+				}
+				myIter = stringTree.getRangeIteratorAlt (low, high);
+				int inRange = 0;
+				string last = "";
+				bool inOrder = true;
+				while (myIter->advance ()) {
+					myIter->getCurrent (temp);
+					string val = temp->getAtt (whichAtt)->toString ();
+					if (val < last)
+						inOrder = false;
+					last = val;
+					inRange++;
+				}
+				int expected = 0;
+				myIter = supplierHeap->getIteratorAlt ();
+				while (myIter->advance ()) {
+					myIter->getCurrent (temp);
+					string val = temp->getAtt (whichAtt)->toString ();
+					if (val >= low->toString () && val <= high->toString ())
+						expected++;
+				}
+				QUNIT_IS_TRUE (inOrder);
+				QUNIT_IS_EQUAL (inRange, expected);
+
+				// the second time, the tree is bulk loaded
+				if (pass == 0)
+					stringTree.bulkLoad (*supplierHeap, 0.7);
+			}
+		}
+	}
+
+	{
+		// when the keys are appended in increasing order, every split is at the right edge of the
+		// tree, so the pages that are left behind are full; splitting at the median instead (a
+		// split fill factor of 0.5) leaves them half full.  Every key has to be found either way
+		MyDB_SchemaPtr mySchema = makeSupplierSchema ();
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile2");
+		MyDB_TableReaderWriterPtr supplierHeap = loadSupplierHeap (myMgr, "supplierInOrder");
+
+		vector <size_t> numPages;
+		for (double splitFillFactor : vector <double> {BPLUS_DEFAULT_SPLIT_FILL_FACTOR, 0.5}) {
+			MyDB_TablePtr treeTable = make_shared <MyDB_Table> ("supplierAppended", "supplierAppended.bin", mySchema);
+			MyDB_BPlusTreeReaderWriter appendedTree ("suppkey", treeTable, myMgr);
+			appendedTree.setSplitFillFactor (splitFillFactor);
+			MyDB_RecordPtr temp = supplierHeap->getEmptyRecord ();
+			MyDB_RecordIteratorAltPtr myIter = supplierHeap->getIteratorAlt ();
+			int lastKey = -1;
+			bool inOrder = true;
+			while (myIter->advance ()) {
+				myIter->getCurrent (temp);
+				if (temp->getAtt (0)->toInt () < lastKey)
+					inOrder = false;
+				lastKey = temp->getAtt (0)->toInt ();
+				appendedTree.append (temp);
+			}
+			QUNIT_IS_TRUE (inOrder);
+			numPages.push_back (appendedTree.getNumPages ());
+
+			bool allFound = true;
+			vector <MyDB_RecordPtr> matches;
+			MyDB_IntAttValPtr key = make_shared <MyDB_IntAttVal> ();
+			for (int i = 1; i <= 10000; i++) {
+				key->set (i);
+				if (appendedTree.lookup (key, matches) != 1 || matches[0]->getAtt (0)->toInt () != i)
+					allFound = false;
+			}
+			QUNIT_IS_TRUE (allFound);
+
+			// and records that are not at the end still go where they belong
+			key->set (0);
+			temp->getAtt (0)->set (key);
+			temp->recordContentHasChanged ();
+			for (int i = 0; i < 100; i++)
+				appendedTree.append (temp);
+			QUNIT_IS_EQUAL (appendedTree.lookup (key, matches), 100);
+		}
+
+		// a tree built by appending the keys in order is about as small as one that is bulk loaded
+		// with full pages, and much smaller than one that always splits at the median (with only
+		// a few records on a page, a median split leaves the pages more than half full)
+		MyDB_TablePtr bulkTable = make_shared <MyDB_Table> ("supplierInOrderBulk", "supplierInOrderBulk.bin", mySchema);
+		MyDB_BPlusTreeReaderWriter bulkTree ("suppkey", bulkTable, myMgr);
+		bulkTree.bulkLoad (*supplierHeap, 1.0);
+		cout << "appended in order: " << numPages[0] << " pages; splitting at the median: " << numPages[1] <<
+			" pages; bulk loaded: " << bulkTree.getNumPages () << " pages\n";
+		QUNIT_IS_TRUE (numPages[0] <= bulkTree.getNumPages () * 1.1);
+		QUNIT_IS_TRUE (numPages[0] * 1.3 < numPages[1]);
+	}
+
+	{
+		// secondary indexes over two attributes of a heap table; the one on the name also
+		// includes the suppkey and the balance in its entries
+		MyDB_SchemaPtr mySchema = makeSupplierSchema ();
+
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (4096, 128, "tempFile3");
+		MyDB_TablePtr heapTable = make_shared <MyDB_Table> ("supplierIndexed", "supplierIndexed.bin", mySchema);
+		MyDB_TableReaderWriterPtr supplierHeap = make_shared <MyDB_TableReaderWriter> (heapTable, myMgr);
+		MyDB_TablePtr balTable = MyDB_SecondaryIndex :: makeIndexTable ("supplierByBal", "supplierByBal.bin", 
+			heapTable, "acctbal", vector <string> ());
+		MyDB_TablePtr nameTable = MyDB_SecondaryIndex :: makeIndexTable ("supplierByName", "supplierByName.bin", 
+			heapTable, "name", vector <string> {"suppkey", "acctbal"});
+		QUNIT_IS_TRUE (MyDB_SecondaryIndex :: makeIndexTable ("nothing", "nothing.bin", heapTable, "foo",
+			vector <string> ()) == nullptr);
+		QUNIT_IS_TRUE (MyDB_SecondaryIndex :: makeIndexTable ("nothing", "nothing.bin", heapTable, "name",
+			vector <string> {"foo"}) == nullptr);
+		QUNIT_IS_EQUAL (balTable->getIndexOf (), "supplierIndexed");
+		MyDB_SecondaryIndexPtr byBal = make_shared <MyDB_SecondaryIndex> (balTable, *supplierHeap, myMgr);
+		MyDB_SecondaryIndexPtr byName = make_shared <MyDB_SecondaryIndex> (nameTable, *supplierHeap, myMgr);
+		supplierHeap->addIndex (byBal);
+		supplierHeap->addIndex (byName);
+
+		// loading the table builds the indexes
+		supplierHeap->loadFromTextFile ("supplier.tbl");
+		QUNIT_IS_EQUAL (byBal->getTree ()->getTable ()->getTupleCount (), 10000);
+
+		// checks that a range scan over the index gets the same records as a scan of the table,
+		// in the order that they are in the table
+		MyDB_RecordPtr temp = supplierHeap->getEmptyRecord ();
+		auto checkRange = [&] (MyDB_SecondaryIndexPtr index, int whichAtt, MyDB_AttValPtr low, MyDB_AttValPtr high) {
+			int expected = 0;
+			long long keySum = 0;
+			MyDB_RecordIteratorAltPtr myIter = supplierHeap->getIteratorAlt ();
+			while (myIter->advance ()) {
+				myIter->getCurrent (temp);
+				MyDB_AttValPtr att = temp->getAtt (whichAtt);
+				if ((whichAtt == 1 && att->toString () >= low->toString () && att->toString () <= high->toString ()) ||
+					(whichAtt == 5 && att->toDouble () >= low->toDouble () && att->toDouble () <= high->toDouble ())) {
+					expected++;
+					keySum += temp->getAtt (0)->toInt ();
+				}
+			}
+			int counter = 0;
+			long long lastKey = -1;
+			bool inOrder = true;
+			myIter = index->getRangeIteratorAlt (low, high);
+			while (myIter->advance ()) {
+				myIter->getCurrent (temp);
+				counter++;
+				keySum -= temp->getAtt (0)->toInt ();
+				inOrder = inOrder && temp->getAtt (0)->toInt () > lastKey;
+				lastKey = temp->getAtt (0)->toInt ();
+			}
+			return counter == expected && keySum == 0 && inOrder;
+		};
+
+		MyDB_DoubleAttValPtr lowBal = make_shared <MyDB_DoubleAttVal> ();
+		MyDB_DoubleAttValPtr highBal = make_shared <MyDB_DoubleAttVal> ();
+		lowBal->set (1000.0);
+		highBal->set (1100.0);
+		QUNIT_IS_TRUE (checkRange (byBal, 5, lowBal, highBal));
+		lowBal->set (-2000.0);
+		highBal->set (20000.0);
+		QUNIT_IS_TRUE (checkRange (byBal, 5, lowBal, highBal));
+		MyDB_StringAttValPtr lowName = make_shared <MyDB_StringAttVal> ();
+		MyDB_StringAttValPtr highName = make_shared <MyDB_StringAttVal> ();
+		lowName->set ("Supplier#000002243");
+		highName->set ("Supplier#000002303");
+		QUNIT_IS_TRUE (checkRange (byName, 1, lowName, highName));
+
+		// the included atts are copied into the entries
+		QUNIT_IS_TRUE (byName->covers ("&& (> ([acctbal], double [0.0]), == ([name], string[Supplier#000000001]))"));
+		QUNIT_IS_TRUE (!byName->covers ("+ ([suppkey], [nationkey])"));
+		QUNIT_IS_TRUE (!byName->covers ("[page]"));
+		QUNIT_IS_TRUE (!byBal->covers ("[suppkey]"));
+		long long keySum = 0;
+		double balSum = 0;
+		MyDB_RecordIteratorAltPtr myIter = byName->getRangeIteratorAlt (lowName, highName);
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			keySum += temp->getAtt (0)->toInt ();
+			balSum += temp->getAtt (5)->toDouble ();
+		}
+		MyDB_RecordPtr entry = byName->getTree ()->getEmptyRecord ();
+		myIter = byName->getTree ()->getRangeIteratorAlt (lowName, highName);
+		while (myIter->advance ()) {
+			myIter->getCurrent (entry);
+			keySum -= entry->getAtt (3)->toInt ();
+			balSum -= entry->getAtt (4)->toDouble ();
+		}
+		QUNIT_IS_EQUAL (keySum, 0);
+		QUNIT_IS_TRUE (fabs (balSum) < 0.01);
+
+		// records that are appended are added to the indexes
+		myIter = supplierHeap->getIteratorAlt (0, 0);
+		myIter->advance ();
+		myIter->getCurrent (temp);
+		MyDB_DoubleAttValPtr bal = make_shared <MyDB_DoubleAttVal> ();
+		for (int i = 0; i < 500; i++) {
+			temp->getAtt (0)->fromInt (10001 + i);
+			bal->set (20000.0 + i);
+			temp->getAtt (5)->set (bal);
+			temp->recordContentHasChanged ();
+			supplierHeap->append (temp);
+		}
+		lowBal->set (20100.0);
+		highBal->set (20199.0);
+		int counter = 0;
+		myIter = byBal->getRangeIteratorAlt (lowBal, highBal);
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			counter++;
+		}
+		QUNIT_IS_EQUAL (counter, 100);
+		lowBal->set (-2000.0);
+		highBal->set (30000.0);
+		QUNIT_IS_TRUE (checkRange (byBal, 5, lowBal, highBal));
+		QUNIT_IS_TRUE (checkRange (byName, 1, lowName, highName));
 	}
 }
 
@@ -70,6 +70,10 @@ public:
 
 	// returns the page size
 	size_t getPageSize ();
+
+	// returns the number of pages that have been read in from disk since the buffer manager
+	// was created; a request for a page that is already buffered does not count
+	size_t getNumReads ();
 	
 private:
 
@@ -103,9 +107,16 @@ private:
 	// the number of buffer pages
 	size_t numPages;
 
+	// the number of pages read from disk
+	size_t numReads;
+
 	// so that the page can access these private methods
 	friend class MyDB_Page;
 	friend class SortMergeJoin;
+	friend class TopN;
+	friend class Aggregate;
+	friend class MyDB_BPlusTreeReaderWriter;
+	friend class IndexNestedLoopJoin;
 
 	// kick out the LRU page
 	void kickOutPage ();
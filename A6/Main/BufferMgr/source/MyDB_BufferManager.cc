@@ -28,6 +28,10 @@ size_t MyDB_BufferManager :: getPageSize () {
 	return pageSize;
 }
 
+size_t MyDB_BufferManager :: getNumReads () {
+	return numReads;
+}
+
 MyDB_PageHandle MyDB_BufferManager :: getPage (MyDB_TablePtr whichTable, long i) {
 		
 	// open the file, if it is not open
@@ -177,6 +181,7 @@ void MyDB_BufferManager :: access (MyDB_PagePtr updateMe) {
 		// and read it
 		lseek (fds[updateMe->myTable], updateMe->pos * pageSize, SEEK_SET);
 		read (fds[updateMe->myTable], updateMe->bytes, pageSize);
+		numReads++;
 
 		updateMe->timeTick = ++lastTimeTick;
 		lastUsed.insert (updateMe);
@@ -238,6 +243,7 @@ MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (MyDB_TablePtr whichTable, l
 		// and read it
 		lseek (fds[returnVal->myTable], returnVal->pos * pageSize, SEEK_SET);
 		read (fds[returnVal->myTable], returnVal->bytes, pageSize);
+		numReads++;
 
 	}	
 
@@ -284,6 +290,9 @@ MyDB_BufferManager :: MyDB_BufferManager (size_t pageSizeIn, size_t numPagesIn,
 	// position in temp file
 	lastTempPos = 0;
 
+	// nothing has been read yet
+	numReads = 0;
+
 	// the number of pages
 	numPages = numPagesIn;
 
@@ -0,0 +1,85 @@
+
+#ifndef COLUMN_STATS_H
+#define COLUMN_STATS_H
+
+#include "MyDB_Catalog.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// the comparisons that selectivity can be estimated for
+enum MyDB_CompOp {Equals, NotEquals, LessThan, LessThanOrEqual, GreaterThan, GreaterThanOrEqual};
+
+// This class holds the statistics gathered for one attribute by ANALYZE: the min and the max,
+// the number of (non-null) values, the most common values with their frequencies, and an
+// equi-depth histogram over the rest of the values.  Values are kept as strings; if the
+// attribute is numeric, they are compared as doubles, and otherwise as strings.
+class MyDB_ColumnStats {
+
+public:
+
+	// create an empty set of stats
+	MyDB_ColumnStats ();
+
+	// build the stats for an attribute; sample is a (uniform) sample of the attribute's values,
+	// minVal and maxVal are the exact extremes, numVals is the number of non-null values in the
+	// table, and numDistinct is an estimate of the number of distinct values
+	void build (vector <string> &sample, string minVal, string maxVal, size_t numVals,
+		size_t numDistinct, bool isNumeric);
+
+	// estimate the fraction of the attribute's values for which "value op compareTo" is true
+	double getSelectivity (MyDB_CompOp op, string compareTo);
+
+	// estimate the fraction of the attribute's values that fall in [low, high]
+	double getRangeSelectivity (string low, string high);
+
+	// access the stats
+	string &getMin ();
+	string &getMax ();
+	size_t getNumVals ();
+	vector <string> &getMCVs ();
+	vector <double> &getMCVFreqs ();
+	vector <string> &getHistogram ();
+
+	// load/store the stats for the given attribute of the given table; fromCatalog returns false
+	// if the attribute has not been analyzed
+	bool fromCatalog (string tableName, string attName, MyDB_CatalogPtr catalog);
+	void putInCatalog (string tableName, string attName, MyDB_CatalogPtr catalog);
+
+private:
+
+	// returns true if lhs < rhs, respecting the type of the attribute
+	bool lessThan (const string &lhs, const string &rhs);
+
+	// the fraction of the values not in the MCV list that are less than (or equal to, if
+	// orEqual is true) the given value, estimated using the histogram
+	double histogramFraction (const string &value, bool orEqual);
+
+	// the fraction of all of the values that are less than (or equal to) the given value
+	double fractionBelow (const string &value, bool orEqual);
+
+	// the fraction of all of the values that are equal to the given value
+	double fractionEqual (const string &value);
+
+	// the extremes of the attribute
+	string minVal;
+	string maxVal;
+
+	// the number of non-null values, and the number of distinct values
+	size_t numVals;
+	size_t numDistinct;
+
+	// true if the values are compared as numbers
+	bool isNumeric;
+
+	// the most common values, and the fraction of the table that each accounts for
+	vector <string> mcvs;
+	vector <double> mcvFreqs;
+
+	// the bucket boundaries of the equi-depth histogram over the non-MCV values; there are
+	// histogram.size () - 1 buckets, each holding the same number of values
+	vector <string> histogram;
+};
+
+#endif
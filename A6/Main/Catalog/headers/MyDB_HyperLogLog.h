@@ -0,0 +1,48 @@
+
+#ifndef HYPER_LOG_LOG_H
+#define HYPER_LOG_LOG_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// the number of bits of the hash used to pick a register; there are 2^HLL_BITS registers,
+// which gives a standard error of about 1.04 / sqrt (2^HLL_BITS), or 1.6%
+#define HLL_BITS 12
+
+// This class implements a HyperLogLog sketch, used to estimate the number of distinct
+// values of an attribute.  Values are added by hash (the output of MyDB_AttVal :: hash ()),
+// and two sketches built over different parts of a table can be merged to obtain exactly
+// the sketch that would have been built over all of the data.
+class MyDB_HyperLogLog {
+
+public:
+
+	// creates an empty sketch
+	MyDB_HyperLogLog ();
+
+	// add a value to the sketch, given its hash
+	void add (size_t hash);
+
+	// merge the contents of the other sketch into this one
+	void merge (MyDB_HyperLogLog &fromMe);
+
+	// the estimated number of distinct values added to the sketch
+	size_t estimate ();
+
+	// forget everything in the sketch
+	void clear ();
+
+	// serialize the sketch into a string that can be stored in the catalog, and
+	// get it back; fromString returns false if the string is not a valid sketch
+	string toString ();
+	bool fromString (string fromMe);
+
+private:
+
+	// the registers; each holds the largest rank seen for the hashes that map to it
+	vector <unsigned char> registers;
+};
+
+#endif
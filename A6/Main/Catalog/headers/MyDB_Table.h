@@ -4,8 +4,11 @@
 
 #include <iostream>
 #include "MyDB_Catalog.h"
+#include "MyDB_ColumnStats.h"
+#include "MyDB_HyperLogLog.h"
 #include "MyDB_Schema.h"
 #include "MyDB_Table.h"
+#include "MyDB_ZoneMap.h"
 #include <memory>
 #include <string>
 
@@ -71,14 +74,30 @@ public:
 	// the sort att
 	string &getSortAtt ();
 
-	// the file type (ex: "heap" or "bplustree")
+	// the file type (ex: "heap", "pax", or "bplustree")
 	string &getFileType ();
 
+	// true if the file is of type "pax", so that the records on each page are stored a
+	// column at a time (see MyDB_PaxPage.h)
+	bool hasPaxPages ();
+
+	// the layout of the pages in the file: "packed" (the default; records are stored back to
+	// back) or "slotted" (a slot directory at the front of each page, records at the back)
+	string &getPageFormat ();
+	void setPageFormat (string toMe);
+	bool hasSlottedPages ();
+
+	// if this file is a secondary index (see MyDB_SecondaryIndex.h), the name of the table that
+	// it indexes; otherwise, the empty string
+	string &getIndexOf ();
+	void setIndexOf (string toMe);
+
 	// get/set the root location
 	void setRootLocation (int toMe);
 	int getRootLocation ();
 
-        // get the distinct value count for an attribute
+        // get the distinct value count for an attribute; this comes from the attribute's
+        // HyperLogLog sketch, if the table has sketches
         size_t getDistinctValues (string forMe);
         size_t getDistinctValues (int forMe);
 
@@ -89,11 +108,56 @@ public:
         void setTupleCount (size_t toMe);
         size_t getTupleCount ();
 
+	// get the distinct value sketch for an attribute; these are kept up to date as
+	// records are appended to the table
+	MyDB_HyperLogLog &getSketch (int forMe);
+
+	// merge one sketch per attribute (ex: built by a parallel loader) into the table's sketches
+	void mergeSketches (vector <MyDB_HyperLogLog> &fromMe);
+
+	// forget all of the statistics (distinct values and tuple count) for the table;
+	// this is done when the table is emptied
+	void clearStats ();
+
+	// set the per-attribute stats computed by ANALYZE (one entry per attribute), and
+	// see if there are any
+	void setColumnStats (vector <MyDB_ColumnStats> &toMe);
+	bool hasColumnStats ();
+
+	// get the ANALYZE stats for an attribute; only valid if hasColumnStats () is true
+	MyDB_ColumnStats &getColumnStats (int forMe);
+
+	// estimate the fraction of the tuples for which "att op value" is true; value is given
+	// as a string (ex: "12" or "1994-05-12").  If the table has not been analyzed, this falls
+	// back on the distinct value count for equality, and on a fixed guess otherwise
+	double getSelectivity (string att, MyDB_CompOp op, string value);
+
+	// estimate the fraction of the tuples for which low <= att <= high
+	double getRangeSelectivity (string att, string low, string high);
+
+	// get the per-page zone map of a heap (or PAX) file, used to skip pages during scans;
+	// this is read from the side file the first time that it is needed.  Returns nullptr
+	// for files that are not heap or PAX files
+	MyDB_ZoneMapPtr getZoneMap ();
+
 private:
 
+	// make sure that there is one sketch for every attribute
+	void checkSketches ();
+
 	// the distinct value counts
 	vector <size_t> allCounts;
 
+	// the distinct value sketches, one per attribute
+	vector <MyDB_HyperLogLog> sketches;
+
+	// the stats computed by ANALYZE, one per attribute (empty if never analyzed)
+	vector <MyDB_ColumnStats> columnStats;
+
+	// the zone map, and whether it should be read from its side file
+	MyDB_ZoneMapPtr zoneMap;
+	bool zonesOnDisk;
+
 	// the number of tuples
 	int count;
 
@@ -102,6 +166,12 @@ private:
 
 	// the type of the file
 	string fileType;
+
+	// the page format
+	string pageFormat;
+
+	// the table that this file is an index of
+	string indexOf;
 	
 	// the last used page in the table
 	int last;
@@ -0,0 +1,125 @@
+
+#ifndef ZONE_MAP_H
+#define ZONE_MAP_H
+
+#include <memory>
+#include "MyDB_ColumnStats.h"
+#include "MyDB_Record.h"
+#include "MyDB_Schema.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// the kinds of attributes that a zone map summarizes; booleans are not summarized
+enum MyDB_ZoneKind {ZoneNone, ZoneNumeric, ZoneString};
+
+// This class holds the zone of one page: for each numeric attribute, the smallest and largest
+// value on the page (ints are kept as doubles, which is exact), and for each string attribute,
+// the smallest and largest string.  A zone is either "unknown" (nothing can be said about the
+// page, so the page must always be read) or it covers every record on the page.
+class MyDB_PageZone {
+
+public:
+
+	// creates an unknown zone
+	MyDB_PageZone ();
+
+	// makes this the zone of an empty page with the given number of attributes
+	void setEmpty (size_t numAtts);
+
+	// forget everything; the zone becomes unknown
+	void setUnknown ();
+
+	// true if the zone describes the page
+	bool isKnown ();
+
+	// extend the zone so that it covers the given value of the given attribute
+	void addValue (int whichAtt, double val);
+	void addValue (int whichAtt, const string &val);
+
+	// returns false only if no value in the zone can satisfy "att op val"; if the zone
+	// is unknown or the attribute was not summarized, this is always true
+	bool mayMatch (int whichAtt, MyDB_CompOp op, double val);
+	bool mayMatch (int whichAtt, MyDB_CompOp op, const string &val);
+
+private:
+
+	friend class MyDB_ZoneMap;
+
+	// true if the zone is known
+	bool known;
+
+	// for each attribute, true once some value has been added
+	vector <char> seen;
+
+	// the ranges for numeric attributes and for string attributes (indexed by attribute)
+	vector <double> lowNum, highNum;
+	vector <string> lowStr, highStr;
+};
+
+// This class holds one zone per page of a heap file.  It is kept by the MyDB_Table, and it is
+// written into a small side file next to the table's storage location ("<file>.zones").
+// The zone of a page becomes known when the page is cleared, and is then extended every time
+// a record is appended; a page whose contents are written some other way has an unknown zone
+// (so it is never skipped) until its zone is set explicitly.
+//
+// Since the side file is only written along with the catalog, the side file that the map was
+// read from (or last written to) is deleted as soon as the map changes; this way, a table that
+// is changed without the catalog being written again never gets stale zones.
+class MyDB_ZoneMap;
+typedef shared_ptr <MyDB_ZoneMap> MyDB_ZoneMapPtr;
+
+class MyDB_ZoneMap {
+
+public:
+
+	// creates a zone map for a table with the given schema; every page's zone is unknown
+	MyDB_ZoneMap (MyDB_SchemaPtr forMe);
+
+	// make every zone unknown
+	void clear ();
+
+	// the page has been emptied out, so its zone is known and empty
+	void resetPage (int whichPage);
+
+	// the page has been overwritten in some way that is not tracked
+	void forgetPage (int whichPage);
+
+	// extend the zone of the page so that it covers the record
+	void addRecord (int whichPage, MyDB_RecordPtr addMe);
+
+	// replace the zone of the page (ex: with one that was computed as the page was built)
+	void setZone (int whichPage, MyDB_PageZone &toMe);
+
+	// get the zone of a page; pages past the end of the map have an unknown zone
+	MyDB_PageZone &getZone (int whichPage);
+
+	// the kind of summary that is kept for each attribute
+	MyDB_ZoneKind getKind (int whichAtt);
+	vector <MyDB_ZoneKind> &getKinds ();
+
+	// write the map to the given file, and read it back; load returns false (and leaves
+	// every zone unknown) if the file is missing or does not match the schema
+	bool save (string toMe);
+	bool load (string fromMe);
+
+private:
+
+	// called before the map is changed; this deletes the side file that matches the map
+	void changed ();
+
+	// the side file that holds exactly this map, if there is one
+	string fileName;
+
+	// the kind of each attribute
+	vector <MyDB_ZoneKind> kinds;
+
+	// the zones, one per page
+	vector <MyDB_PageZone> zones;
+
+	// returned for pages that are not in the map
+	MyDB_PageZone unknown;
+};
+
+#endif
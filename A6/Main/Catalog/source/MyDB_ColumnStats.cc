@@ -0,0 +1,326 @@
+
+#ifndef COLUMN_STATS_C
+#define COLUMN_STATS_C
+
+#include <algorithm>
+#include <map>
+#include <stdlib.h>
+#include "MyDB_ColumnStats.h"
+
+using namespace std;
+
+// the max number of most common values that are remembered
+#define NUM_MCVS 32
+
+// the max number of buckets in the histogram
+#define NUM_BUCKETS 32
+
+// a value must be this many times more frequent than average to be a most common value
+#define MCV_FACTOR 1.25
+
+// the catalog uses '|' and '#' as separators, so they are escaped in the values stored there; also,
+// an empty entry cannot be stored in a catalog list, so every value is prefixed with a '='
+static string escape (const string &fromMe) {
+	string res ("=");
+	for (char c : fromMe) {
+		if (c == '%')
+			res += "%25";
+		else if (c == '#')
+			res += "%23";
+		else if (c == '|')
+			res += "%7C";
+		else if (c == '\n')
+			res += "%0A";
+		else
+			res += c;
+	}
+	return res;
+}
+
+static string unescape (const string &fromMe) {
+	string res;
+	for (size_t i = 1; i < fromMe.size (); i++) {
+		if (fromMe[i] == '%' && i + 2 < fromMe.size ()) {
+			res += (char) stoi (fromMe.substr (i + 1, 2), nullptr, 16);
+			i += 2;
+		} else {
+			res += fromMe[i];
+		}
+	}
+	return res;
+}
+
+MyDB_ColumnStats :: MyDB_ColumnStats () {
+	numVals = 0;
+	numDistinct = 0;
+	isNumeric = false;
+}
+
+bool MyDB_ColumnStats :: lessThan (const string &lhs, const string &rhs) {
+	if (isNumeric)
+		return strtod (lhs.c_str (), nullptr) < strtod (rhs.c_str (), nullptr);
+	return lhs < rhs;
+}
+
+void MyDB_ColumnStats :: build (vector <string> &sample, string minValIn, string maxValIn, size_t numValsIn,
+	size_t numDistinctIn, bool isNumericIn) {
+
+	minVal = minValIn;
+	maxVal = maxValIn;
+	numVals = numValsIn;
+	numDistinct = numDistinctIn;
+	isNumeric = isNumericIn;
+	mcvs.clear ();
+	mcvFreqs.clear ();
+	histogram.clear ();
+
+	if (sample.size () == 0)
+		return;
+
+	// sort the sample, and count each of the values in it
+	sort (sample.begin (), sample.end (), [this] (const string &lhs, const string &rhs) {
+		return lessThan (lhs, rhs);
+	});
+	vector <pair <size_t, string>> allCounts;
+	for (size_t i = 0; i < sample.size ();) {
+		size_t j = i + 1;
+		while (j < sample.size () && sample[j] == sample[i])
+			j++;
+		allCounts.push_back (make_pair (j - i, sample[i]));
+		i = j;
+	}
+
+	// we have seen at least this many distinct values
+	if (numDistinct < allCounts.size ())
+		numDistinct = allCounts.size ();
+
+	// if the sample has only a few values, they are all most common values; otherwise, take
+	// the values that are noticeably more frequent than average
+	vector <pair <size_t, string>> byCount = allCounts;
+	stable_sort (byCount.begin (), byCount.end (), [] (const pair <size_t, string> &lhs, 
+		const pair <size_t, string> &rhs) {
+		return lhs.first > rhs.first;
+	});
+	double avgCount = sample.size () / (double) numDistinct;
+	map <string, bool> isMCV;
+	for (auto &a : byCount) {
+		if (mcvs.size () == NUM_MCVS)
+			break;
+		if (byCount.size () > NUM_MCVS && (a.first < 2 || a.first < MCV_FACTOR * avgCount))
+			break;
+		mcvs.push_back (a.second);
+		mcvFreqs.push_back (a.first / (double) sample.size ());
+		isMCV[a.second] = true;
+	}
+
+	// now build the equi-depth histogram over everything else
+	vector <string> rest;
+	for (auto &s : sample) {
+		if (isMCV.count (s) == 0)
+			rest.push_back (s);
+	}
+	if (rest.size () == 0)
+		return;
+
+	size_t numBuckets = rest.size () - 1 < NUM_BUCKETS ? rest.size () - 1 : NUM_BUCKETS;
+	if (numBuckets == 0) {
+		histogram.push_back (rest[0]);
+		return;
+	}
+	for (size_t i = 0; i <= numBuckets; i++)
+		histogram.push_back (rest[i * (rest.size () - 1) / numBuckets]);
+}
+
+double MyDB_ColumnStats :: histogramFraction (const string &value, bool orEqual) {
+
+	if (histogram.size () == 0)
+		return 0.0;
+
+	// values at or beyond the ends of the histogram
+	if (lessThan (value, histogram[0]) || (!orEqual && !lessThan (histogram[0], value)))
+		return 0.0;
+	size_t numBuckets = histogram.size () - 1;
+	if (lessThan (histogram[numBuckets], value) || (orEqual && !lessThan (value, histogram[numBuckets])))
+		return 1.0;
+	if (numBuckets == 0)
+		return 0.5;
+
+	// find the bucket with the value
+	size_t which = upper_bound (histogram.begin (), histogram.end (), value, [this] (const string &lhs, 
+		const string &rhs) {
+		return lessThan (lhs, rhs);
+	}) - histogram.begin () - 1;
+	if (which >= numBuckets)
+		which = numBuckets - 1;
+
+	// and assume that the values are spread uniformly over the bucket
+	double within = 0.5;
+	if (isNumeric) {
+		double low = strtod (histogram[which].c_str (), nullptr);
+		double high = strtod (histogram[which + 1].c_str (), nullptr);
+		if (high > low)
+			within = (strtod (value.c_str (), nullptr) - low) / (high - low);
+	}
+	return (which + within) / numBuckets;
+}
+
+double MyDB_ColumnStats :: fractionBelow (const string &value, bool orEqual) {
+
+	if (numVals == 0)
+		return 0.0;
+
+	// first, deal with the extremes
+	if (lessThan (value, minVal) || (!orEqual && !lessThan (minVal, value)))
+		return 0.0;
+	if (lessThan (maxVal, value) || (orEqual && !lessThan (value, maxVal)))
+		return 1.0;
+
+	// add up the most common values that are below the value
+	double res = 0.0;
+	double mcvTotal = 0.0;
+	for (size_t i = 0; i < mcvs.size (); i++) {
+		mcvTotal += mcvFreqs[i];
+		if (lessThan (mcvs[i], value) || (orEqual && !lessThan (value, mcvs[i])))
+			res += mcvFreqs[i];
+	}
+
+	// and then use the histogram for everything else
+	return res + (1.0 - mcvTotal) * histogramFraction (value, orEqual);
+}
+
+double MyDB_ColumnStats :: fractionEqual (const string &value) {
+
+	if (numVals == 0 || lessThan (value, minVal) || lessThan (maxVal, value))
+		return 0.0;
+
+	// see if this is a most common value
+	double mcvTotal = 0.0;
+	for (size_t i = 0; i < mcvs.size (); i++) {
+		if (!lessThan (mcvs[i], value) && !lessThan (value, mcvs[i]))
+			return mcvFreqs[i];
+		mcvTotal += mcvFreqs[i];
+	}
+
+	// it is not, so assume that all of the other values are equally likely
+	double rest = 1.0 - mcvTotal;
+	if (rest <= 0.0)
+		return 0.0;
+	if (numDistinct <= mcvs.size ())
+		return rest;
+	return rest / (numDistinct - mcvs.size ());
+}
+
+double MyDB_ColumnStats :: getSelectivity (MyDB_CompOp op, string compareTo) {
+
+	double res;
+	if (op == MyDB_CompOp :: Equals)
+		res = fractionEqual (compareTo);
+	else if (op == MyDB_CompOp :: NotEquals)
+		res = 1.0 - fractionEqual (compareTo);
+	else if (op == MyDB_CompOp :: LessThan)
+		res = fractionBelow (compareTo, false);
+	else if (op == MyDB_CompOp :: LessThanOrEqual)
+		res = fractionBelow (compareTo, true);
+	else if (op == MyDB_CompOp :: GreaterThan)
+		res = 1.0 - fractionBelow (compareTo, true);
+	else
+		res = 1.0 - fractionBelow (compareTo, false);
+
+	return res < 0.0 ? 0.0 : (res > 1.0 ? 1.0 : res);
+}
+
+double MyDB_ColumnStats :: getRangeSelectivity (string low, string high) {
+	double res = fractionBelow (high, true) - fractionBelow (low, false);
+	return res < 0.0 ? 0.0 : (res > 1.0 ? 1.0 : res);
+}
+
+string &MyDB_ColumnStats :: getMin () {
+	return minVal;
+}
+
+string &MyDB_ColumnStats :: getMax () {
+	return maxVal;
+}
+
+size_t MyDB_ColumnStats :: getNumVals () {
+	return numVals;
+}
+
+vector <string> &MyDB_ColumnStats :: getMCVs () {
+	return mcvs;
+}
+
+vector <double> &MyDB_ColumnStats :: getMCVFreqs () {
+	return mcvFreqs;
+}
+
+vector <string> &MyDB_ColumnStats :: getHistogram () {
+	return histogram;
+}
+
+bool MyDB_ColumnStats :: fromCatalog (string tableName, string attName, MyDB_CatalogPtr catalog) {
+
+	string prefix = tableName + ".stats." + attName;
+	string temp;
+	if (!catalog->getString (prefix + ".numVals", temp))
+		return false;
+	numVals = stoull (temp);
+
+	catalog->getString (prefix + ".numDistinct", temp);
+	numDistinct = stoull (temp);
+
+	catalog->getString (prefix + ".isNumeric", temp);
+	isNumeric = (temp == "true");
+
+	catalog->getString (prefix + ".min", temp);
+	minVal = unescape (temp);
+	catalog->getString (prefix + ".max", temp);
+	maxVal = unescape (temp);
+
+	vector <string> allVals;
+	mcvs.clear ();
+	catalog->getStringList (prefix + ".mcvs", allVals);
+	for (auto &a : allVals)
+		mcvs.push_back (unescape (a));
+
+	allVals.clear ();
+	mcvFreqs.clear ();
+	catalog->getStringList (prefix + ".mcvFreqs", allVals);
+	for (auto &a : allVals)
+		mcvFreqs.push_back (stod (a));
+
+	allVals.clear ();
+	histogram.clear ();
+	catalog->getStringList (prefix + ".histogram", allVals);
+	for (auto &a : allVals)
+		histogram.push_back (unescape (a));
+
+	return mcvs.size () == mcvFreqs.size ();
+}
+
+void MyDB_ColumnStats :: putInCatalog (string tableName, string attName, MyDB_CatalogPtr catalog) {
+
+	string prefix = tableName + ".stats." + attName;
+	catalog->putString (prefix + ".numVals", to_string (numVals));
+	catalog->putString (prefix + ".numDistinct", to_string (numDistinct));
+	catalog->putString (prefix + ".isNumeric", isNumeric ? "true" : "false");
+	catalog->putString (prefix + ".min", escape (minVal));
+	catalog->putString (prefix + ".max", escape (maxVal));
+
+	vector <string> allVals;
+	for (auto &a : mcvs)
+		allVals.push_back (escape (a));
+	catalog->putStringList (prefix + ".mcvs", allVals);
+
+	allVals.clear ();
+	for (auto &a : mcvFreqs)
+		allVals.push_back (to_string (a));
+	catalog->putStringList (prefix + ".mcvFreqs", allVals);
+
+	allVals.clear ();
+	for (auto &a : histogram)
+		allVals.push_back (escape (a));
+	catalog->putStringList (prefix + ".histogram", allVals);
+}
+
+#endif
@@ -0,0 +1,127 @@
+
+#ifndef HYPER_LOG_LOG_C
+#define HYPER_LOG_LOG_C
+
+#include <cmath>
+#include "MyDB_HyperLogLog.h"
+
+using namespace std;
+
+#define NUM_REGISTERS (1 << HLL_BITS)
+
+// registers are written to the catalog as one printable character each
+#define FIRST_CHAR 'A'
+
+MyDB_HyperLogLog :: MyDB_HyperLogLog () : registers (NUM_REGISTERS, 0) {}
+
+void MyDB_HyperLogLog :: add (size_t hash) {
+
+	// the hashes that we get are often not very random (std :: hash is the identity
+	// on ints), so mix the bits first (this is the MurmurHash3 finalizer)
+	unsigned long long h = hash;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+
+	// the high bits pick the register, and the rank is the position of the first one bit in the rest
+	size_t which = h >> (64 - HLL_BITS);
+	unsigned long long rest = h << HLL_BITS;
+	unsigned char rank = rest == 0 ? 64 - HLL_BITS + 1 : __builtin_clzll (rest) + 1;
+	if (rank > registers[which])
+		registers[which] = rank;
+}
+
+void MyDB_HyperLogLog :: merge (MyDB_HyperLogLog &fromMe) {
+	for (size_t i = 0; i < registers.size (); i++) {
+		if (fromMe.registers[i] > registers[i])
+			registers[i] = fromMe.registers[i];
+	}
+}
+
+// the largest value that a register can hold
+#define MAX_RANK (64 - HLL_BITS + 1)
+
+// these two functions are used by the estimator below to account for the empty and for the
+// saturated registers
+static double sigma (double x) {
+	if (x == 1.0)
+		return INFINITY;
+	double y = 1.0;
+	double z = x;
+	double lastZ;
+	do {
+		x *= x;
+		lastZ = z;
+		z += x * y;
+		y += y;
+	} while (z != lastZ);
+	return z;
+}
+
+static double tau (double x) {
+	if (x == 0.0 || x == 1.0)
+		return 0.0;
+	double y = 1.0;
+	double z = 1.0 - x;
+	double lastZ;
+	do {
+		x = sqrt (x);
+		lastZ = z;
+		y *= 0.5;
+		z -= (1.0 - x) * (1.0 - x) * y;
+	} while (z != lastZ);
+	return z / 3.0;
+}
+
+size_t MyDB_HyperLogLog :: estimate () {
+
+	// get a histogram of the register values
+	vector <size_t> counts (MAX_RANK + 1, 0);
+	for (unsigned char r : registers)
+		counts[r]++;
+
+	// this is Ertl's improved estimator, which (unlike the original HyperLogLog estimator)
+	// is not biased for small and medium cardinalities, so no switch to linear counting
+	// or table of bias corrections is needed
+	double m = registers.size ();
+	double z = m * tau (1.0 - counts[MAX_RANK] / m);
+	for (int k = MAX_RANK - 1; k >= 1; k--) {
+		z += counts[k];
+		z *= 0.5;
+	}
+	z += m * sigma (counts[0] / m);
+
+	// if there is nothing in the sketch, z is infinite
+	double est = m * m / (2.0 * log (2.0) * z);
+	return (size_t) (est + 0.5);
+}
+
+void MyDB_HyperLogLog :: clear () {
+	for (auto &r : registers)
+		r = 0;
+}
+
+string MyDB_HyperLogLog :: toString () {
+	string res (registers.size (), FIRST_CHAR);
+	for (size_t i = 0; i < registers.size (); i++)
+		res[i] = FIRST_CHAR + registers[i];
+	return res;
+}
+
+bool MyDB_HyperLogLog :: fromString (string fromMe) {
+	if (fromMe.size () != registers.size ())
+		return false;
+
+	for (size_t i = 0; i < registers.size (); i++) {
+		if (fromMe[i] < FIRST_CHAR || fromMe[i] > FIRST_CHAR + 64 - HLL_BITS + 1)
+			return false;
+	}
+
+	for (size_t i = 0; i < registers.size (); i++)
+		registers[i] = fromMe[i] - FIRST_CHAR;
+	return true;
+}
+
+#endif
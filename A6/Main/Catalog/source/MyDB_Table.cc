@@ -11,6 +11,10 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn) {
 	fileType = "heap";
 	sortAtt = "none";
 	rootLocation = -1;
+	count = 0;
+	pageFormat = "packed";
+	indexOf = "";
+	zonesOnDisk = false;
 }
 
 MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySchemaIn) {
@@ -21,6 +25,10 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySch
 	fileType = "heap";
 	sortAtt = "none";
 	rootLocation = -1;
+	count = 0;
+	pageFormat = "packed";
+	indexOf = "";
+	zonesOnDisk = false;
 }
 
 MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySchemaIn, string fileTypeIn, string sortAttIn) {
@@ -31,6 +39,10 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySch
 	fileType = fileTypeIn;
 	sortAtt = sortAttIn;
 	rootLocation = -1;
+	count = 0;
+	pageFormat = "packed";
+	indexOf = "";
+	zonesOnDisk = false;
 }
 
 MyDB_Table :: ~MyDB_Table () {}
@@ -42,13 +54,100 @@ string &MyDB_Table :: getName () {
 size_t MyDB_Table :: getDistinctValues (string forMe) {
 	auto res = mySchema->getAttByName (forMe);
 	if (res.first != -1)
-		return allCounts[res.first];
+		return getDistinctValues (res.first);
 	else
 		return -1;
 }
 
 size_t MyDB_Table :: getDistinctValues (int forMe) {
-        return allCounts[forMe];
+
+	// if there is no sketch, all we have is the count that was set
+	if (sketches.size () == 0)
+		return allCounts[forMe];
+
+	// otherwise, use the sketch... but a table from an old catalog may have counts for data
+	// that was loaded before the sketch existed, so never go below those
+	size_t est = sketches[forMe].estimate ();
+	if (forMe < (int) allCounts.size () && allCounts[forMe] > est)
+		return allCounts[forMe];
+	return est;
+}
+
+void MyDB_Table :: checkSketches () {
+	if (sketches.size () != mySchema->getAtts ().size ())
+		sketches.resize (mySchema->getAtts ().size ());
+}
+
+MyDB_HyperLogLog &MyDB_Table :: getSketch (int forMe) {
+	checkSketches ();
+	return sketches[forMe];
+}
+
+void MyDB_Table :: mergeSketches (vector <MyDB_HyperLogLog> &fromMe) {
+	checkSketches ();
+	for (size_t i = 0; i < fromMe.size () && i < sketches.size (); i++)
+		sketches[i].merge (fromMe[i]);
+}
+
+// the selectivities used when nothing is known about an attribute
+#define DEFAULT_EQUALS_SEL 0.1
+#define DEFAULT_RANGE_SEL (1.0 / 3.0)
+#define DEFAULT_BETWEEN_SEL 0.25
+
+void MyDB_Table :: setColumnStats (vector <MyDB_ColumnStats> &toMe) {
+	columnStats = toMe;
+}
+
+bool MyDB_Table :: hasColumnStats () {
+	return columnStats.size () != 0 && columnStats.size () == mySchema->getAtts ().size ();
+}
+
+MyDB_ColumnStats &MyDB_Table :: getColumnStats (int forMe) {
+	return columnStats[forMe];
+}
+
+double MyDB_Table :: getSelectivity (string att, MyDB_CompOp op, string value) {
+
+	auto res = mySchema->getAttByName (att);
+	if (res.first == -1) {
+		cout << "Could not find attribute " << att << " in " << tableName << ".\n";
+		return 1.0;
+	}
+
+	// if we have stats, use them
+	if (hasColumnStats ())
+		return columnStats[res.first].getSelectivity (op, value);
+
+	// otherwise, see if we have a distinct value count
+	if (op == MyDB_CompOp :: Equals || op == MyDB_CompOp :: NotEquals) {
+		double sel = DEFAULT_EQUALS_SEL;
+		if ((sketches.size () != 0 || res.first < (int) allCounts.size ()) && getDistinctValues (res.first) > 0)
+			sel = 1.0 / getDistinctValues (res.first);
+		return op == MyDB_CompOp :: Equals ? sel : 1.0 - sel;
+	}
+	return DEFAULT_RANGE_SEL;
+}
+
+double MyDB_Table :: getRangeSelectivity (string att, string low, string high) {
+
+	auto res = mySchema->getAttByName (att);
+	if (res.first == -1) {
+		cout << "Could not find attribute " << att << " in " << tableName << ".\n";
+		return 1.0;
+	}
+
+	if (hasColumnStats ())
+		return columnStats[res.first].getRangeSelectivity (low, high);
+	return DEFAULT_BETWEEN_SEL;
+}
+
+void MyDB_Table :: clearStats () {
+	allCounts.clear ();
+	columnStats.clear ();
+	checkSketches ();
+	for (auto &s : sketches)
+		s.clear ();
+	count = 0;
 }
 
 void MyDB_Table :: setDistinctValues (vector <size_t> &toMe) {
@@ -75,6 +174,39 @@ string &MyDB_Table :: getFileType () {
 	return fileType;
 }
 
+string &MyDB_Table :: getPageFormat () {
+	return pageFormat;
+}
+
+void MyDB_Table :: setPageFormat (string toMe) {
+	pageFormat = toMe;
+}
+
+string &MyDB_Table :: getIndexOf () {
+	return indexOf;
+}
+
+void MyDB_Table :: setIndexOf (string toMe) {
+	indexOf = toMe;
+}
+
+MyDB_ZoneMapPtr MyDB_Table :: getZoneMap () {
+	if (zoneMap == nullptr && (fileType == "heap" || fileType == "pax")) {
+		zoneMap = make_shared <MyDB_ZoneMap> (mySchema);
+		if (zonesOnDisk)
+			zoneMap->load (storageLoc + ".zones");
+	}
+	return zoneMap;
+}
+
+bool MyDB_Table :: hasPaxPages () {
+	return fileType == "pax";
+}
+
+bool MyDB_Table :: hasSlottedPages () {
+	return pageFormat == "slotted";
+}
+
 string &MyDB_Table :: getSortAtt () {
 	return sortAtt;
 }
@@ -102,7 +234,12 @@ map <string, MyDB_TablePtr> MyDB_Table :: getAllTables (MyDB_CatalogPtr fromMe)
 	return returnVal;
 }
 
-MyDB_Table :: MyDB_Table () {}
+MyDB_Table :: MyDB_Table () {
+	count = 0;
+	pageFormat = "packed";
+	indexOf = "";
+	zonesOnDisk = false;
+}
 
 int MyDB_Table :: lastPage () {
 	return last;
@@ -130,9 +267,17 @@ bool MyDB_Table :: fromCatalog (string tableNameIn, MyDB_CatalogPtr catalog) {
 	// get the type
 	catalog->getString (tableName + ".fileType", fileType);
 
+	// get the page format; tables from an old catalog have packed pages
+	pageFormat = "packed";
+	catalog->getString (tableName + ".pageFormat", pageFormat);
+
 	// get the sort att
 	catalog->getString (tableName + ".sortAtt", sortAtt);
 
+	// and the table that this is an index of, if any
+	indexOf = "";
+	catalog->getString (tableName + ".indexOf", indexOf);
+
 	// get the root
 	catalog->getInt (tableName + ".rootLocation", rootLocation);
 
@@ -143,9 +288,43 @@ bool MyDB_Table :: fromCatalog (string tableNameIn, MyDB_CatalogPtr catalog) {
 	for (auto a : temp)
 		allCounts.push_back (stoull(a));
 
+	// and the sketches that they came from, if there are any
+	sketches.clear ();
+	temp.clear ();
+	catalog->getStringList (tableName + ".sketches", temp);
+	for (auto a : temp) {
+		MyDB_HyperLogLog sketch;
+		if (!sketch.fromString (a)) {
+			sketches.clear ();
+			break;
+		}
+		sketches.push_back (sketch);
+	}
+	if (sketches.size () != mySchema->getAtts ().size ())
+		sketches.clear ();
+
+	// and the stats computed by ANALYZE, if they are still valid
+	columnStats.clear ();
+	string analyzed;
+	catalog->getString (tableName + ".analyzed", analyzed);
+	for (auto &a : mySchema->getAtts ()) {
+		if (analyzed != "true")
+			break;
+		MyDB_ColumnStats stats;
+		if (!stats.fromCatalog (tableName, a.first, catalog)) {
+			columnStats.clear ();
+			break;
+		}
+		columnStats.push_back (stats);
+	}
+
 	// get the number of tuples
 	catalog->getInt (tableName + ".numTuples", count);
 
+	// the zone map is read from its side file when it is first used
+	zoneMap = nullptr;
+	zonesOnDisk = true;
+
 	return true;
 }
 
@@ -173,21 +352,47 @@ void MyDB_Table :: putInCatalog (MyDB_CatalogPtr catalog) {
 	// and the type
 	catalog->putString (tableName + ".fileType", fileType);
 
+	// and the page format
+	catalog->putString (tableName + ".pageFormat", pageFormat);
+
 	// and the root location
 	catalog->putInt (tableName + ".rootLocation", rootLocation);
 
 	// remember the number of distinct attribute vals
 	vector <string> temp;
-	for (auto a : allCounts)
-		temp.push_back (to_string(a));
+	for (size_t i = 0; i < allCounts.size () || i < sketches.size (); i++)
+		temp.push_back (to_string (getDistinctValues ((int) i)));
 	catalog->putStringList (tableName + ".valCounts", temp);
 
+	// and the sketches themselves, so that they can keep being updated
+	temp.clear ();
+	for (auto &a : sketches)
+		temp.push_back (a.toString ());
+	catalog->putStringList (tableName + ".sketches", temp);
+
+	// and the stats computed by ANALYZE
+	catalog->putString (tableName + ".analyzed", hasColumnStats () ? "true" : "false");
+	if (hasColumnStats ()) {
+		int i = 0;
+		for (auto &a : mySchema->getAtts ())
+			columnStats[i++].putInCatalog (tableName, a.first, catalog);
+	}
+
 	// remember the number of tuples
 	catalog->putInt (tableName + ".numTuples", count);
 
+	// the zone map goes into its own file
+	if (zoneMap != nullptr) {
+		zoneMap->save (storageLoc + ".zones");
+		zonesOnDisk = true;
+	}
+
 	// and the sort att
 	catalog->putString (tableName + ".sortAtt", sortAtt);
 
+	// and the table that this is an index of
+	catalog->putString (tableName + ".indexOf", indexOf);
+
 	// remember the last page in the file
         catalog->putInt (tableName + ".lastPage", last);
 
@@ -0,0 +1,266 @@
+
+#ifndef ZONE_MAP_C
+#define ZONE_MAP_C
+
+#include <fstream>
+#include "MyDB_ZoneMap.h"
+#include <stdio.h>
+
+// written at the start of a zone map file
+#define ZONE_FILE_MAGIC 0x5a4f4e45
+
+MyDB_PageZone :: MyDB_PageZone () {
+	known = false;
+}
+
+void MyDB_PageZone :: setEmpty (size_t numAtts) {
+	known = true;
+	seen.assign (numAtts, 0);
+	lowNum.assign (numAtts, 0);
+	highNum.assign (numAtts, 0);
+	lowStr.assign (numAtts, "");
+	highStr.assign (numAtts, "");
+}
+
+void MyDB_PageZone :: setUnknown () {
+	known = false;
+	seen.clear ();
+	lowNum.clear ();
+	highNum.clear ();
+	lowStr.clear ();
+	highStr.clear ();
+}
+
+bool MyDB_PageZone :: isKnown () {
+	return known;
+}
+
+void MyDB_PageZone :: addValue (int whichAtt, double val) {
+	if (!known)
+		return;
+	if (!seen[whichAtt]) {
+		seen[whichAtt] = 1;
+		lowNum[whichAtt] = highNum[whichAtt] = val;
+	} else if (val < lowNum[whichAtt]) {
+		lowNum[whichAtt] = val;
+	} else if (val > highNum[whichAtt]) {
+		highNum[whichAtt] = val;
+	}
+}
+
+void MyDB_PageZone :: addValue (int whichAtt, const string &val) {
+	if (!known)
+		return;
+	if (!seen[whichAtt]) {
+		seen[whichAtt] = 1;
+		lowStr[whichAtt] = highStr[whichAtt] = val;
+	} else if (val < lowStr[whichAtt]) {
+		lowStr[whichAtt] = val;
+	} else if (val > highStr[whichAtt]) {
+		highStr[whichAtt] = val;
+	}
+}
+
+// checks whether some value in [low, high] can satisfy "value op val"
+template <class T>
+static bool rangeMayMatch (const T &low, const T &high, MyDB_CompOp op, const T &val) {
+	switch (op) {
+		case MyDB_CompOp :: Equals: return !(val < low) && !(high < val);
+		case MyDB_CompOp :: NotEquals: return !(low == high && low == val);
+		case MyDB_CompOp :: LessThan: return low < val;
+		case MyDB_CompOp :: LessThanOrEqual: return !(val < low);
+		case MyDB_CompOp :: GreaterThan: return val < high;
+		case MyDB_CompOp :: GreaterThanOrEqual: return !(high < val);
+	}
+	return true;
+}
+
+bool MyDB_PageZone :: mayMatch (int whichAtt, MyDB_CompOp op, double val) {
+
+	// an unknown zone might have anything; a known zone with no value has no records
+	if (!known)
+		return true;
+	if (!seen[whichAtt])
+		return false;
+	return rangeMayMatch (lowNum[whichAtt], highNum[whichAtt], op, val);
+}
+
+bool MyDB_PageZone :: mayMatch (int whichAtt, MyDB_CompOp op, const string &val) {
+	if (!known)
+		return true;
+	if (!seen[whichAtt])
+		return false;
+	return rangeMayMatch (lowStr[whichAtt], highStr[whichAtt], op, val);
+}
+
+MyDB_ZoneMap :: MyDB_ZoneMap (MyDB_SchemaPtr forMe) {
+	for (auto &a : forMe->getAtts ()) {
+		if (a.second->isBool ())
+			kinds.push_back (ZoneNone);
+		else if (a.second->promotableToDouble ())
+			kinds.push_back (ZoneNumeric);
+		else
+			kinds.push_back (ZoneString);
+	}
+}
+
+void MyDB_ZoneMap :: changed () {
+	if (fileName != "") {
+		remove (fileName.c_str ());
+		fileName = "";
+	}
+}
+
+void MyDB_ZoneMap :: clear () {
+	changed ();
+	zones.clear ();
+}
+
+void MyDB_ZoneMap :: resetPage (int whichPage) {
+	changed ();
+	if (whichPage >= (int) zones.size ())
+		zones.resize (whichPage + 1);
+	zones[whichPage].setEmpty (kinds.size ());
+}
+
+void MyDB_ZoneMap :: forgetPage (int whichPage) {
+	changed ();
+	if (whichPage < (int) zones.size ())
+		zones[whichPage].setUnknown ();
+}
+
+void MyDB_ZoneMap :: addRecord (int whichPage, MyDB_RecordPtr addMe) {
+
+	if (whichPage >= (int) zones.size () || !zones[whichPage].known)
+		return;
+
+	changed ();
+	MyDB_PageZone &zone = zones[whichPage];
+	for (size_t i = 0; i < kinds.size (); i++) {
+		if (kinds[i] == ZoneNumeric)
+			zone.addValue (i, addMe->getAtt (i)->toDouble ());
+		else if (kinds[i] == ZoneString)
+			zone.addValue (i, addMe->getAtt (i)->toString ());
+	}
+}
+
+void MyDB_ZoneMap :: setZone (int whichPage, MyDB_PageZone &toMe) {
+	changed ();
+	if (whichPage >= (int) zones.size ())
+		zones.resize (whichPage + 1);
+	zones[whichPage] = toMe;
+}
+
+MyDB_PageZone &MyDB_ZoneMap :: getZone (int whichPage) {
+	if (whichPage >= (int) zones.size ())
+		return unknown;
+	return zones[whichPage];
+}
+
+MyDB_ZoneKind MyDB_ZoneMap :: getKind (int whichAtt) {
+	return kinds[whichAtt];
+}
+
+vector <MyDB_ZoneKind> &MyDB_ZoneMap :: getKinds () {
+	return kinds;
+}
+
+static void writeString (ofstream &out, const string &writeMe) {
+	size_t len = writeMe.size ();
+	out.write ((char *) &len, sizeof (len));
+	out.write (writeMe.data (), len);
+}
+
+static bool readString (ifstream &in, string &readMe) {
+	size_t len;
+	if (!in.read ((char *) &len, sizeof (len)) || len > (1 << 20))
+		return false;
+	readMe.resize (len);
+	return (bool) in.read (&readMe[0], len);
+}
+
+bool MyDB_ZoneMap :: save (string toMe) {
+
+	changed ();
+	ofstream out (toMe, ios :: binary | ios :: trunc);
+	if (!out.is_open ())
+		return false;
+
+	// the header is the magic number, the number of attributes, and the number of pages
+	unsigned int magic = ZONE_FILE_MAGIC;
+	size_t numAtts = kinds.size (), numPages = zones.size ();
+	out.write ((char *) &magic, sizeof (magic));
+	out.write ((char *) &numAtts, sizeof (numAtts));
+	out.write ((char *) &numPages, sizeof (numPages));
+
+	// then each zone
+	for (auto &z : zones) {
+		char known = z.known;
+		out.write (&known, 1);
+		if (!known)
+			continue;
+		out.write (z.seen.data (), numAtts);
+		for (size_t i = 0; i < numAtts; i++) {
+			if (!z.seen[i])
+				continue;
+			if (kinds[i] == ZoneNumeric) {
+				out.write ((char *) &z.lowNum[i], sizeof (double));
+				out.write ((char *) &z.highNum[i], sizeof (double));
+			} else if (kinds[i] == ZoneString) {
+				writeString (out, z.lowStr[i]);
+				writeString (out, z.highStr[i]);
+			}
+		}
+	}
+
+	out.close ();
+	if (!out)
+		return false;
+	fileName = toMe;
+	return true;
+}
+
+bool MyDB_ZoneMap :: load (string fromMe) {
+
+	clear ();
+	ifstream in (fromMe, ios :: binary);
+	if (!in.is_open ())
+		return false;
+
+	unsigned int magic;
+	size_t numAtts, numPages;
+	if (!in.read ((char *) &magic, sizeof (magic)) || magic != ZONE_FILE_MAGIC ||
+		!in.read ((char *) &numAtts, sizeof (numAtts)) || numAtts != kinds.size () ||
+		!in.read ((char *) &numPages, sizeof (numPages)))
+		return false;
+
+	vector <MyDB_PageZone> temp (numPages);
+	for (auto &z : temp) {
+		char known;
+		if (!in.read (&known, 1))
+			return false;
+		if (!known)
+			continue;
+		z.setEmpty (numAtts);
+		if (!in.read (z.seen.data (), numAtts))
+			return false;
+		for (size_t i = 0; i < numAtts; i++) {
+			if (!z.seen[i])
+				continue;
+			if (kinds[i] == ZoneNumeric) {
+				if (!in.read ((char *) &z.lowNum[i], sizeof (double)) ||
+					!in.read ((char *) &z.highNum[i], sizeof (double)))
+					return false;
+			} else if (kinds[i] == ZoneString) {
+				if (!readString (in, z.lowStr[i]) || !readString (in, z.highStr[i]))
+					return false;
+			}
+		}
+	}
+
+	zones.swap (temp);
+	fileName = fromMe;
+	return true;
+}
+
+#endif
@@ -4,6 +4,7 @@
 
 #include <fstream>
 #include <queue>
+#include "MyDB_KeyNormalizer.h"
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_TableRecIterator.h"
 #include "MyDB_TableRecIteratorAlt.h"
@@ -42,4 +43,37 @@ private:
 	MyDB_RecordPtr rhs;
 };
 
+// a record iterator, along with the normalized key of its current record
+struct MyDB_KeyedIterator {
+	MyDB_NormalizedKey key;
+	MyDB_RecordIteratorAltPtr iter;
+};
+
+// used as a comparator for keyed record iterators; the current records are only loaded
+// up and compared if the keys do not decide the comparison
+class KeyedIteratorComparator {
+
+public:
+
+	KeyedIteratorComparator (MyDB_KeyNormalizerPtr keysIn) {
+		keys = keysIn;
+	}
+
+	KeyedIteratorComparator () {}
+
+	bool operator() (const MyDB_KeyedIterator &leftIter, const MyDB_KeyedIterator &rightIter) const {
+
+		// the priority queue puts the largest item on top, so we return true if right < left
+		bool isLess;
+		if (MyDB_KeyNormalizer :: keysDecide (rightIter.key, leftIter.key, isLess))
+			return isLess;
+		rightIter.iter->getCurrent (keys->getLHS ());
+		leftIter.iter->getCurrent (keys->getRHS ());
+		return keys->compare ();
+	}
+
+private:
+	MyDB_KeyNormalizerPtr keys;
+};
+
 #endif
@@ -0,0 +1,85 @@
+
+#ifndef BPLUS_RANGE_ITER_ALT_H
+#define BPLUS_RANGE_ITER_ALT_H
+
+#include "MyDB_RecordIteratorAlt.h"
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_Record.h"
+#include "MyDB_TableReaderWriter.h"
+#include <functional>
+
+using namespace std;
+
+// iterates through the records of a B+-Tree in key order, starting at the given slot of the given
+// leaf and following the link from each leaf to the next one (see MyDB_SlottedPage.h).  Only one
+// leaf is looked at at a time, and the iteration stops at the first record whose key is past the
+// high end of the range, so nothing is collected up front and no page past the range is read
+class MyDB_BPlusRangeIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+        // load the current record into the parameter
+        void getCurrent (MyDB_RecordPtr intoMe) override {
+		intoMe->fromBinary (curPos);
+	}
+
+        // after a call to advance (), a call to getCurrentPointer () will get the address
+        // of the record.  At a later time, it is then possible to reconstitute the record
+        // by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page that
+        // the record is located on has not been swapped out
+        void *getCurrentPointer () override {
+		return curPos;
+	}
+
+        // advance to the next record... returns true if there is a next record, and
+        // false if there are no more records to iterate over
+        bool advance () override {
+		while (!done) {
+
+			// see if there is another record on this leaf
+			curPos = curPage.getRecordPointer (curSlot);
+			if (curPos != nullptr) {
+				curSlot++;
+				myRec->fromBinary (curPos);
+				if (highComparator ())
+					break;
+				return true;
+			}
+
+			// if not, go on to the next leaf
+			int nextPage = curPage.getNextPage ();
+			if (nextPage == -1)
+				break;
+			curPage = myParent[nextPage];
+			curSlot = 0;
+		}
+		done = true;
+		return false;
+	}
+
+	// myRec is a record for the tree, and highComparator returns true if the key of myRec is
+	// past the high end of the range
+	MyDB_BPlusRangeIteratorAlt (MyDB_TableReaderWriter &myParentIn, int firstPage, size_t firstSlot,
+		MyDB_RecordPtr myRecIn, function <bool ()> highComparatorIn) :
+		myParent (myParentIn), curPage (myParentIn[firstPage]) {
+		curSlot = firstSlot;
+		myRec = myRecIn;
+		highComparator = highComparatorIn;
+		curPos = nullptr;
+		done = false;
+	}
+
+	~MyDB_BPlusRangeIteratorAlt () {}
+
+private:
+
+	MyDB_TableReaderWriter &myParent;
+	MyDB_PageReaderWriter curPage;
+	size_t curSlot;
+	void *curPos;
+	bool done;
+	MyDB_RecordPtr myRec;
+	function <bool ()> highComparator;
+};
+
+#endif
@@ -14,6 +14,12 @@
 #include "MyDB_Table.h"
 #include "MyDB_TableReaderWriter.h"
 
+// the fraction of each page that is filled when a tree is bulk loaded from a text file
+#define BPLUS_DEFAULT_FILL_FACTOR 0.9
+
+// the fraction of the lower page that is filled when a page at the right edge of a tree splits
+#define BPLUS_DEFAULT_SPLIT_FILL_FACTOR 1.0
+
 // create a smart pointer for the catalog
 using namespace std;
 class MyDB_PageReaderWriter;
@@ -29,36 +35,151 @@ public:
 
         // gets an instance of an alternate iterator over the table... this is an
         // iterator that has the alternate getCurrent ()/advance () interface
-	// return all records with a key value in the range [low, high], inclusive
+	// return all records with a key value in the range [low, high], inclusive.  The leaves are
+	// kept sorted, so this is the same as getSortedRangeIteratorAlt
         MyDB_RecordIteratorAltPtr getRangeIteratorAlt (MyDB_AttValPtr low, MyDB_AttValPtr high);
 	
         // gets an instance of an alternate iterator over the table... this is an
         // iterator that has the alternate getCurrent ()/advance () interface... returned records must be sorted
-	// return all records with a key value in the range [low, high], inclusive
+	// return all records with a key value in the range [low, high], inclusive.  The iterator starts
+	// at the first record in the range, and streams through the linked leaves from there, stopping
+	// as soon as it sees a key past high (see MyDB_BPlusRangeIteratorAlt.h)
         MyDB_RecordIteratorAltPtr getSortedRangeIteratorAlt (MyDB_AttValPtr low, MyDB_AttValPtr high);
 	
+	// finds every record whose key is equal to key, and loads them, in order, into matches.  The
+	// records already in matches are reused, and new ones are only added to the end of the vector
+	// when it runs out, so looking up keys over and over with the same vector does not allocate.
+	// Returns the number of matches; any records in matches past that are left over from before.
+	// This is one binary-searched descent of the tree, after which the leaves are only read as
+	// far as the key goes
+	size_t lookup (MyDB_AttValPtr key, vector <MyDB_RecordPtr> &matches);
+
+	// looks up a batch of keys: each record whose key is equal to keys[i] is loaded into intoMe,
+	// and then onMatch (i) is called.  The keys do not have to be sorted; they are probed in key
+	// order (so that is the order of the calls), and each probe starts from the path down to the
+	// leaf found by the last one, going back up the tree only as far as it has to
+	void lookup (vector <MyDB_AttValPtr> &keys, MyDB_RecordPtr intoMe, function <void (size_t)> onMatch);
+
 	// append a record to the B+-Tree
 	void append (MyDB_RecordPtr appendMe);
 
+	// when a page splits, it is split at the median, except when the new record goes at the right
+	// edge of the tree (after every key in it), as it does when the keys are appended in increasing
+	// order.  Then, the lower page is filled to fillFactor of a page (by default,
+	// BPLUS_DEFAULT_SPLIT_FILL_FACTOR), so that the pages that are left behind are not half empty
+	void setSplitFillFactor (double fillFactor);
+
+	// replaces the contents of the tree with the records in fromMe, which must have the same
+	// schema (it may even be this file).  Rather than appending the records one at a time, the
+	// input is sorted on the key (see Sorting.h), and the tree is then built bottom-up: the
+	// leaves are written in key order, each filled to fillFactor of a page, and then each level
+	// of directory pages is built over the one below it, until there is a single root.  The
+	// statistics are rebuilt, and the return value is the same as for loadFromTextFile
+	pair <vector <size_t>, size_t> bulkLoad (MyDB_TableReaderWriter &fromMe, double fillFactor);
+
+	// the parallel bulk loader first writes the records into the file as plain pages, and then
+	// the tree is built over them using bulkLoad, with a fill factor of BPLUS_DEFAULT_FILL_FACTOR
+	pair <vector <size_t>, size_t> bulkLoadFromTextFile (string fromMe, int numThreads) override;
+
 	// print the contents of the tree to the screen
 	void printTree ();
 
 private:
 
-	// gets a list of pages that might have data for an iterator... any leaf page that can possibly
-	// have a value in the range [low, high], inclusive should be returned from this call
-	bool discoverPages (int whichPage, vector <MyDB_PageReaderWriter> &list,
-        	MyDB_AttValPtr low, MyDB_AttValPtr high);
+	// finds the first record in the tree with a key that is at least the key of lowRec: whichPage is
+	// set to its leaf, and whichSlot to its slot on the leaf.  The slot may be one past the last
+	// record on the leaf, in which case the record is the first one on the next leaf
+	void findFirst (MyDB_INRecordPtr lowRec, int &whichPage, size_t &whichSlot);
 
-	// appends a record to the named page; if there is a split, then an MyDB_INRecordPtr is returned that
-	// points to the record holding the (key, ptr) pair pointing to the new page.  Note that the new page
-	// always holds the lower 1/2 of the records on the page; the upper 1/2 remains in the original page
-	MyDB_RecordPtr append (int whichPage, MyDB_RecordPtr appendMe);
+	// builds the records and comparisons used by lookup, if they have not been built yet
+	void setUpLookups ();
 
-	// splits the given page (plus the record andMe) around the median.  A MyDB_INRecordPtr is returned that
+	// finds the first record with a key that is at least the key of searchRec, like findFirst.  path
+	// holds the directory pages from the root down to the leaf, each with the slot of the entry that
+	// was followed.  If it is not empty on the way in, it must be the path found for a key that is no
+	// larger, and the search starts from the lowest entry on it whose key is at least searchRec's
+	void seek (vector <pair <int, size_t>> &path, int &whichPage, size_t &whichSlot);
+
+	// goes through the records from the given slot on, as long as the key is equal to the key of
+	// searchRec, and calls onMatch with the location of each one
+	void readMatches (int whichPage, size_t whichSlot, function <void (void *)> onMatch);
+
+	// appends a record to the named page; if there is a split, then an MyDB_INRecordPtr is returned that
 	// points to the record holding the (key, ptr) pair pointing to the new page.  Note that the new page
-	// always holds the lower 1/2 of the records on the page; the upper 1/2 remains in the original page
-	MyDB_RecordPtr split (MyDB_PageReaderWriter splitMe, MyDB_RecordPtr andMe);
+	// always holds the lower records on the page, up to the split point (see split); the rest remain in
+	// the original page.  Every page is kept sorted: a new record goes after any records with the same key, and a new
+	// directory entry goes right before the entry for the page that split.  lowFence and highFence
+	// are the keys of the directory entries on either side of the page (nullptr at the edges of the
+	// tree); every key under the page is between them
+	MyDB_RecordPtr append (int whichPage, MyDB_RecordPtr appendMe, MyDB_AttValPtr lowFence,
+		MyDB_AttValPtr highFence);
+
+	// splits the named page (plus the record andMe, which goes in at the whichSlot^th position) at the
+	// point chosen by getSplitPoint: the median, or further right when the new record is at the right
+	// edge of the tree (see setSplitFillFactor).  A MyDB_INRecordPtr is returned that points to the
+	// record holding the (key, ptr) pair pointing to the new page.  Note that the new page always holds
+	// the records up to the split point; the rest remain in the original page.  If the page is a leaf, the new page is linked
+	// in before it, and the key is the shortest separator between the two halves (see getSeparator).
+	// If it is a directory page, the fences of the page are used to compute the prefixes of the halves
+	MyDB_RecordPtr split (int whichPage, MyDB_RecordPtr andMe, size_t whichSlot, MyDB_AttValPtr lowFence,
+		MyDB_AttValPtr highFence);
+
+	// given the space taken by each of the records (including the new one) on a page that is
+	// splitting, and the space that a page has for them, returns the position of the last one that
+	// goes into the lower page: the median, unless the new record is at the right edge of the tree,
+	// in which case the lower page is filled to splitFillFactor
+	size_t getSplitPoint (vector <size_t> &sizes, size_t capacity, bool atRightEdge);
+
+	// writes the given IN records into consecutive directory pages of the file, starting at the page
+	// after lastPageWritten, filling each page up to fillFactor of the page, but with at least two
+	// records on a page.  For each page, a (key, ptr) pair pointing to it is added to parents; its
+	// key is the key of the last record on the page.  Used by bulkLoad to build each level of
+	// directory pages
+	void writeLevel (vector <MyDB_INRecordPtr> &records, double fillFactor, int &lastPageWritten,
+		vector <MyDB_INRecordPtr> &parents);
+
+	// binary searches a directory page for the first entry for which isPast returns true, where
+	// isPast looks at the entry loaded into entryRec; isPast must be false for some prefix of the
+	// entries, and true for the rest.  Returns the number of entries if isPast is never true.
+	// Directory pages are slotted, so each probe only has to load a single entry
+	size_t findEntry (MyDB_PageReaderWriter &page, string &prefix, MyDB_INRecordPtr entryRec, function <bool ()> isPast);
+
+	// the same, but for a leaf: only the key of each record that is probed is loaded, into keyRec
+	size_t findKey (MyDB_PageReaderWriter &page, MyDB_INRecordPtr keyRec, function <bool ()> isPast);
+
+	// when the keys are strings, the directory pages are prefix compressed: the first record on each
+	// page holds a prefix that every key under the page starts with (the longest common prefix of the
+	// page's fences), and each of the other records holds the rest of the key of one entry.  These
+	// hide that: they get the number of entries on a directory page, get the prefix of a page
+	// (which is empty if the keys are not strings), load the whichEntry^th entry (with its whole
+	// key) into intoMe, given the page's prefix, and insert an entry with a whole key into a page
+	size_t getNumEntries (MyDB_PageReaderWriter &page);
+	string getPrefix (MyDB_PageReaderWriter &page);
+	void getEntry (MyDB_PageReaderWriter &page, size_t whichEntry, string &prefix, MyDB_INRecordPtr intoMe);
+	bool insertEntry (MyDB_PageReaderWriter &page, size_t whichEntry, MyDB_RecordPtr insertMe);
+
+	// the space on a directory page taken by the record holding an empty prefix, along with its
+	// slot (zero if the keys are not strings)
+	size_t getPrefixOverhead ();
+
+	// formats page as a directory page holding entries [from, to) of the given entries, which have
+	// whole keys, with the given prefix (which is ignored if the keys are not strings)
+	void writeDirectory (MyDB_PageReaderWriter &page, vector <MyDB_INRecordPtr> &entries, size_t from, size_t to,
+		string prefix);
+
+	// the prefix of a directory page with the given fences; this is empty if the keys are not
+	// strings, or if either fence is nullptr
+	string getPrefix (MyDB_AttValPtr lowFence, MyDB_AttValPtr highFence);
+
+	// the key of the directory entry that separates a page whose last key is low from one whose
+	// first key is high.  If the keys are strings, this is the shortest prefix of high that is
+	// larger than low (so that only as much of the key as is needed goes up into the directory);
+	// otherwise, it is low
+	MyDB_AttValPtr getSeparator (MyDB_AttValPtr low, MyDB_AttValPtr high);
+
+	// points the key of intoMe at the key of the data record stored at pos, without loading the
+	// rest of the record
+	void loadKey (void *pos, MyDB_INRecordPtr intoMe);
 
 	// constructs and returns an empty internal node record for this particular tree
 	MyDB_INRecordPtr getINRecord ();
@@ -83,6 +204,22 @@ private:
 	// the number of the attribute that we are ordering on, in the data records
 	int whichAttIsOrdering;
 
+	// true if the keys are strings, so that the directory pages are prefix compressed
+	bool compressesKeys;
+
+	// used to read and write the prefixes of directory pages
+	MyDB_INRecordPtr prefixRec;
+
+	// how full the lower page is left when a page at the right edge of the tree splits
+	double splitFillFactor;
+
+	// used by lookup: the key being looked for, the directory entry (or leaf key) that is being
+	// looked at, and the comparisons between them
+	MyDB_INRecordPtr searchRec;
+	MyDB_INRecordPtr entryRec;
+	function <bool ()> entryBeforeSearch;
+	function <bool ()> searchBeforeEntry;
+
 };
 
 #endif
@@ -0,0 +1,77 @@
+
+#ifndef BULK_LOADER_H
+#define BULK_LOADER_H
+
+#include "MyDB_HyperLogLog.h"
+#include "MyDB_Schema.h"
+#include "MyDB_TableReaderWriter.h"
+#include "MyDB_ZoneMap.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// This class implements a parallel bulk loader for text (.tbl) files.  The input file is
+// memory-mapped and cut into chunks at line boundaries.  Worker threads then parse the
+// chunks, writing each record directly in its binary form into private page images (no
+// MyDB_Record or std::string is used on the parsing path).  Once a batch of chunks has
+// been parsed, the page images are copied into the table, in file order, so that the
+// resulting table has exactly the same record order as one created by loadFromTextFile.
+//
+// Each thread keeps its own distinct value sketches, which are merged into the table's
+// sketches at the end, and the zone (see MyDB_ZoneMap.h) of each page is computed as the
+// page is built.  Note that the last page built from each chunk is generally not
+// full; with the default chunk size this costs well under one percent of extra pages.
+//
+class MyDB_BulkLoader {
+
+public:
+
+	// create a loader that parses records with the given schema into pages of the given
+	// size, using numThreads worker threads
+	MyDB_BulkLoader (MyDB_SchemaPtr mySchema, size_t pageSize, int numThreads);
+
+	// load the text file into the (already emptied) table... returns a pair where the
+	// first entry is a list of (approximate) distinct value counts for each of the attributes
+	// in the table, and the second entry is the number of tuples that have been loaded
+	pair <vector <size_t>, size_t> load (string fromMe, MyDB_TableReaderWriter &intoMe);
+
+	// the number of bytes of the text file that were processed by the last call to load
+	size_t getBytesLoaded ();
+
+private:
+
+	// one unit of parallel work: a range of lines from the input, and the pages built from
+	// them, along with the zone of each page
+	struct Chunk {
+		const char *start;
+		const char *end;
+		vector <void *> pages;
+		vector <MyDB_PageZone> zones;
+		size_t numRecs;
+	};
+
+	// parse all of the lines in the chunk into page images; the sketches are updated as we go
+	void parseChunk (Chunk &parseMe, vector <MyDB_HyperLogLog> &sketches);
+
+	// serialize the line [start, end) into the binary record format, at the location recLoc;
+	// returns the number of bytes written, or 0 if the record did not fit in maxBytes.  The
+	// values are added to the sketches and to the zone of the page
+	size_t parseLine (const char *start, const char *end, char *recLoc, size_t maxBytes,
+		vector <MyDB_HyperLogLog> &sketches, MyDB_PageZone &zone);
+
+	// the types of all of the attributes (in order) in the schema
+	vector <MyDB_AttTypePtr> attTypes;
+
+	// the page size
+	size_t pageSize;
+
+	// the number of worker threads
+	int numThreads;
+
+	// number of bytes in the last file loaded
+	size_t bytesLoaded;
+};
+
+#endif
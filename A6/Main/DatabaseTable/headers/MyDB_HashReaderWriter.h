@@ -0,0 +1,90 @@
+
+#ifndef HASH_RW_H
+#define HASH_RW_H
+
+#include <memory>
+#include "MyDB_BufferManager.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIteratorAlt.h"
+#include "MyDB_Table.h"
+#include "MyDB_TableReaderWriter.h"
+
+// the number of buckets in an empty hash file
+#define HASH_INITIAL_BUCKETS 4
+
+// the most times that the number of buckets can double
+#define HASH_MAX_DOUBLINGS 32
+
+// create a smart pointer for the hash file
+using namespace std;
+class MyDB_PageReaderWriter;
+class MyDB_HashReaderWriter;
+typedef shared_ptr <MyDB_HashReaderWriter> MyDB_HashReaderWriterPtr;
+
+// a file of type "hash", which is organized using linear hashing on one of its attributes.  Each
+// bucket is a chain of linked pages (see MyDB_SlottedPage.h); a record goes into the bucket given
+// by the hash of its key, and when an append has to add an overflow page to a bucket, the bucket
+// at the split pointer is split in two, so the file grows one bucket at a time.  The buckets are
+// allocated a doubling at a time, so the first page of a bucket can be computed from the first
+// page of its doubling; these are kept, along with the level and the split pointer, in the
+// header at page zero.  The header is a directory page, so a scan of the file skips it
+class MyDB_HashReaderWriter : public MyDB_TableReaderWriter {
+
+public:
+
+	// create a hash file on the given attribute
+	MyDB_HashReaderWriter (string nameOfAttToHashOn, MyDB_TablePtr forMe, MyDB_BufferManagerPtr myBuffer);
+
+	// finds every record whose key is equal to key, and loads them into matches; as with the
+	// lookup of a B+-Tree, the records already in matches are reused, and new ones are only added
+	// to the end of the vector when it runs out.  Returns the number of matches.  Only the pages
+	// of one bucket are read
+	size_t lookup (MyDB_AttValPtr key, vector <MyDB_RecordPtr> &matches);
+
+	// append a record to the file, splitting a bucket if the record's bucket overflows
+	void append (MyDB_RecordPtr appendMe) override;
+
+	// the records have to be hashed into their buckets, so this is the same as loadFromTextFile
+	pair <vector <size_t>, size_t> bulkLoadFromTextFile (string fromMe, int numThreads) override;
+
+	// the number of buckets in the file
+	size_t getNumBuckets ();
+
+private:
+
+	// sets up an empty file, with HASH_INITIAL_BUCKETS empty buckets
+	void initialize ();
+
+	// reads and writes the header
+	void readHeader ();
+	void writeHeader ();
+
+	// the bucket that a record with the given key goes into
+	size_t getBucket (MyDB_AttValPtr key);
+
+	// the first page of the given bucket
+	int getBucketPage (size_t whichBucket);
+
+	// appends the record to the first page in the bucket's chain that it fits on; returns false
+	// if there was no room, so that an overflow page had to be added to the end of the chain
+	bool appendToBucket (size_t whichBucket, MyDB_RecordPtr appendMe);
+
+	// splits the bucket at the split pointer, and then advances the pointer
+	void split ();
+
+	// the number of the attribute that we are hashing on
+	int whichAttIsHashed;
+
+	// the number of times that the number of buckets has doubled, and the next bucket to split;
+	// the buckets numbered less than next have been split in this round
+	size_t level;
+	size_t next;
+
+	// the first page of each doubling of buckets
+	vector <int> firstPages;
+
+	// the record that is used to read and write the header
+	MyDB_RecordPtr header;
+};
+
+#endif
@@ -0,0 +1,89 @@
+
+#ifndef INDEX_FETCH_ITER_ALT_H
+#define INDEX_FETCH_ITER_ALT_H
+
+#include "MyDB_RecordIteratorAlt.h"
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_Record.h"
+#include "MyDB_TableReaderWriter.h"
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// iterates through the records of a table at a list of (page, slot) locations, which must be
+// sorted; this is used to fetch the records found in a secondary index (see MyDB_SecondaryIndex.h).
+// Since the locations are sorted, each page is only read once: the page's own iterator is walked
+// forward to each of the slots on it in turn, so any format of page works, and the page is only
+// gone through one time, no matter how many of its records are fetched
+class MyDB_IndexFetchIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+        // load the current record into the parameter
+        void getCurrent (MyDB_RecordPtr intoMe) override {
+		pageIter->getCurrent (intoMe);
+	}
+
+        // after a call to advance (), a call to getCurrentPointer () will get the address
+        // of the record.  At a later time, it is then possible to reconstitute the record
+        // by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page that
+        // the record is located on has not been swapped out
+        void *getCurrentPointer () override {
+		return pageIter->getCurrentPointer ();
+	}
+
+        // advance to the next record... returns true if there is a next record, and
+        // false if there are no more records to iterate over
+        bool advance () override {
+		if (next == locations.size ())
+			return false;
+
+		// go to the page the record is on, if we are not there already
+		if (locations[next].first != curPageNum) {
+			curPageNum = locations[next].first;
+			pageIter = myParent[curPageNum].getIteratorAlt ();
+			numAdvanced = 0;
+		}
+
+		// and move the page's iterator up to the record; an iterator over a packed page only
+		// finds the next record by loading the one it is at, so each one is loaded into skipRec
+		while (numAdvanced <= locations[next].second) {
+			if (numAdvanced > 0)
+				pageIter->getCurrent (skipRec);
+			if (!pageIter->advance ())
+				return false;
+			numAdvanced++;
+		}
+		next++;
+		return true;
+	}
+
+	MyDB_IndexFetchIteratorAlt (MyDB_TableReaderWriter &myParentIn, vector <pair <int, size_t>> &locationsIn) :
+		myParent (myParentIn) {
+		locations.swap (locationsIn);
+		skipRec = myParent.getEmptyRecord ();
+		next = 0;
+		curPageNum = -1;
+		numAdvanced = 0;
+	}
+
+	~MyDB_IndexFetchIteratorAlt () {}
+
+private:
+
+	MyDB_TableReaderWriter &myParent;
+	vector <pair <int, size_t>> locations;
+	size_t next;
+
+	// the page of the current record, an iterator over that page that is at the record, and
+	// the number of times that the iterator has been advanced (one more than the record's slot)
+	int curPageNum;
+	MyDB_RecordIteratorAltPtr pageIter;
+	size_t numAdvanced;
+
+	// used to step over the records on a page that are not fetched
+	MyDB_RecordPtr skipRec;
+};
+
+#endif
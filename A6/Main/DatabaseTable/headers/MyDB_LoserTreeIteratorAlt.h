@@ -0,0 +1,70 @@
+
+#ifndef LOSER_TREE_ITER_ALT_H
+#define LOSER_TREE_ITER_ALT_H
+
+#include "IteratorComparator.h"
+#include "MyDB_KeyNormalizer.h"
+#include "MyDB_RecordIteratorAlt.h"
+#include "MyDB_Record.h"
+#include <vector>
+
+using namespace std;
+class MyDB_LoserTreeIteratorAlt;
+typedef shared_ptr <MyDB_LoserTreeIteratorAlt> MyDB_LoserTreeIteratorAltPtr;
+
+// This iterator merges a set of sorted runs using a tournament tree of losers.  Each run sits
+// at a leaf of the tree, along with the normalized key of its current record, and each inner
+// node remembers the run that lost the match played there.  When the winning run is advanced,
+// only the matches on the path from its leaf to the root are re-played, so getting the next
+// record takes about log2 (number of runs) comparisons, most of which are decided by memcmp on
+// the cached keys.  It is used just like a MyDB_RunQueueIteratorAlt
+class MyDB_LoserTreeIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+        // load the current record into the parameter
+        void getCurrent (MyDB_RecordPtr intoMe) override;
+
+        // after a call to advance (), a call to getCurrentPointer () will get the address
+        // of the record.  At a later time, it is then possible to reconstitute the record
+        // by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page that
+        // the record is located on has not been swapped out
+        void *getCurrentPointer () override;
+
+        // advance to the next record... returns true if there is a next record, and
+        // false if there are no more records to iterate over.  Not that this cannot
+        // be called until after getCurrent () has been called
+        bool advance () override;
+
+	// build an iterator that orders the runs using their normalized keys
+	MyDB_LoserTreeIteratorAlt (MyDB_KeyNormalizerPtr keys);
+
+	// add a run to the tree, for building it up; advance () must already have been
+	// called on the run (and returned true).  Runs cannot be added after the first advance ()
+	void addRun (MyDB_RecordIteratorAltPtr addMe);
+
+	~MyDB_LoserTreeIteratorAlt ();
+
+private:
+
+	// returns true if the current record of run lhs comes before that of run rhs; a run
+	// that is used up comes after everything
+	bool isLess (size_t lhs, size_t rhs);
+
+	// plays all of the matches below the given node, and returns the winner
+	size_t play (size_t whichNode);
+
+	// the runs, each with the key of its current record, and whether it has been used up
+	vector <MyDB_KeyedIterator> runs;
+	vector <char> done;
+
+	// losers[i] is the run that lost at inner node i (node 1 is the root, and the leaves
+	// are nodes runs.size () through 2 * runs.size () - 1)
+	vector <size_t> losers;
+	size_t winner;
+
+	MyDB_KeyNormalizerPtr keys;
+	bool firstTime;
+};
+
+#endif
@@ -43,11 +43,19 @@ public:
 	MyDB_PageListIteratorAlt (vector <MyDB_PageReaderWriter> &forUs);
 	~MyDB_PageListIteratorAlt ();
 
+	// like the above, except that the pages are brought into the buffer readAhead at a time, so
+	// that when many lists are being read at once, each one is read in sequential chunks
+	MyDB_PageListIteratorAlt (vector <MyDB_PageReaderWriter> &forUs, int readAhead);
+
 private:
 
+	// brings in the next readAhead pages, if curPage is at the start of a chunk
+	void readChunk ();
+
 	MyDB_RecordIteratorAltPtr myIter;
 	vector <MyDB_PageReaderWriter> forUs;
 	int curPage;
+	int readAhead;
 };
 
 #endif
@@ -14,6 +14,7 @@
 #define PAGE_RW_H
 
 #include <memory>
+#include "MyDB_KeyNormalizer.h"
 #include "MyDB_PageType.h"
 #include "MyDB_RecordIterator.h"
 #include "MyDB_RecordIteratorAlt.h"
@@ -39,10 +40,54 @@ public:
 	// constructor for an anonymous page that can be pinned, if desired
 	MyDB_PageReaderWriter (bool pinned, MyDB_BufferManager &parent);
 
+	// unpins a page that was pinned when it was made, so that it can be written out of the buffer.
+	// Its bytes may have been written directly (through getBytes ()), so it is marked as written
+	void unpin ();
+
 	// empties out the contents of this page, so that it has no records in it
-	// the type of the page is set to MyDB_PageType :: RegularPage
+	// the type of the page is set to MyDB_PageType :: RegularPage.  If this is a page
+	// from a table with slotted pages, the page is formatted as a slotted page (see
+	// MyDB_SlottedPage.h), and if it is from a file of type "pax", it is formatted as a PAX
+	// page (see MyDB_PaxPage.h); otherwise, it is a packed page
 	void clear ();	
 
+	// like clear (), except that the page is always formatted as a slotted page, whatever the
+	// format of the other pages in the file is; the directory pages of a B+-Tree are slotted,
+	// so that they can be binary searched
+	void clearAsSlotted ();
+
+	// like clearAsSlotted (), except that the page is linked to the pages before and after it
+	// in the file (see MyDB_SlottedPage.h); both links start out as -1.  The leaves of a B+-Tree
+	// are linked, so that they can be scanned in key order
+	void clearAsLinked ();
+
+	// get/set the links of a page that was formatted by clearAsLinked ()
+	int getPrevPage ();
+	int getNextPage ();
+	void setPrevPage (int toMe);
+	void setNextPage (int toMe);
+
+	// returns true if this is a slotted page (linked pages are slotted too)
+	bool isSlotted ();
+
+	// returns true if this page was formatted by clearAsLinked ()
+	bool isLinked ();
+
+	// returns true if this is a PAX page
+	bool isPax ();
+
+	// returns the number of records on the page
+	size_t getNumRecords ();
+
+	// loads the record in the given slot (the whichSlot^th record on the page, counting from
+	// zero) into intoMe; returns false if there is no such record.  This takes constant time
+	// on a slotted page; on a packed page, all of the earlier records must be skipped over
+	bool getRecord (size_t whichSlot, MyDB_RecordPtr intoMe);
+
+	// like the above, but returns the location of the record on the page (or nullptr); the
+	// records on a PAX page are not stored in the binary record format, and have no location
+	void *getRecordPointer (size_t whichSlot);
+
 	// return an itrator over this page... each time returnVal->next () is
 	// called, the resulting record will be placed into the record pointed to
 	// by iterateIntoMe
@@ -52,16 +97,29 @@ public:
 	// iterator that has the alternate getCurrent ()/advance () interface
 	MyDB_RecordIteratorAltPtr getIteratorAlt ();
 
+	// on a PAX page, this gets an alternate iterator that only loads the listed attributes
+	// (all of them if the list is empty) and only returns the records that pass the filter's
+	// comparisons (see MyDB_PaxPageRecIteratorAlt.h); on any other page, the filter and the
+	// list are ignored, and this is just getIteratorAlt ()
+	MyDB_RecordIteratorAltPtr getIteratorAlt (MyDB_ZoneFilterPtr filter, vector <int> &whichAtts);
+
 	// gets an instance of an alternatie iterator over a list of pages
 	friend MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs);
 
 	// appends a record to this page... return false is the append fails because
-	// there is not enough space on the page; otherwise, return true
+	// there is not enough space on the page; otherwise, return true.  On a slotted
+	// page, the record is given the next slot
 	bool append (MyDB_RecordPtr appendMe);
 
+	// adds a record to the page so that it is the whichSlot^th record, moving the records after
+	// it up by one; returns false if there is not enough space.  On a slotted page, only the
+	// slots are moved, and on a packed page, the later records are.  This cannot be used on a
+	// PAX page
+	bool insert (size_t whichSlot, MyDB_RecordPtr insertMe);
+
 	// appends a record to this page... return a pointer to the location of where
 	// the record is written if there is enough space on the page; otherwise, return
-	// a nullptr
+	// a nullptr.  Since a record on a PAX page has no location, this cannot be used on one
 	void *appendAndReturnLocation (MyDB_RecordPtr appendMe);
 
 	// gets the type of this page... this is just a value from an ennumeration
@@ -80,12 +138,29 @@ public:
 	// like the above, except that the sorting is done in place, on the page
 	void sortInPlace (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs);
 
+	// these two are like the above, except that the normalized key of each record is extracted
+	// once, and records are compared using their keys; the records themselves are only compared
+	// (using the normalizer's comparator, lhs, and rhs) when the keys tie
+	MyDB_PageReaderWriterPtr sort (MyDB_KeyNormalizerPtr keys);
+	void sortInPlace (MyDB_KeyNormalizerPtr keys);
+
 	// returns the page size
 	size_t getPageSize ();
 
 	// returns the actual bytes
 	void *getBytes ();
 
+	// overwrites the entire page with the page-sized image pointed to by fromMe; the zone
+	// of the page (if it is in a heap file) becomes unknown
+	void copyFrom (void *fromMe);
+
+	// loads each of the records on the page image (of the given size) into the normalizer's lhs
+	// record, in order, putting its location and normalized key into positions; the records on
+	// a PAX page are first written out in the binary format, into rows.  This does not use the
+	// buffer manager, so it can be run by a worker thread on a pinned page
+	static void getKeys (void *bytes, size_t pageSize, MyDB_KeyNormalizerPtr keys,
+		vector <pair <MyDB_NormalizedKey, void *>> &positions, vector <char> &rows);
+
 private:
 
 	// this is the page that we are messing with
@@ -93,9 +168,23 @@ private:
 	
 	// this is our buffer manager
 	size_t pageSize;
+
+	// true if clear () should format the page as a slotted page
+	bool slotted;
+
+	// if clear () should format the page as a PAX page, the schema of the records on it
+	MyDB_SchemaPtr paxSchema;
+
+	// if this page is in a heap file, the file's zone map (kept up to date by clear () and
+	// append ()) and the position of the page in the file; otherwise, nullptr and -1
+	MyDB_ZoneMapPtr zones;
+	int myPageNum;
 };
 
 // gets an instance of an alternatie iterator over a list of pages
 MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs);
 
+// like the above, except that the pages are read readAhead at a time (see MyDB_PageListIteratorAlt.h)
+MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs, int readAhead);
+
 #endif
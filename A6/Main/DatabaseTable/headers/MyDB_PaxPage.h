@@ -0,0 +1,171 @@
+
+#ifndef PAX_PAGE_H
+#define PAX_PAGE_H
+
+#include <memory>
+#include "MyDB_Record.h"
+#include "MyDB_Schema.h"
+#include "MyDB_SlottedPage.h"
+#include <vector>
+
+using namespace std;
+
+// This file describes the layout of a PAX page, which is the page format used by the files of
+// type "pax".  Like a slotted page, a PAX page is marked by a magic number in the page format
+// word (see MyDB_SlottedPage.h).  The records on the page are not stored one after another;
+// instead, they are cut into groups of at most PAX_GROUP_SIZE records, and within a group, the
+// values of each attribute are stored together, in a "minipage":
+//
+//	| type | PAX_PAGE_MAGIC | number of records | number of groups | start of last group |
+//	| start of strings | number of columns | kind of column 0 | kind of column 1 | ... |
+//	| group 0 | group 1 | ... | ...free space... | string n - 1 | ... | string 0 |
+//
+// and each group looks like:
+//
+//	| number of records | capacity | number of bytes | (unused) | offset, encoding of column 0 |
+//	| offset, encoding of column 1 | ... | minipage 0 | minipage 1 | ... |
+//
+// where the offsets are from the start of the group, and every minipage starts on an eight
+// byte boundary.  Records are always appended to the last group, which is "open": its minipages
+// are plain arrays with room for capacity values.  For a string, the minipage holds the offset
+// (from the start of the page) of the null-terminated string, and the strings grow backward
+// from the end of the page.  Once the last group is full (or there is no room for the strings
+// of the next record), it is sealed: its capacity becomes zero, and each int or double
+// minipage is re-written using whichever of these encodings takes up the least space:
+//
+//	PaxPlain: the plain array of values
+//	PaxFrameOfRef: | base | bit width | scale | packed bits | where each value is the base
+//		plus a bit width-bit offset
+//	PaxDelta: | first | base | bit width | scale | packed bits | where each value is the previous
+//		one plus the base plus a bit width-bit offset; this is good for sorted keys
+//	PaxRunLength: | number of runs | scale | value of each run | length of each run |
+//
+// The encodings all work on 64-bit integers; a double minipage can only be encoded if all of its
+// values are integers when they are multiplied by 10^scale, for some small scale (as with prices).
+// A page that cannot fit another record has all of its groups sealed
+//
+#define PAX_PAGE_MAGIC 0x50415820
+#define PAX_GROUP_SIZE 128
+#define IS_PAX(page) (PAGE_FORMAT (page) == PAX_PAGE_MAGIC)
+#define PAX_NUM_RECS(page) (*((size_t *) (((char *) (page)) + sizeof (size_t))))
+#define PAX_NUM_GROUPS(page) (*((size_t *) (((char *) (page)) + 2 * sizeof (size_t))))
+#define PAX_LAST_GROUP(page) (*((size_t *) (((char *) (page)) + 3 * sizeof (size_t))))
+#define PAX_STRINGS_START(page) (*((size_t *) (((char *) (page)) + 4 * sizeof (size_t))))
+#define PAX_NUM_COLS(page) (*((size_t *) (((char *) (page)) + 5 * sizeof (size_t))))
+#define PAX_COL_KIND(page, i) (((unsigned int *) (((char *) (page)) + 6 * sizeof (size_t)))[i])
+#define PAX_HEADER_SIZE(numCols) (6 * sizeof (size_t) + (((numCols) * sizeof (unsigned int) + 7) & ~((size_t) 7)))
+#define PAX_GROUP_NUM_RECS(group) (((unsigned int *) (group))[0])
+#define PAX_GROUP_CAPACITY(group) (((unsigned int *) (group))[1])
+#define PAX_GROUP_NUM_BYTES(group) (((unsigned int *) (group))[2])
+#define PAX_GROUP_COL_OFFSET(group, i) (((unsigned int *) (group))[4 + 2 * (i)])
+#define PAX_GROUP_COL_ENCODING(group, i) (((unsigned int *) (group))[5 + 2 * (i)])
+#define PAX_GROUP_HEADER_SIZE(numCols) (4 * sizeof (unsigned int) + 2 * sizeof (unsigned int) * (numCols))
+
+// the kinds of values that can be stored in a minipage
+enum MyDB_PaxKind {PaxInt, PaxDouble, PaxBool, PaxString};
+
+// the ways that a minipage can be encoded
+enum MyDB_PaxEncoding {PaxPlain, PaxFrameOfRef, PaxDelta, PaxRunLength};
+
+// the values in one minipage of a PAX page, decoded into a plain array; this is what predicates
+// are evaluated over, a column at a time
+struct MyDB_PaxColumn {
+
+	MyDB_PaxKind kind;
+	size_t numRecs;
+
+	// the array of values
+	void *data;
+
+	// the page that the minipage is on (string offsets are relative to it)
+	char *page;
+
+	int *getInts () {
+		return (int *) data;
+	}
+
+	double *getDoubles () {
+		return (double *) data;
+	}
+
+	char *getBools () {
+		return (char *) data;
+	}
+
+	const char *getString (size_t whichRec) {
+		return page + ((unsigned int *) data)[whichRec];
+	}
+};
+
+// this class reads and writes a PAX page image; it holds nothing but the location of the page.
+// Groups are named by their offset from the start of the page
+class MyDB_PaxPage {
+
+public:
+
+	MyDB_PaxPage (void *bytes, size_t pageSize);
+
+	// formats the page as an empty PAX page holding records with the given schema
+	void format (MyDB_SchemaPtr forMe);
+
+	// the number of records on the page
+	size_t getNumRecords ();
+
+	// the first group on the page, and the one after the given group; these are zero if
+	// there is no such group
+	size_t getFirstGroup ();
+	size_t getNextGroup (size_t whichGroup);
+
+	// the number of records in the given group
+	size_t getGroupSize (size_t whichGroup);
+
+	// decodes the minipage for the given attribute in the given group into buffer, and returns
+	// it; since the values are copied out, the column stays good even if the page is moved
+	// (except for the page pointer, which is needed for strings)
+	MyDB_PaxColumn getColumn (size_t whichGroup, int whichAtt, vector <char> &buffer);
+
+	// sets the given attribute of intoMe to the whichRec^th value in the column
+	static void setAtt (MyDB_PaxColumn &column, size_t whichRec, MyDB_RecordPtr intoMe, int whichAtt);
+
+	// decodes the minipages of the listed attributes in the given group, so that columns[i]
+	// holds the minipage of whichAtts[i] (its values are in buffers[i]); if the list is
+	// empty, it is first filled in with all of the attributes
+	void getColumns (size_t whichGroup, vector <int> &whichAtts, vector <MyDB_PaxColumn> &columns,
+		vector <vector <char>> &buffers);
+
+	// loads the whichRec^th record from the columns built by getColumns into intoMe
+	static void getRecord (vector <MyDB_PaxColumn> &columns, vector <int> &whichAtts, size_t whichRec,
+		MyDB_RecordPtr intoMe);
+
+	// appends a record to the page; returns false if there is not enough space
+	bool append (MyDB_RecordPtr appendMe);
+
+	// loads the whichRec^th record on the page into intoMe; this decodes a whole group,
+	// so iterating is a lot faster
+	void getRecord (size_t whichRec, MyDB_RecordPtr intoMe);
+
+	// like the above, except that only the listed attributes of intoMe are set, and the
+	// others are left as they are (an empty list means all of the attributes)
+	void getRecord (size_t whichRec, MyDB_RecordPtr intoMe, vector <int> &whichAtts);
+
+	// the number of bytes that a value of the given kind takes up in a plain minipage
+	static size_t getWidth (MyDB_PaxKind ofMe);
+
+private:
+
+	// the number of bytes taken up by a group with all plain minipages of the given capacity
+	size_t getPlainGroupSize (size_t capacity);
+
+	// adds a new, empty, open group at the end of the page, which must end before the given
+	// offset; its capacity is the number of records of size recBytes that would fit, up to
+	// PAX_GROUP_SIZE.  Returns false if there is no room for even one record
+	bool addGroup (size_t recBytes, size_t limit);
+
+	// encodes the minipages of the last group, and makes it as small as possible
+	void sealLastGroup ();
+
+	char *bytes;
+	size_t pageSize;
+};
+
+#endif
@@ -0,0 +1,50 @@
+
+#ifndef PAX_PAGE_REC_ITER_H
+#define PAX_PAGE_REC_ITER_H
+
+#include "MyDB_PageHandle.h"
+#include "MyDB_PaxPage.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIterator.h"
+
+// iterates through the records on a PAX page (see MyDB_PaxPage.h), in order; the minipages
+// of each group are decoded when the iterator gets to the group
+class MyDB_PaxPageRecIterator : public MyDB_RecordIterator {
+
+public:
+
+	// put the contents of the next record in the page into the iterator record
+	// this should be called BEFORE the iterator record is first examined
+	void getNext () override;
+
+	// return true iff there is another record in the page
+	bool hasNext () override;
+
+	// the records on a PAX page are not stored in the binary record format, so this always
+	// returns nullptr
+	void *getCurrentPointer () override;
+
+	// destructor and contructor
+	MyDB_PaxPageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn, size_t pageSize); 
+	~MyDB_PaxPageRecIterator ();
+
+private:
+
+	// the group we are in (zero before the first one), the next record in it, and the
+	// number of records that have been returned so far
+	size_t curGroup;
+	size_t curRec;
+	size_t numSeen;
+
+	// the decoded minipages of the group
+	vector <int> whichAtts;
+	vector <MyDB_PaxColumn> columns;
+	vector <vector <char>> buffers;
+
+	size_t pageSize;
+	MyDB_PageHandle myPage;
+	MyDB_RecordPtr myRec;
+	
+};
+
+#endif
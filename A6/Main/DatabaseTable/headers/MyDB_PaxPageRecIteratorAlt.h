@@ -0,0 +1,66 @@
+
+#ifndef PAX_PAGE_REC_ITER_ALT_H
+#define PAX_PAGE_REC_ITER_ALT_H
+
+#include "MyDB_PageHandle.h"
+#include "MyDB_PaxPage.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIteratorAlt.h"
+#include "MyDB_ZoneFilter.h"
+#include <vector>
+
+// the alternate (getCurrent ()/advance ()) iterator over the records on a PAX page.  The
+// iterator can be asked to load only some of the attributes of each record, and if it is given
+// a filter, the filter's comparisons are first checked against the minipages of each group, and
+// only the records that pass all of them are returned.  A group's minipages are decoded once,
+// when the iterator gets to it
+class MyDB_PaxPageRecIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+        // load the current record into the parameter
+        void getCurrent (MyDB_RecordPtr intoMe) override;
+
+	// the records on a PAX page are not stored in the binary record format, so this always
+	// returns nullptr
+        void *getCurrentPointer ();
+
+        // advance to the next record... returns true if there is a next record, and
+        // false if there are no more records to iterate over.  Not that this cannot
+        // be called until after getCurrent () has been called
+        bool advance () override;
+
+	// iterate over all of the attributes of all of the records
+	MyDB_PaxPageRecIteratorAlt (MyDB_PageHandle myPageIn, size_t pageSize); 
+
+	// only load the listed attributes (all of them if the list is empty), and only return
+	// the records that pass the filter's comparisons (all of them if the filter is nullptr)
+	MyDB_PaxPageRecIteratorAlt (MyDB_PageHandle myPageIn, size_t pageSize, MyDB_ZoneFilterPtr filter,
+		vector <int> &whichAtts); 
+	~MyDB_PaxPageRecIteratorAlt ();
+
+private:
+
+	// moves on to the next group on the page; returns false if there is none
+	bool nextGroup (MyDB_PaxPage &page);
+
+	// the group we are in (zero before the first call to advance ()), the record we are on
+	// in that group, and the number of records in the group
+	size_t curGroup;
+	size_t curRec;
+	size_t groupSize;
+	bool gotCurrent;
+	MyDB_PageHandle myPage;
+	size_t pageSize;
+
+	// the attributes to load, and the decoded minipages of the group
+	vector <int> whichAtts;
+	vector <MyDB_PaxColumn> columns;
+	vector <vector <char>> buffers;
+
+	// if there was a filter, matches[i] is zero if the i^th record of the group is not returned
+	MyDB_ZoneFilterPtr filter;
+	vector <char> matches;
+};
+
+#endif
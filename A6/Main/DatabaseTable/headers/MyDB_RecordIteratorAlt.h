@@ -23,7 +23,8 @@ public:
         // after a call to advance (), a call to getCurrentPointer () will get the address
         // of the record.  At a later time, it is then possible to reconstitute the record
         // by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page that
-	// the record is located on has not been swapped out
+	// the record is located on has not been swapped out.  This is nullptr if the record is
+	// not stored in the binary format (as on a PAX page)
         virtual void *getCurrentPointer () = 0;
 	
 	// advance to the next record... returns true if there is a next record, and 
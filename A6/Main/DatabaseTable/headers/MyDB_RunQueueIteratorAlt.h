@@ -46,17 +46,20 @@ public:
 	// build an iterator that uses the given comparator, over the two records
 	MyDB_RunQueueIteratorAlt (function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
 
-	// get access to the internal queue, for building it up
-	inline priority_queue <MyDB_RecordIteratorAltPtr,
-        vector <MyDB_RecordIteratorAltPtr>, IteratorComparator> &getQ () {
-        	return pq;
-	}
+	// build an iterator that orders the runs using their normalized keys
+	MyDB_RunQueueIteratorAlt (MyDB_KeyNormalizerPtr keys);
+
+	// add a run to the queue, for building it up; advance () must already have been
+	// called on the run (and returned true)
+	void addRun (MyDB_RecordIteratorAltPtr addMe);
 
 	~MyDB_RunQueueIteratorAlt ();
 
 private:
 
-	priority_queue <MyDB_RecordIteratorAltPtr, vector <MyDB_RecordIteratorAltPtr>, IteratorComparator> pq;
+	// the runs, each with the key of its current record
+	priority_queue <MyDB_KeyedIterator, vector <MyDB_KeyedIterator>, KeyedIteratorComparator> pq;
+	MyDB_KeyNormalizerPtr keys;
 	bool firstTime;
 };
 
@@ -0,0 +1,89 @@
+
+#ifndef SECONDARY_INDEX_H
+#define SECONDARY_INDEX_H
+
+#include <memory>
+#include "MyDB_BPlusTreeReaderWriter.h"
+#include "MyDB_BufferManager.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIteratorAlt.h"
+#include "MyDB_Table.h"
+#include "MyDB_TableReaderWriter.h"
+
+// create a smart pointer for the index
+using namespace std;
+class MyDB_SecondaryIndex;
+typedef shared_ptr <MyDB_SecondaryIndex> MyDB_SecondaryIndexPtr;
+
+// a secondary index over one attribute of a heap (or PAX) table.  The index is a B+-Tree of
+// (key, page, slot) entries, one per record in the table, where page and slot give the location
+// of the record in the table's file (the slot is the position of the record on its page).  Each
+// entry may also carry copies of other attributes of the record (the included attributes), so
+// that a query that only needs those and the key can be answered from the index alone.  The
+// index lives in its own file, described by its own table in the catalog, whose indexOf field
+// names the table that it indexes (see MyDB_Table.h).  Once it has been added to the table's
+// reader/writer (see MyDB_TableReaderWriter :: addIndex), the index is kept up to date as records
+// are appended to the table, and it is rebuilt whenever the table is loaded from a text file
+class MyDB_SecondaryIndex {
+
+public:
+
+	// makes the table for an index called indexName, stored at storageLoc, over the attribute
+	// keyAtt of baseTable, whose entries also include the attributes in includedAtts; returns
+	// nullptr if baseTable is missing any of the attributes
+	static MyDB_TablePtr makeIndexTable (string indexName, string storageLoc, MyDB_TablePtr baseTable,
+		string keyAtt, vector <string> includedAtts);
+
+	// opens the index whose table is indexTable (made by makeIndexTable), over baseTable
+	MyDB_SecondaryIndex (MyDB_TablePtr indexTable, MyDB_TableReaderWriter &baseTable, MyDB_BufferManagerPtr myBuffer);
+
+	// builds the index from scratch from the records that are in the table; the tree is bulk
+	// loaded.  Returns the number of entries
+	size_t build ();
+
+	// adds an entry for the given record of the table, which is stored at the given slot of the
+	// given page
+	void add (MyDB_RecordPtr baseRec, int whichPage, size_t whichSlot);
+
+	// returns all of the records in the table with a key in the range [low, high], inclusive.
+	// The locations of the records are all found in the index first, and then the records are
+	// fetched in the order that they are stored in the table (not in key order), so that each
+	// page of the table is read at most one time
+	MyDB_RecordIteratorAltPtr getRangeIteratorAlt (MyDB_AttValPtr low, MyDB_AttValPtr high);
+
+	// returns true if every attribute that the computation uses (see MyDB_Record :: compileComputation)
+	// is stored in the entries of the index, either as the key or as an included attribute.  If so, the
+	// computation can be run over the records of the tree instead of the records of the table
+	bool covers (string computation);
+
+	// the table that is indexed
+	MyDB_TableReaderWriter &getBaseTable ();
+
+	// the tree that holds the index entries
+	MyDB_BPlusTreeReaderWriterPtr getTree ();
+
+	// the name of the attribute that is indexed
+	string &getKeyAtt ();
+
+private:
+
+	// loads the entry for the given record into entry
+	void setEntry (MyDB_RecordPtr baseRec, int whichPage, size_t whichSlot);
+
+	// the table that is indexed
+	MyDB_TableReaderWriter &baseTable;
+
+	// the tree of entries
+	MyDB_BPlusTreeReaderWriterPtr tree;
+
+	// the position of the indexed attribute in the records of the table
+	int whichAtt;
+
+	// the positions of the included attributes in the records of the table
+	vector <int> includedAtts;
+
+	// used to build entries
+	MyDB_RecordPtr entry;
+};
+
+#endif
@@ -0,0 +1,38 @@
+
+#ifndef SLOTTED_PAGE_H
+#define SLOTTED_PAGE_H
+
+// This file describes the layout of a slotted page.  Every page starts with a MyDB_PageType,
+// stored in the first sizeof (size_t) bytes; the unused bytes after the type hold the page
+// format.  A packed page (the original format) then has the number of bytes used, followed by
+// the records, back to back.  A slotted page instead looks like:
+//
+//	| type | SLOTTED_PAGE_MAGIC | number of slots | start of records | slot 0 | slot 1 | ...
+//	...free space... | record n - 1 | ... | record 1 | record 0 |
+//
+// The slot array grows forward from the header and the records grow backward from the end of
+// the page; slot i holds the offset (from the start of the page) of record i, so the i^th
+// record on the page can be found without looking at any of the others.
+//
+// A slotted page can also be linked to the pages before and after it in the same file, as the
+// leaves of a B+-Tree are: then the last sizeof (size_t) bytes of the page hold the numbers of
+// those two pages (-1 if there is no such page), and the records grow backward from just in
+// front of them.  A linked page has LINKED_PAGE_MAGIC in place of SLOTTED_PAGE_MAGIC, so that
+// clearing or sorting it keeps the links
+//
+#define SLOTTED_PAGE_MAGIC 0x534c4f54
+#define LINKED_PAGE_MAGIC 0x4c4e4b44
+#define PACKED_BYTES_USED(page) (*((size_t *) (((char *) (page)) + sizeof (size_t))))
+#define PACKED_HEADER_SIZE (2 * sizeof (size_t))
+#define PAGE_FORMAT(page) (*((unsigned int *) (((char *) (page)) + sizeof (unsigned int))))
+#define IS_SLOTTED(page) (PAGE_FORMAT (page) == SLOTTED_PAGE_MAGIC || PAGE_FORMAT (page) == LINKED_PAGE_MAGIC)
+#define IS_LINKED(page) (PAGE_FORMAT (page) == LINKED_PAGE_MAGIC)
+#define NUM_SLOTS(page) (*((size_t *) (((char *) (page)) + sizeof (size_t))))
+#define RECORDS_START(page) (*((size_t *) (((char *) (page)) + 2 * sizeof (size_t))))
+#define SLOTTED_HEADER_SIZE (3 * sizeof (size_t))
+#define SLOT(page, i) (((unsigned int *) (((char *) (page)) + SLOTTED_HEADER_SIZE))[i])
+#define SLOTTED_FREE_SPACE(page) (RECORDS_START (page) - SLOTTED_HEADER_SIZE - NUM_SLOTS (page) * sizeof (unsigned int))
+#define PREV_PAGE(page, pageSize) (((int *) (((char *) (page)) + (pageSize) - sizeof (size_t)))[0])
+#define NEXT_PAGE(page, pageSize) (((int *) (((char *) (page)) + (pageSize) - sizeof (size_t)))[1])
+
+#endif
@@ -0,0 +1,39 @@
+
+#ifndef SLOTTED_PAGE_REC_ITER_H
+#define SLOTTED_PAGE_REC_ITER_H
+
+#include "MyDB_PageHandle.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIterator.h"
+
+// iterates through the records on a slotted page, in slot order
+class MyDB_SlottedPageRecIterator : public MyDB_RecordIterator {
+
+public:
+
+	// put the contents of the next record in the page into the iterator record
+	// this should be called BEFORE the iterator record is first examined
+	void getNext () override;
+
+	// return true iff there is another record in the page
+	bool hasNext () override;
+
+        // BEFORE a call to getNext (), a call to getCurrentPointer () will get the address
+        // of the record.  At a later time, it is then possible to reconstitute the record
+        // by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page
+        // that the record is located on has not been swapped out
+        void *getCurrentPointer () override;
+
+	// destructor and contructor
+	MyDB_SlottedPageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn); 
+	~MyDB_SlottedPageRecIterator ();
+
+private:
+
+	size_t curSlot;
+	MyDB_PageHandle myPage;
+	MyDB_RecordPtr myRec;
+	
+};
+
+#endif
@@ -0,0 +1,40 @@
+
+#ifndef SLOTTED_PAGE_REC_ITER_ALT_H
+#define SLOTTED_PAGE_REC_ITER_ALT_H
+
+#include "MyDB_PageHandle.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIteratorAlt.h"
+
+// the alternate (getCurrent ()/advance ()) iterator over the records on a slotted page
+class MyDB_SlottedPageRecIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+        // load the current record into the parameter
+        void getCurrent (MyDB_RecordPtr intoMe) override;
+
+        // after a call to advance (), a call to getCurrentPointer () will get the address
+        // of the record.  At a later time, it is then possible to reconstitute the record
+        // by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page that
+        // the record is located on has not been swapped out
+        void *getCurrentPointer ();
+
+        // advance to the next record... returns true if there is a next record, and
+        // false if there are no more records to iterate over.  Not that this cannot
+        // be called until after getCurrent () has been called
+        bool advance () override;
+
+	// destructor and contructor
+	MyDB_SlottedPageRecIteratorAlt (MyDB_PageHandle myPageIn); 
+	~MyDB_SlottedPageRecIteratorAlt ();
+
+private:
+
+	// the slot we are on; this is one past the end before the first call to advance ()
+	size_t curSlot;
+	bool gotCurrent;
+	MyDB_PageHandle myPage;
+};
+
+#endif
@@ -19,14 +19,17 @@
 #include "MyDB_RecordIterator.h"
 #include "MyDB_RecordIteratorAlt.h"
 #include "MyDB_Table.h"
+#include "MyDB_ZoneFilter.h"
 #include <set>
 #include <vector>
 
 // create a smart pointer for the table reader writer
 using namespace std;
 class MyDB_PageReaderWriter;
+class MyDB_SecondaryIndex;
 class MyDB_TableReaderWriter;
 typedef shared_ptr <MyDB_TableReaderWriter> MyDB_TableReaderWriterPtr;
+typedef shared_ptr <MyDB_SecondaryIndex> MyDB_SecondaryIndexPtr;
 
 class MyDB_TableReaderWriter {
 
@@ -38,9 +41,17 @@ public:
 	// gets an empty record from this table
 	MyDB_RecordPtr getEmptyRecord ();
 
-	// append a record to the table
+	// append a record to the table; this also updates the table's tuple count and
+	// distinct value sketches, and adds an entry for the record to each of the table's indexes
 	virtual void append (MyDB_RecordPtr appendMe);
 
+	// adds a secondary index over this table (see MyDB_SecondaryIndex.h); from now on, it is kept
+	// up to date as records are appended or loaded into the table
+	void addIndex (MyDB_SecondaryIndexPtr addMe);
+
+	// gets the secondary indexes over this table
+	vector <MyDB_SecondaryIndexPtr> &getIndexes ();
+
 	// return an itrator over this table... each time returnVal->next () is
 	// called, the resulting record will be placed into the record pointed to
 	// by iterateIntoMe
@@ -55,15 +66,38 @@ public:
 	// highPage inclusive
 	MyDB_RecordIteratorAltPtr getIteratorAlt (int lowPage, int highPage);
 
+	// gets an alternate iterator over the table that skips every page whose zone shows that
+	// it has no records that satisfy the filter's predicate (see MyDB_ZoneFilter.h); the
+	// records on the other pages are all returned
+	MyDB_RecordIteratorAltPtr getIteratorAlt (MyDB_ZoneFilterPtr filter);
+
+	// like the above, except that on the pages of a PAX file, the filter's comparisons are
+	// also checked against the minipages, so that only the records that pass them are
+	// returned, and only the listed attributes of those records are loaded (all of them if
+	// the list is empty); on other files, this is the same as the above
+	MyDB_RecordIteratorAltPtr getIteratorAlt (MyDB_ZoneFilterPtr filter, vector <int> &whichAtts);
+
 	// load a text file into this table... this returns a pair where the first
 	// entry is a list of (approximate) distinct value counts for each of the
 	// attributes in the table, and the second entry is the number of tuples that
-	// have been loaded into the table
+	// have been loaded into the table.  The table's statistics are reset and then
+	// rebuilt from the loaded records, and so are the table's indexes
 	pair <vector <size_t>, size_t> loadFromTextFile (string fromMe);
 
+	// just like the above, except that the parallel bulk loader is used: the text file is
+	// memory-mapped and parsed by numThreads threads that build the pages directly.  The
+	// loader builds packed pages, so a table with slotted or PAX pages uses loadFromTextFile
+	virtual pair <vector <size_t>, size_t> bulkLoadFromTextFile (string fromMe, int numThreads);
+
 	// dump the contents of this table into a text file
 	void writeIntoTextFile (string toMe);
 
+	// scan the table, computing the per-attribute stats (min, max, most common values,
+	// and histograms) that are used for selectivity estimation; these are computed from a
+	// reservoir sample of sampleSize records.  The tuple count and the distinct value
+	// sketches are rebuilt as well
+	void analyze (size_t sampleSize);
+
 	// access the i^th page in this file
 	MyDB_PageReaderWriter operator [] (size_t i);
 
@@ -85,13 +119,42 @@ public:
 	// gets the table object for this guy
 	MyDB_TablePtr getTable ();
 
+	// gets the zone map that the pages of this file keep up to date; this is nullptr if the
+	// file does not keep one (ex: it is a B+-Tree)
+	MyDB_ZoneMapPtr getZoneMap ();
+
 private:
 
+	// adds the record into the table's statistics
+	void updateStats (MyDB_RecordPtr fromMe);
+
+	// the current distinct value estimates for all of the attributes
+	vector <size_t> getDistinctValues ();
+
+	// empties out the file, forgetting the zones of the old pages and the statistics
+	void emptyOut ();
+
+	// rebuilds all of the indexes from the records in the table
+	void rebuildIndexes ();
+
+	friend class MyDB_BulkLoader;
 	friend class MyDB_PageReaderWriter;
 	friend class MyDB_BPlusTreeReaderWriter;
+	friend class MyDB_HashReaderWriter;
+	friend class MyDB_SecondaryIndex;
+
+	// true if the pages in this file keep the table's zone map up to date
+	bool keepsZones;
+
 	MyDB_TablePtr forMe;
 	MyDB_BufferManagerPtr myBuffer;
 	shared_ptr <MyDB_PageReaderWriter> lastPage;
+
+	// the number of records on lastPage, or -1 if they have to be counted
+	long numOnLastPage;
+
+	// the secondary indexes over this table
+	vector <MyDB_SecondaryIndexPtr> indexes;
 	
 };
 
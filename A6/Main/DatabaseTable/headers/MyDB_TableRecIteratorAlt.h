@@ -17,6 +17,7 @@
 #include "MyDB_Record.h"
 #include "MyDB_TableReaderWriter.h"
 #include "MyDB_Table.h"
+#include "MyDB_ZoneFilter.h"
 
 class MyDB_TableRecIteratorAlt : public MyDB_RecordIteratorAlt {
 
@@ -41,8 +42,25 @@ public:
 	~MyDB_TableRecIteratorAlt ();
 	MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn, int lowPage, int highPage);
 
+	// this iterator never reads the pages that the filter says can be skipped
+	MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn, MyDB_ZoneFilterPtr filter);
+
+	// as above, but on PAX pages, the filter is also checked against the minipages, and only
+	// the listed attributes are loaded (see MyDB_PageReaderWriter :: getIteratorAlt)
+	MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn, MyDB_ZoneFilterPtr filter,
+		vector <int> &whichAtts);
+
 private:
 
+	// gets ready to iterate through curPage; myIter is nullptr if the page is skipped
+	void startPage ();
+
+	MyDB_ZoneFilterPtr filter;
+
+	// true if the filter is also checked against the minipages of PAX pages
+	bool checkRecords;
+	vector <int> whichAtts;
+
 	MyDB_RecordIteratorAltPtr myIter;
 	int curPage;
 	int highPage;	
@@ -0,0 +1,87 @@
+
+#ifndef ZONE_FILTER_H
+#define ZONE_FILTER_H
+
+#include <memory>
+#include "MyDB_ColumnStats.h"
+#include "MyDB_PaxPage.h"
+#include "MyDB_Table.h"
+#include "MyDB_ZoneMap.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// This class is used by scans to skip the pages of a heap file that cannot contain any record
+// that satisfies a selection predicate.  The predicate is given in the same encoding that is
+// used by MyDB_Record :: compileComputation; every comparison of an attribute with a literal
+// (ex: "< ([suppkey], int[10])") that must hold for the whole predicate to be true (that is,
+// one that is not underneath an "||" or a "!") is checked against the zone of each page.
+// Anything else in the predicate is ignored, so it is always safe to use a filter; the records
+// on the pages that are read still need to be checked against the predicate.
+//
+// On a PAX page, the same comparisons can also be checked against the minipages of the page,
+// to find the records that are worth loading at all.
+class MyDB_ZoneFilter;
+typedef shared_ptr <MyDB_ZoneFilter> MyDB_ZoneFilterPtr;
+
+class MyDB_ZoneFilter {
+
+public:
+
+	// build a filter for the given predicate over the given table
+	MyDB_ZoneFilter (string predicate, MyDB_TablePtr forMe);
+
+	// returns true if the page cannot hold any record that satisfies the predicate; this
+	// also counts the page as either skipped or read
+	bool canSkip (int whichPage);
+
+	// returns true if the filter is ever able to skip a page (there is some usable
+	// comparison in the predicate, and the table has a zone map)
+	bool canPrune ();
+
+	// sets matches[i] to one if the i^th record in the given group of the PAX page passes all
+	// of the comparisons, and to zero otherwise; this works a (decoded) minipage at a time
+	void markMatches (MyDB_PaxPage &page, size_t whichGroup, vector <char> &matches);
+
+	// the number of pages that canSkip () has been asked about that were read, and skipped
+	size_t getPagesRead ();
+	size_t getPagesSkipped ();
+
+private:
+
+	// one comparison, "att op value"
+	struct Check {
+		int whichAtt;
+		MyDB_CompOp op;
+		bool numeric;
+		double numVal;
+		string strVal;
+	};
+
+	// one side of a comparison
+	struct Term {
+		enum {Att, Number, String, Other} kind;
+		string text;
+		double numVal;
+	};
+
+	// parses the (sub-)expression starting at pos, moving pos past it; if the expression
+	// must be true for the whole predicate to be true, then usable comparisons are added to
+	// the list of checks.  Returns false if the predicate could not be parsed
+	bool parse (const string &predicate, size_t &pos, bool mustHold, Term &result);
+
+	// adds a check for "lhs op rhs", if it can be checked using the zones
+	void addCheck (Term &lhs, string op, Term &rhs);
+
+	vector <Check> checks;
+	MyDB_TablePtr myTable;
+	MyDB_ZoneMapPtr zones;
+	size_t pagesRead;
+	size_t pagesSkipped;
+
+	// where markMatches decodes a minipage
+	vector <char> columnBuffer;
+};
+
+#endif
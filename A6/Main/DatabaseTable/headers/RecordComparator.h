@@ -3,6 +3,7 @@
 #ifndef REC_COMPARATOR_H
 #define REC_COMPARATOR_H
 
+#include "MyDB_KeyNormalizer.h"
 #include "MyDB_Record.h"
 #include <iostream>
 using namespace std;
@@ -31,4 +32,33 @@ private:
 
 };
 
+// like the above, except that each record comes with its normalized key; the records are
+// only loaded up and compared when the keys do not decide the comparison
+class KeyedRecordComparator {
+
+public:
+
+	KeyedRecordComparator (MyDB_KeyNormalizerPtr keysIn) {
+		keys = keysIn;
+		lhs = keys->getLHS ();
+		rhs = keys->getRHS ();
+	}
+
+	bool operator () (const pair <MyDB_NormalizedKey, void *> &lhsRec, const pair <MyDB_NormalizedKey, void *> &rhsRec) {
+		bool isLess;
+		if (MyDB_KeyNormalizer :: keysDecide (lhsRec.first, rhsRec.first, isLess))
+			return isLess;
+		lhs->fromBinary (lhsRec.second);
+		rhs->fromBinary (rhsRec.second);
+		return keys->compare ();	
+	}
+
+private:
+
+	MyDB_KeyNormalizerPtr keys;
+	MyDB_RecordPtr lhs;
+	MyDB_RecordPtr rhs;
+
+};
+
 #endif
@@ -6,6 +6,19 @@
 #include "MyDB_TableRecIterator.h"
 #include "MyDB_TableReaderWriter.h"
 #include "IteratorComparator.h"
+#include "MyDB_KeyNormalizer.h"
+
+// how the sorted pages of each run, and then the runs themselves, are merged: either by merging
+// runs two at a time and then using a priority queue over the runs (which is what the sort used
+// to do), or with a loser tree (see MyDB_LoserTreeIteratorAlt.h).  The loser tree merge plans
+// its passes so that it only uses about runSize pages: each run is read a few pages at a time,
+// and if there are more runs than can be read at once, groups of them are first merged into
+// longer runs (as many times as needed), so that the final merge never thrashes the buffer
+enum class MyDB_MergeKind {Pairwise, LoserTree};
+
+// how the sorted runs are made: either by cutting the input into runSize pages at a time and
+// sorting them, or by replacement selection (see replacementSelection, below)
+enum class MyDB_RunKind {SortPages, ReplacementSelection};
 
 // performs a TPMMS of the table sortMe.  The results are written to sortIntoMe.  The run 
 // size for the first phase of the TPMMS is given by runSize.  Comparisons are performed 
@@ -32,4 +45,71 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB_RecordIteratorAltPtr leftIter,
         MyDB_RecordIteratorAltPtr rightIter, function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
 
+// the following are just like the four functions above, except that the sort order is given by
+// a key normalizer (ex: make_shared <MyDB_KeyNormalizer> (lhs, rhs, "[acctbal]")).  The normalized
+// key of each record is extracted once, and records are compared by running memcmp on their keys;
+// the normalizer's comparator is only run over the normalizer's lhs and rhs when two keys tie
+void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe,
+        MyDB_KeyNormalizerPtr keys);
+
+MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe,
+        MyDB_KeyNormalizerPtr keys);
+
+MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe,
+        MyDB_KeyNormalizerPtr keys, string pred);
+
+vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB_RecordIteratorAltPtr leftIter,
+        MyDB_RecordIteratorAltPtr rightIter, MyDB_KeyNormalizerPtr keys);
+
+// just like the above, except that any number of sorted lists are merged at once, so that
+// each record is only copied one time
+vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, vector <MyDB_RecordIteratorAltPtr> &iters,
+        MyDB_KeyNormalizerPtr keys);
+
+// these are like the above, except that the sorted runs are built by numThreads worker threads.
+// The main thread pins the next runSize / 2 pages of the input and splits them among the workers;
+// each worker filters and sorts its pages into one run, and the main thread then pins as many
+// anonymous pages as the run needs, which the worker writes the run into (the buffer manager is
+// only ever used by the main thread), so about runSize pages are pinned at a time.  Since each
+// batch of pages makes numThreads runs, the runs are shorter, but the runs are all merged at
+// once at the end anyway.  If the keys were built from a comparator, they cannot be copied for
+// the workers, and one thread is used
+void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe,
+        MyDB_KeyNormalizerPtr keys, int numThreads);
+
+MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe,
+        MyDB_KeyNormalizerPtr keys, string pred, int numThreads);
+
+// these are like the above, except that the runs are made as given by runKind.  With replacement
+// selection, only one thread is used, and if there turns out to be only one run, it is returned
+// as it is, without any merging
+void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe,
+        MyDB_KeyNormalizerPtr keys, MyDB_RunKind runKind);
+
+MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe,
+        MyDB_KeyNormalizerPtr keys, string pred, MyDB_RunKind runKind);
+
+// the version of buildItertorOverSortedRuns that all of the others call; how the runs are made
+// is given by runKind, and how they are merged is given by mergeKind.  The others all use
+// MyDB_RunKind :: SortPages, MyDB_MergeKind :: LoserTree, and one thread unless they are told
+// otherwise
+MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe,
+        MyDB_KeyNormalizerPtr keys, string pred, MyDB_MergeKind mergeKind, int numThreads, MyDB_RunKind runKind);
+
+// helper function.  Makes the sorted runs of the records in sortMe that pass the predicate, using
+// replacement selection: a heap of records, stored in runSize pinned pages from the buffer, is
+// filled from the input, and then the smallest record is repeatedly written to the current run and replaced with
+// the next input record.  A record that is smaller than the last one written has to wait for the
+// next run.  On random input, the runs are about twice as long as the heap, and on input that
+// is already sorted, there is only one run.  The runs are written to anonymous pages
+vector <vector <MyDB_PageReaderWriter>> replacementSelection (int runSize, MyDB_TableReaderWriter &sortMe,
+        MyDB_KeyNormalizerPtr keys, string pred);
+
+// helper function.  Builds an iterator that merges the given sorted runs (lists of pages) with a
+// loser tree, using about runSize pages; if there are too many runs to merge at once, groups of
+// them are first merged into longer runs.  This is how buildItertorOverSortedRuns finishes a
+// sort, and it can be used by anyone who makes their own runs (ex: a sort-based aggregation)
+MyDB_RecordIteratorAltPtr mergeSortedRuns (int runSize, MyDB_BufferManagerPtr parent,
+        vector <vector <MyDB_PageReaderWriter>> &runs, MyDB_KeyNormalizerPtr keys);
+
 #endif
@@ -5,8 +5,10 @@
 #include "MyDB_INRecord.h"
 #include "MyDB_BPlusTreeReaderWriter.h"
 #include "MyDB_PageReaderWriter.h"
-#include "MyDB_PageListIteratorSelfSortingAlt.h"
+#include "MyDB_SlottedPage.h"
+#include "MyDB_BPlusRangeIteratorAlt.h"
 #include "RecordComparator.h"
+#include "Sorting.h"
 #include <algorithm>
 
 MyDB_BPlusTreeReaderWriter :: MyDB_BPlusTreeReaderWriter (string orderOnAttName, MyDB_TablePtr forMe, 
@@ -21,121 +23,324 @@ MyDB_BPlusTreeReaderWriter :: MyDB_BPlusTreeReaderWriter (string orderOnAttName,
 
 	// and the root location
 	rootLocation = getTable ()->getRootLocation ();
+
+	// string keys are prefix compressed in the directory pages
+	compressesKeys = orderingAttType->promotableToString () && !orderingAttType->promotableToDouble () &&
+		!orderingAttType->isBool ();
+	prefixRec = getINRecord ();
+
+	splitFillFactor = BPLUS_DEFAULT_SPLIT_FILL_FACTOR;
+
+	// the pages of a B+-Tree don't keep zones, so nothing can be said about any of them
+	keepsZones = false;
+	if (forMe->getZoneMap () != nullptr)
+		forMe->getZoneMap ()->clear ();
 }
 
 MyDB_RecordIteratorAltPtr MyDB_BPlusTreeReaderWriter :: getSortedRangeIteratorAlt (MyDB_AttValPtr low, MyDB_AttValPtr high) {
 
-	// this is the list of pages that we need to iterate over
-	vector <MyDB_PageReaderWriter> list;
-
-	// fill up this list of pages
-	discoverPages (rootLocation, list, low, high);
+	// this file has never had any data in it, so there is nothing to find
+	if (getNumPages () <= 1)
+		return getIteratorAlt ();
 
-	// for various comparisons
-	MyDB_RecordPtr lhs = getEmptyRecord ();
-	MyDB_RecordPtr rhs = getEmptyRecord ();
-	MyDB_RecordPtr myRec = getEmptyRecord ();
+	// find the first record that can be in the range
 	MyDB_INRecordPtr llow = getINRecord ();
 	llow->setKey (low);
+	int whichPage;
+	size_t whichSlot;
+	findFirst (llow, whichPage, whichSlot);
+
+	// and scan from there until we get past the high end of the range
+	MyDB_RecordPtr myRec = getEmptyRecord ();
 	MyDB_INRecordPtr hhigh = getINRecord ();
 	hhigh->setKey (high);
-
-	// build the comparison functions
-	function <bool ()> comparator = buildComparator (lhs, rhs);
-	function <bool ()> lowComparator = buildComparator (myRec, llow);	
 	function <bool ()> highComparator = buildComparator (hhigh, myRec);	
-
-	// and build the iterator
-	return make_shared <MyDB_PageListIteratorSelfSortingAlt> (list, lhs, rhs, comparator, myRec, lowComparator, highComparator, true);	
+	return make_shared <MyDB_BPlusRangeIteratorAlt> (*this, whichPage, whichSlot, myRec, highComparator);
 }
 
 MyDB_RecordIteratorAltPtr MyDB_BPlusTreeReaderWriter :: getRangeIteratorAlt (MyDB_AttValPtr low, MyDB_AttValPtr high) {
+	return getSortedRangeIteratorAlt (low, high);
+}
 
-	// this is the list of pages that we need to iterate over
-	vector <MyDB_PageReaderWriter> list;
+void MyDB_BPlusTreeReaderWriter :: findFirst (MyDB_INRecordPtr lowRec, int &whichPage, size_t &whichSlot) {
+
+	// at each directory page, go to the first subtree that can have a key that is at least low
+	MyDB_INRecordPtr otherRec = getINRecord ();
+	function <bool ()> comparatorLow = buildComparator (otherRec, lowRec);
+	whichPage = rootLocation;
+	MyDB_PageReaderWriter page = (*this)[whichPage];
+	while (page.getType () == MyDB_PageType :: DirectoryPage) {
+		string prefix = getPrefix (page);
+		size_t which = findEntry (page, prefix, otherRec, [&] {return !comparatorLow ();});
+		if (which == getNumEntries (page))
+			which--;
+		getEntry (page, which, prefix, otherRec);
+		whichPage = otherRec->getPtr ();
+		page = (*this)[whichPage];
+	}
 
-	// fill up this list of pages
-	discoverPages (rootLocation, list, low, high);
+	// and then find the first record on the leaf whose key is at least low
+	whichSlot = findKey (page, otherRec, [&] {return !comparatorLow ();});
+}
 
-	// for various comparisons
-	MyDB_RecordPtr lhs = getEmptyRecord ();
-	MyDB_RecordPtr rhs = getEmptyRecord ();
-	MyDB_RecordPtr myRec = getEmptyRecord ();
-	MyDB_INRecordPtr llow = getINRecord ();
-	llow->setKey (low);
-	MyDB_INRecordPtr hhigh = getINRecord ();
-	hhigh->setKey (high);
+size_t MyDB_BPlusTreeReaderWriter :: lookup (MyDB_AttValPtr key, vector <MyDB_RecordPtr> &matches) {
+
+	// this file has never had any data in it, so there is nothing to find
+	if (getNumPages () <= 1)
+		return 0;
+
+	setUpLookups ();
+	searchRec->getKey ()->set (key);
+	vector <pair <int, size_t>> path;
+	int whichPage;
+	size_t whichSlot;
+	seek (path, whichPage, whichSlot);
+
+	size_t numMatches = 0;
+	readMatches (whichPage, whichSlot, [&] (void *pos) {
+		if (numMatches == matches.size ())
+			matches.push_back (getEmptyRecord ());
+		matches[numMatches++]->fromBinary (pos);
+	});
+	return numMatches;
+}
 
-	// build the comparison functions
-	function <bool ()> comparator = buildComparator (lhs, rhs);
-	function <bool ()> lowComparator = buildComparator (myRec, llow);	
-	function <bool ()> highComparator = buildComparator (hhigh, myRec);	
+void MyDB_BPlusTreeReaderWriter :: lookup (vector <MyDB_AttValPtr> &keys, MyDB_RecordPtr intoMe,
+	function <void (size_t)> onMatch) {
+
+	if (getNumPages () <= 1)
+		return;
+
+	// sort the keys
+	vector <size_t> order;
+	for (size_t i = 0; i < keys.size (); i++)
+		order.push_back (i);
+	MyDB_AttTypePtr type = orderingAttType;
+	std::stable_sort (order.begin (), order.end (), [&] (size_t lhs, size_t rhs) {
+		if (type->promotableToInt ())
+			return keys[lhs]->toInt () < keys[rhs]->toInt ();
+		else if (type->promotableToDouble ())
+			return keys[lhs]->toDouble () < keys[rhs]->toDouble ();
+		else
+			return keys[lhs]->toString () < keys[rhs]->toString ();
+	});
+
+	// and probe them in order, each one starting from the path to the last one
+	setUpLookups ();
+	vector <pair <int, size_t>> path;
+	for (size_t i : order) {
+		searchRec->getKey ()->set (keys[i]);
+		int whichPage;
+		size_t whichSlot;
+		seek (path, whichPage, whichSlot);
+		readMatches (whichPage, whichSlot, [&] (void *pos) {
+			intoMe->fromBinary (pos);
+			onMatch (i);
+		});
+	}
+}
+
+void MyDB_BPlusTreeReaderWriter :: setUpLookups () {
 
-	// and build the iterator
-	return make_shared <MyDB_PageListIteratorSelfSortingAlt> (list, lhs, rhs, comparator, myRec, lowComparator, highComparator, false);	
+	if (searchRec != nullptr)
+		return;
+
+	searchRec = getINRecord ();
+	entryRec = getINRecord ();
+	entryBeforeSearch = buildComparator (entryRec, searchRec);
+	searchBeforeEntry = buildComparator (searchRec, entryRec);
 }
 
+void MyDB_BPlusTreeReaderWriter :: seek (vector <pair <int, size_t>> &path, int &whichPage, size_t &whichSlot) {
+
+	// go back up the path until we find an entry whose key is at least the key we are looking for;
+	// all of the entries before it are smaller than the last key, so the search would stop at it again
+	while (!path.empty ()) {
+		MyDB_PageReaderWriter page = (*this)[path.back ().first];
+		string prefix = getPrefix (page);
+		getEntry (page, path.back ().second, prefix, entryRec);
+		if (!entryBeforeSearch ())
+			break;
+		path.pop_back ();
+	}
 
-bool MyDB_BPlusTreeReaderWriter :: discoverPages (int whichPage, vector <MyDB_PageReaderWriter> &list,
-	MyDB_AttValPtr low, MyDB_AttValPtr high) {
+	// and go down from there
+	if (path.empty ())
+		whichPage = rootLocation;
+	else
+		whichPage = entryRec->getPtr ();
+
+	MyDB_PageReaderWriter page = (*this)[whichPage];
+	while (page.getType () == MyDB_PageType :: DirectoryPage) {
+		string prefix = getPrefix (page);
+		size_t which = findEntry (page, prefix, entryRec, [this] {return !entryBeforeSearch ();});
+		if (which == getNumEntries (page))
+			which--;
+		getEntry (page, which, prefix, entryRec);
+		path.push_back (make_pair (whichPage, which));
+		whichPage = entryRec->getPtr ();
+		page = (*this)[whichPage];
+	}
+	whichSlot = findKey (page, entryRec, [this] {return !entryBeforeSearch ();});
+}
 
-	// figure out the page to search
-	MyDB_PageReaderWriter pageToSearch = (*this)[whichPage];
+void MyDB_BPlusTreeReaderWriter :: readMatches (int whichPage, size_t whichSlot, function <void (void *)> onMatch) {
 
-	// it is a regular page (data page)
-	if (pageToSearch.getType () == MyDB_PageType :: RegularPage) {
+	MyDB_PageReaderWriter page = (*this)[whichPage];
+	while (true) {
 
-		list.push_back (pageToSearch);
-		return true;
-		
-	// we have an internal node, so find the subtrees to seach
-	} else {
+		// if we are off the end of the leaf, go on to the next one
+		void *pos = page.getRecordPointer (whichSlot);
+		if (pos == nullptr) {
+			int nextPage = page.getNextPage ();
+			if (nextPage == -1)
+				return;
+			page = (*this)[nextPage];
+			whichSlot = 0;
+			continue;
+		}
 
-		// iterate through the various subtrees
-		MyDB_RecordIteratorAltPtr temp = pageToSearch.getIteratorAlt ();
+		// stop at the first key past the one we are looking for
+		loadKey (pos, entryRec);
+		if (searchBeforeEntry ())
+			return;
+		onMatch (pos);
+		whichSlot++;
+	}
+}
 
-		// set up all of the comparisons that we need
-		MyDB_INRecordPtr otherRec = getINRecord ();
-		MyDB_INRecordPtr llow = getINRecord ();
-		llow->setKey (low);
-		MyDB_INRecordPtr hhigh = getINRecord ();
-		hhigh->setKey (high);
-		function <bool ()> comparatorLow = buildComparator (otherRec, llow);
-		function <bool ()> comparatorHigh = buildComparator (hhigh, otherRec);
-
-		// if the low bound and the high bound are both engaged, then we are discovering records
-		bool lowEngaged = false;
-		bool highEngaged = true;
-		bool foundLeaf = false;
-		while (temp->advance ()) {
-			
-			temp->getCurrent (otherRec);
+pair <vector <size_t>, size_t> MyDB_BPlusTreeReaderWriter :: bulkLoadFromTextFile (string fName, int numThreads) {
+
+	// write the records into the file as plain pages, and then build the tree over them
+	MyDB_TableReaderWriter :: bulkLoadFromTextFile (fName, numThreads);
+	return bulkLoad (*this, BPLUS_DEFAULT_FILL_FACTOR);
+}
+
+pair <vector <size_t>, size_t> MyDB_BPlusTreeReaderWriter :: bulkLoad (MyDB_TableReaderWriter &fromMe, double fillFactor) {
 
-			if (!comparatorLow ()) 
-				lowEngaged = true;
+	// sort the input on the key; all of the records are copied into the sorted runs before
+	// this returns, so the pages of the file can be overwritten, even if fromMe is this file
+	MyDB_RecordPtr lhs = fromMe.getEmptyRecord ();
+	MyDB_RecordPtr rhs = fromMe.getEmptyRecord ();
+	string keyName = getTable ()->getSchema ()->getAtts ()[whichAttIsOrdering].first;
+	MyDB_KeyNormalizerPtr keys = make_shared <MyDB_KeyNormalizer> (lhs, rhs, "[" + keyName + "]");
+	MyDB_RecordIteratorAltPtr sorted = buildItertorOverSortedRuns (getBufferMgr ()->numPages / 2, fromMe, keys);
 
-			// see if the new key is less than the key in the directory record
-			if (lowEngaged && highEngaged) {
-				if (foundLeaf) {
-					list.push_back ((*this)[otherRec->getPtr ()]);
+	// the statistics are rebuilt as the leaves are written
+	getTable ()->clearStats ();
 
-				} else {
-					foundLeaf = discoverPages (otherRec->getPtr (), list, low, high);	
-				}
-			}
+	// write the leaves, in key order; we always keep the last record written, since its key
+	// goes into the directory record that points to its page
+	MyDB_RecordPtr myRec = getEmptyRecord ();
+	MyDB_RecordPtr lastRec = getEmptyRecord ();
+	vector <MyDB_INRecordPtr> parents;
+	size_t limit = (size_t) (fillFactor * getBufferMgr ()->getPageSize ());
+	size_t bytesUsed = 0;
+	size_t counter = 0;
+	int lastPageWritten = 0;
+	MyDB_PageReaderWriter leaf = (*this)[0];
+	leaf.clearAsLinked ();
+	while (sorted->advance ()) {
+
+		sorted->getCurrent (myRec);
+		updateStats (myRec);
+		counter++;
 
-			if (comparatorHigh ())
-				highEngaged = false;
+		// if the leaf is full, start a new one
+		size_t recSize = myRec->getBinarySize ();
+		if ((bytesUsed > 0 && bytesUsed + recSize > limit) || !leaf.append (myRec)) {
+			MyDB_INRecordPtr parent = getINRecord ();
+			parent->setKey (getSeparator (getKey (lastRec), getKey (myRec)));
+			parent->setPtr (lastPageWritten);
+			parents.push_back (parent);
+
+			// the leaves are linked in order
+			leaf.setNextPage (lastPageWritten + 1);
+			lastPageWritten++;
+			leaf = (*this)[lastPageWritten];
+			leaf.clearAsLinked ();
+			leaf.setPrevPage (lastPageWritten - 1);
+			leaf.append (myRec);
+			bytesUsed = 0;
 		}
-		return false;
+		bytesUsed += recSize;
+		swap (myRec, lastRec);
 	}
 
-	// note, we should never get here
-	return false;
+	// the last leaf holds all of the keys to the end
+	MyDB_INRecordPtr parent = getINRecord ();
+	parent->setPtr (lastPageWritten);
+	parents.push_back (parent);
+
+	// now build the directory, one level at a time; there is always at least one level
+	do {
+		vector <MyDB_INRecordPtr> children;
+		children.swap (parents);
+		writeLevel (children, fillFactor, lastPageWritten, parents);
+	} while (parents.size () > 1);
+
+	// the root is the last page written, and any pages after it are not part of the tree
+	rootLocation = lastPageWritten;
+	getTable ()->setRootLocation (rootLocation);
+	getTable ()->setLastPage (lastPageWritten);
+
+	return make_pair (getDistinctValues (), counter);
+}
+
+void MyDB_BPlusTreeReaderWriter :: writeLevel (vector <MyDB_INRecordPtr> &records, double fillFactor,
+	int &lastPageWritten, vector <MyDB_INRecordPtr> &parents) {
+
+	// the number of bytes that a page can hold, and the size of the record holding an empty prefix
+	size_t limit = (size_t) (fillFactor * getBufferMgr ()->getPageSize ());
+	size_t capacity = getBufferMgr ()->getPageSize () - SLOTTED_HEADER_SIZE;
+	size_t emptyPrefixSize = getPrefixOverhead ();
+
+	size_t start = 0;
+	MyDB_AttValPtr lowFence = nullptr;
+	while (start < records.size ()) {
+
+		// add entries to the page until it is full; a directory page with one entry would not
+		// make the next level any smaller, so every page gets at least two.  The prefix depends
+		// on the last entry on the page, so the size of the page is figured for each one
+		size_t end = start;
+		size_t fullBytes = 0;
+		string prefix;
+		while (end < records.size ()) {
+			size_t numOnPage = end - start + 1;
+			size_t bytes = fullBytes + records[end]->getBinarySize ();
+			string newPrefix = getPrefix (lowFence, end + 1 == records.size () ? nullptr : records[end]->getKey ());
+			size_t bytesUsed = bytes - numOnPage * newPrefix.size () +
+				(compressesKeys ? emptyPrefixSize + newPrefix.size () : 0);
+			if (numOnPage > 1 && bytesUsed + numOnPage * sizeof (unsigned int) > capacity)
+				break;
+			if (numOnPage > 2 && bytesUsed > limit)
+				break;
+			fullBytes = bytes;
+			prefix = newPrefix;
+			end++;
+		}
+
+		lastPageWritten++;
+		MyDB_PageReaderWriter page = (*this)[lastPageWritten];
+		writeDirectory (page, records, start, end, prefix);
+
+		// the last entry on the level has the largest possible key, and so does the one that points
+		// to its page
+		MyDB_INRecordPtr parent = getINRecord ();
+		if (end < records.size ())
+			parent->setKey (records[end - 1]->getKey ());
+		parent->setPtr (lastPageWritten);
+		parents.push_back (parent);
+
+		lowFence = records[end - 1]->getKey ();
+		start = end;
+	}
 }
 
 void MyDB_BPlusTreeReaderWriter :: append (MyDB_RecordPtr appendMe) {
 
+	updateStats (appendMe);
+
 	// this file has never had any data in it, because the smallest B+-Tree has two pages
 	if (getNumPages () <= 1) {
 		
@@ -150,21 +355,19 @@ void MyDB_BPlusTreeReaderWriter :: append (MyDB_RecordPtr appendMe) {
 		getTable ()->setLastPage (1);
 
 		// add that internal node record in
-		root.clear ();
-		root.append (internalNodeRec);
-		root.setType (MyDB_PageType :: DirectoryPage);
+		vector <MyDB_INRecordPtr> entries {internalNodeRec};
+		writeDirectory (root, entries, 0, 1, "");
 		
 		// and add the new record to the leaf
 		MyDB_PageReaderWriter leaf = (*this)[1];
-		leaf.clear ();
-		leaf.setType (MyDB_PageType :: RegularPage);
+		leaf.clearAsLinked ();
 		leaf.append (appendMe);
 
 	// this is a valid B+-Tree, so we can process the insert
 	} else {
 
 		// append the record into the tree
-		auto res = append (rootLocation, appendMe);
+		auto res = append (rootLocation, appendMe, nullptr, nullptr);
 		
 		// see if the root split
 		if (res != nullptr) {
@@ -173,14 +376,12 @@ void MyDB_BPlusTreeReaderWriter :: append (MyDB_RecordPtr appendMe) {
 			int newRootLoc = getTable ()->lastPage () + 1;
 			getTable ()->setLastPage (newRootLoc);
 			MyDB_PageReaderWriter newRoot = (*this)[newRootLoc];
-			newRoot.clear ();
-			newRoot.setType (MyDB_PageType :: DirectoryPage);
 
 			// add the two records; the first points to the newly-created page, the second to the old root
-			newRoot.append (res);
 			MyDB_INRecordPtr newRec = getINRecord ();
 			newRec->setPtr (rootLocation);
-			newRoot.append (newRec);
+			vector <MyDB_INRecordPtr> entries {static_pointer_cast <MyDB_INRecord> (res), newRec};
+			writeDirectory (newRoot, entries, 0, 2, "");
 
 			// and update the location of the root
 			rootLocation = newRootLoc;
@@ -189,30 +390,48 @@ void MyDB_BPlusTreeReaderWriter :: append (MyDB_RecordPtr appendMe) {
 	}
 }
 
-#define NUM_BYTES_USED *((size_t *) (((char *) temp) + sizeof (size_t)))
-
-MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: split (MyDB_PageReaderWriter splitMe, MyDB_RecordPtr andMe) {
+MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: split (int whichPage, MyDB_RecordPtr andMe, size_t whichSlot,
+	MyDB_AttValPtr lowFence, MyDB_AttValPtr highFence) {
 	
 	// get a new page for the lower one half
+	MyDB_PageReaderWriter splitMe = (*this)[whichPage];
 	int newPageLoc = getTable ()->lastPage () + 1;
 	getTable ()->setLastPage (newPageLoc);
 	MyDB_PageReaderWriter newPage = (*this)[newPageLoc];
 
-	// remember the type of this page so we can re-create it after the clear
-	MyDB_PageType myType;
-
-	// get a couple of records and a comparator so that we can sort
-	MyDB_RecordPtr lhs, rhs;
-	if (splitMe.getType () == MyDB_PageType :: RegularPage) {
-		lhs = getEmptyRecord ();
-		rhs = getEmptyRecord ();
-		myType = MyDB_PageType :: RegularPage;
-	} else if (splitMe.getType () == MyDB_PageType :: DirectoryPage) {
-		lhs = getINRecord ();
-		rhs = getINRecord ();
-		myType = MyDB_PageType :: DirectoryPage;
+	// get the record to return
+	MyDB_INRecordPtr returnVal = getINRecord ();
+	returnVal->setPtr (newPageLoc);
+
+	// a directory page is split by getting all of its entries (with their whole keys), and then
+	// writing each half with the prefix given by its fences; the median is the new fence
+	if (splitMe.getType () == MyDB_PageType :: DirectoryPage) {
+		vector <MyDB_INRecordPtr> entries;
+		string prefix = getPrefix (splitMe);
+		size_t numEntries = getNumEntries (splitMe);
+		for (size_t i = 0; i < numEntries; i++) {
+			entries.push_back (getINRecord ());
+			getEntry (splitMe, i, prefix, entries.back ());
+		}
+		entries.insert (entries.begin () + whichSlot, static_pointer_cast <MyDB_INRecord> (andMe));
+
+		// the page is at the right edge of the tree if it is on the rightmost path, and the new
+		// entry goes right before the last one, which has the largest possible key
+		vector <size_t> sizes;
+		for (auto &entry : entries)
+			sizes.push_back (entry->getBinarySize () + sizeof (unsigned int));
+		size_t capacity = getBufferMgr ()->getPageSize () - SLOTTED_HEADER_SIZE - getPrefixOverhead ();
+		size_t median = getSplitPoint (sizes, capacity, highFence == nullptr && whichSlot + 1 == numEntries);
+
+		// low data and the median go into the new page, and high data goes into the old page
+		MyDB_AttValPtr medianKey = getKey (entries[median]);
+		writeDirectory (newPage, entries, 0, median + 1, getPrefix (lowFence, medianKey));
+		writeDirectory (splitMe, entries, median + 1, entries.size (), getPrefix (medianKey, highFence));
+		returnVal->setKey (medianKey);
+		return returnVal;
 	}
-	function <bool ()> comparator = buildComparator (lhs, rhs);	
+
+	MyDB_RecordPtr lhs = getEmptyRecord ();
 
 	// temp memory to hold all of the records
 	void *temp = malloc (splitMe.getPageSize ());
@@ -221,64 +440,105 @@ MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: split (MyDB_PageReaderWriter splitM
 	// positions of the records
 	vector <void *> positions;
 
-	// compute where all of the records are located
-	int bytesConsumed = sizeof (size_t) * 2;
-	while (bytesConsumed != NUM_BYTES_USED) {
-		void *pos = bytesConsumed + (char *) temp;
-		positions.push_back (pos);
-		void *nextPos = lhs->fromBinary (pos);
-		bytesConsumed += ((char *) nextPos) - ((char *) pos);
+	// compute where all of the records are located in the copy
+	size_t numRecs = splitMe.getNumRecords ();
+	if (splitMe.isSlotted ()) {
+		for (size_t i = 0; i < numRecs; i++)
+			positions.push_back (((char *) splitMe.getRecordPointer (i) - (char *) splitMe.getBytes ()) + (char *) temp);
+	} else {
+		char *pos = sizeof (size_t) * 2 + (char *) temp;
+		for (size_t i = 0; i < numRecs; i++) {
+			positions.push_back (pos);
+			pos += *((short *) pos);
+		}
 	}
 	
-	// and get a postition for the last guy
-	void *spaceForLastGuy = malloc (andMe->getBinarySize ());
-	andMe->toBinary (spaceForLastGuy);
-	positions.push_back (spaceForLastGuy);
-
-	// now sort
-	RecordComparator myComparator (comparator, lhs, rhs);
-	std::stable_sort (positions.begin (), positions.end (), myComparator);
-
-	// get the record to return
-	MyDB_INRecordPtr returnVal = getINRecord ();
-	returnVal->setPtr (newPageLoc);
-
-	// clear the pages
-	newPage.clear ();
-	splitMe.clear ();
-	newPage.setType (myType);
-	splitMe.setType (myType);
+	// and get a postition for the new guy
+	void *spaceForNewGuy = malloc (andMe->getBinarySize ());
+	andMe->toBinary (spaceForNewGuy);
+	positions.insert (positions.begin () + whichSlot, spaceForNewGuy);
+
+	// the leaf is at the right edge of the tree if it is the last one, and the new record goes
+	// after all of the others
+	vector <size_t> sizes;
+	for (void *pos : positions)
+		sizes.push_back (*((short *) pos) + sizeof (unsigned int));
+	size_t capacity = getBufferMgr ()->getPageSize () - SLOTTED_HEADER_SIZE - sizeof (size_t);
+	size_t median = getSplitPoint (sizes, capacity, splitMe.getNextPage () == -1 && whichSlot == numRecs);
+
+	// clear the pages; leaves are linked, with the new page going in between the page and the
+	// one before it
+	int prevPage = splitMe.getPrevPage ();
+	int nextPage = splitMe.getNextPage ();
+	newPage.clearAsLinked ();
+	splitMe.clearAsLinked ();
+	newPage.setPrevPage (prevPage);
+	newPage.setNextPage (whichPage);
+	splitMe.setPrevPage (newPageLoc);
+	splitMe.setNextPage (nextPage);
+	if (prevPage != -1)
+		(*this)[prevPage].setNextPage (newPageLoc);
 
 	// and copy the data over
-	int counter = 0;
+	size_t counter = 0;
+	MyDB_AttValPtr medianKey;
 	for (void *pos : positions) {
 
 		// low data goes into the new page
 		lhs->fromBinary (pos);
-		if (counter < positions.size () / 2) 
+		if (counter < median) 
 			newPage.append (lhs);
 
-		// median goes into the old page
-		if (counter == positions.size () / 2) {
+		// median goes into the new page
+		if (counter == median) {
 			newPage.append (lhs);
-			returnVal->setKey (getKey (lhs));
+			medianKey = getKey (lhs);
+			returnVal->setKey (medianKey);
 		}
 
-		// high data goes into the old page
-		if (counter > positions.size () / 2)
+		// high data goes into the old page; the first record there decides how much of the key
+		// is needed to separate the pages
+		if (counter > median) {
+			if (counter == median + 1)
+				returnVal->setKey (getSeparator (medianKey, getKey (lhs)));
 			splitMe.append (lhs);
+		}
 
 		counter++;
 	}
 
-	free (spaceForLastGuy);
+	free (spaceForNewGuy);
 	free (temp);
 
 	return returnVal;
 
 }
 
-MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: append (int whichPage, MyDB_RecordPtr appendMe) {
+size_t MyDB_BPlusTreeReaderWriter :: getSplitPoint (vector <size_t> &sizes, size_t capacity, bool atRightEdge) {
+
+	size_t median = sizes.size () / 2;
+	if (!atRightEdge)
+		return median;
+
+	// fill the lower page up to splitFillFactor of the page (as long as the records fit), but
+	// always leave the last record for the upper page, and never put less than half of them in
+	// the lower one
+	size_t limit = min ((size_t) (splitFillFactor * getBufferMgr ()->getPageSize ()), capacity);
+	size_t splitAt = 0;
+	size_t bytesUsed = sizes[0];
+	while (splitAt + 2 < sizes.size () && bytesUsed + sizes[splitAt + 1] <= limit) {
+		splitAt++;
+		bytesUsed += sizes[splitAt];
+	}
+	return max (splitAt, median);
+}
+
+void MyDB_BPlusTreeReaderWriter :: setSplitFillFactor (double fillFactor) {
+	splitFillFactor = fillFactor;
+}
+
+MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: append (int whichPage, MyDB_RecordPtr appendMe,
+	MyDB_AttValPtr lowFence, MyDB_AttValPtr highFence) {
 
 	// figure out the page to add to
 	MyDB_PageReaderWriter pageToAddTo = (*this)[whichPage];
@@ -286,53 +546,213 @@ MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: append (int whichPage, MyDB_RecordP
 	// it is a regular page (data page)
 	if (pageToAddTo.getType () == MyDB_PageType :: RegularPage) {
 
+		// the leaf is kept sorted; the new record goes after any records with the same key
+		MyDB_INRecordPtr otherRec = getINRecord ();
+		function <bool ()> comparator = buildComparator (appendMe, otherRec);
+		size_t which = findKey (pageToAddTo, otherRec, comparator);
+
 		// if we can fit the new guy, we are good
-		if (pageToAddTo.append (appendMe)) {
+		if (pageToAddTo.insert (which, appendMe)) {
 			return nullptr;
 		}
 
 		// if we cannot, then split the page
-		return split (pageToAddTo, appendMe);	
+		return split (whichPage, appendMe, which, lowFence, highFence);	
 		
 	// we have an internal node, so find the subtree to insert into
 	} else {
 
-		// iterate through the various subtrees
-		MyDB_RecordIteratorAltPtr temp = pageToAddTo.getIteratorAlt ();
+		// binary search for the first subtree whose key is larger than the new key; the last
+		// entry has the largest possible key, so it can always take the new record
 		MyDB_INRecordPtr otherRec = getINRecord ();
 		function <bool ()> comparator = buildComparator (appendMe, otherRec);
-		while (temp->advance ()) {
-			
-			// see if the new key is less than the key in the directory record
-			temp->getCurrent (otherRec);
-			if (comparator ()) {
-
-				// recursively append
-				auto res = append (otherRec->getPtr (), appendMe);
-
-				// we got a child split
-				if (res != nullptr) {
-
-					// attempt to add the new one	
-					if (pageToAddTo.append (res)) {
-						MyDB_INRecordPtr otherRec = getINRecord ();
-						function <bool ()> comparator = buildComparator (res, otherRec);	
-						pageToAddTo.sortInPlace (comparator, res, otherRec);
-						return nullptr;
-					}
-
-					// could not fit the new one, so split it
-					return split (pageToAddTo, res);
-				}
+		string prefix = getPrefix (pageToAddTo);
+		size_t which = findEntry (pageToAddTo, prefix, otherRec, comparator);
+		if (which == getNumEntries (pageToAddTo))
+			which--;
+
+		// the subtree's fences are the keys of the entries on either side of it; the last subtree
+		// on the right edge of the tree has no high fence
+		MyDB_AttValPtr childLowFence = lowFence;
+		if (which > 0) {
+			getEntry (pageToAddTo, which - 1, prefix, otherRec);
+			childLowFence = otherRec->getKey ()->getCopy ();
+		}
+		getEntry (pageToAddTo, which, prefix, otherRec);
+		MyDB_AttValPtr childHighFence = otherRec->getKey ();
+		if (highFence == nullptr && which + 1 == getNumEntries (pageToAddTo))
+			childHighFence = nullptr;
+
+		// recursively append
+		auto res = append (otherRec->getPtr (), appendMe, childLowFence, childHighFence);
+
+		// we got a child split; the new page holds the lower half of the child, so the
+		// entry pointing to it goes right before the entry pointing to the child
+		if (res != nullptr) {
+			if (insertEntry (pageToAddTo, which, res))
 				return nullptr;
-			}
+
+			// could not fit the new one, so split it
+			return split (whichPage, res, which, lowFence, highFence);
 		}
+		return nullptr;
 	}
 
 	// note, we should never get here
 	return nullptr;
 }
 
+size_t MyDB_BPlusTreeReaderWriter :: findEntry (MyDB_PageReaderWriter &page, string &prefix, MyDB_INRecordPtr entryRec,
+	function <bool ()> isPast) {
+
+	size_t low = 0;
+	size_t high = getNumEntries (page);
+	while (low < high) {
+		size_t mid = (low + high) / 2;
+		getEntry (page, mid, prefix, entryRec);
+		if (isPast ())
+			high = mid;
+		else
+			low = mid + 1;
+	}
+	return low;
+}
+
+size_t MyDB_BPlusTreeReaderWriter :: getNumEntries (MyDB_PageReaderWriter &page) {
+	if (compressesKeys)
+		return page.getNumRecords () - 1;
+	return page.getNumRecords ();
+}
+
+size_t MyDB_BPlusTreeReaderWriter :: getPrefixOverhead () {
+	if (!compressesKeys)
+		return 0;
+	string empty = "";
+	prefixRec->getKey ()->fromString (empty);
+	prefixRec->recordContentHasChanged ();
+	return prefixRec->getBinarySize () + sizeof (unsigned int);
+}
+
+string MyDB_BPlusTreeReaderWriter :: getPrefix (MyDB_PageReaderWriter &page) {
+	if (!compressesKeys)
+		return "";
+	page.getRecord (0, prefixRec);
+	return prefixRec->getKey ()->toString ();
+}
+
+void MyDB_BPlusTreeReaderWriter :: getEntry (MyDB_PageReaderWriter &page, size_t whichEntry, string &prefix,
+	MyDB_INRecordPtr intoMe) {
+
+	if (!compressesKeys) {
+		page.getRecord (whichEntry, intoMe);
+		return;
+	}
+
+	// the first record on the page is the prefix
+	page.getRecord (whichEntry + 1, intoMe);
+	if (prefix != "") {
+		string key = prefix + intoMe->getKey ()->toString ();
+		intoMe->getKey ()->fromString (key);
+		intoMe->recordContentHasChanged ();
+	}
+}
+
+bool MyDB_BPlusTreeReaderWriter :: insertEntry (MyDB_PageReaderWriter &page, size_t whichEntry, MyDB_RecordPtr insertMe) {
+
+	if (!compressesKeys)
+		return page.insert (whichEntry, insertMe);
+
+	// every key under the page starts with the prefix, so only the rest of the key is stored
+	string prefix = getPrefix (page);
+	MyDB_INRecordPtr suffixRec = getINRecord ();
+	string suffix = getKey (insertMe)->toString ().substr (prefix.size ());
+	suffixRec->getKey ()->fromString (suffix);
+	suffixRec->setPtr (insertMe->getAtt (1)->toInt ());
+	return page.insert (whichEntry + 1, suffixRec);
+}
+
+void MyDB_BPlusTreeReaderWriter :: writeDirectory (MyDB_PageReaderWriter &page, vector <MyDB_INRecordPtr> &entries,
+	size_t from, size_t to, string prefix) {
+
+	page.clearAsSlotted ();
+	page.setType (MyDB_PageType :: DirectoryPage);
+	if (!compressesKeys) {
+		for (size_t i = from; i < to; i++)
+			page.append (entries[i]);
+		return;
+	}
+
+	// the prefix goes first, and then the rest of each key
+	prefixRec->getKey ()->fromString (prefix);
+	prefixRec->setPtr (-1);
+	page.append (prefixRec);
+	MyDB_INRecordPtr suffixRec = getINRecord ();
+	for (size_t i = from; i < to; i++) {
+		string suffix = entries[i]->getKey ()->toString ().substr (prefix.size ());
+		suffixRec->getKey ()->fromString (suffix);
+		suffixRec->setPtr (entries[i]->getPtr ());
+		page.append (suffixRec);
+	}
+}
+
+string MyDB_BPlusTreeReaderWriter :: getPrefix (MyDB_AttValPtr lowFence, MyDB_AttValPtr highFence) {
+
+	if (!compressesKeys || lowFence == nullptr || highFence == nullptr)
+		return "";
+
+	string low = lowFence->toString ();
+	string high = highFence->toString ();
+	size_t len = 0;
+	while (len < low.size () && len < high.size () && low[len] == high[len])
+		len++;
+	return low.substr (0, len);
+}
+
+MyDB_AttValPtr MyDB_BPlusTreeReaderWriter :: getSeparator (MyDB_AttValPtr low, MyDB_AttValPtr high) {
+
+	if (!compressesKeys)
+		return low;
+
+	// if high is larger, then the shortest prefix of it that is larger than low goes one
+	// character past the point where the two differ
+	string lowString = low->toString ();
+	string highString = high->toString ();
+	if (!(lowString < highString))
+		return low;
+	size_t len = 0;
+	while (len < lowString.size () && lowString[len] == highString[len])
+		len++;
+	string separator = highString.substr (0, len + 1);
+	MyDB_AttValPtr returnVal = orderingAttType->createAtt ();
+	returnVal->fromString (separator);
+	return returnVal;
+}
+
+size_t MyDB_BPlusTreeReaderWriter :: findKey (MyDB_PageReaderWriter &page, MyDB_INRecordPtr keyRec,
+	function <bool ()> isPast) {
+
+	size_t low = 0;
+	size_t high = page.getNumRecords ();
+	while (low < high) {
+		size_t mid = (low + high) / 2;
+		loadKey (page.getRecordPointer (mid), keyRec);
+		if (isPast ())
+			high = mid;
+		else
+			low = mid + 1;
+	}
+	return low;
+}
+
+void MyDB_BPlusTreeReaderWriter :: loadKey (void *pos, MyDB_INRecordPtr intoMe) {
+
+	// skip the record size, and then the attributes before the key
+	char *att = ((char *) pos) + sizeof (short);
+	for (int i = 0; i < whichAttIsOrdering; i++)
+		att += *((short *) att);
+	intoMe->getKey ()->fromBinary (att);
+}
+
 MyDB_INRecordPtr MyDB_BPlusTreeReaderWriter :: getINRecord () {
 	return make_shared <MyDB_INRecord> (orderingAttType->createAttMax ());
 }
@@ -361,10 +781,11 @@ void MyDB_BPlusTreeReaderWriter :: printTree (int whichPage, int depth) {
 	} else {
 
 		MyDB_INRecordPtr myRec = getINRecord ();
-		MyDB_RecordIteratorAltPtr temp = pageToPrint.getIteratorAlt ();
-		while (temp->advance ()) {
+		string prefix = getPrefix (pageToPrint);
+		size_t numEntries = getNumEntries (pageToPrint);
+		for (size_t i = 0; i < numEntries; i++) {
 			
-			temp->getCurrent (myRec);
+			getEntry (pageToPrint, i, prefix, myRec);
 			printTree (myRec->getPtr (), depth + 1);
 			for (int i = 0; i < depth; i++)
 				cout << "\t";
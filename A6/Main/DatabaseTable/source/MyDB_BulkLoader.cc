@@ -0,0 +1,310 @@
+
+#ifndef BULK_LOADER_C
+#define BULK_LOADER_C
+
+#include <fcntl.h>
+#include <functional>
+#include <iostream>
+#include "MyDB_BulkLoader.h"
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_SlottedPage.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+#define PAGE_TYPE(page) *((MyDB_PageType *) ((char *) (page)))
+#define NUM_BYTES_USED(page) *((size_t *) (((char *) (page)) + sizeof (size_t)))
+
+// the amount of text given to a worker thread at a time, and the number of chunks per thread
+// that are parsed before the pages are written into the table
+#define CHUNK_SIZE (8 * 1024 * 1024)
+#define CHUNKS_PER_THREAD 2
+
+MyDB_BulkLoader :: MyDB_BulkLoader (MyDB_SchemaPtr mySchema, size_t pageSizeIn, int numThreadsIn) {
+	for (auto &a : mySchema->getAtts ())
+		attTypes.push_back (a.second);
+	pageSize = pageSizeIn;
+	numThreads = numThreadsIn < 1 ? 1 : numThreadsIn;
+	bytesLoaded = 0;
+}
+
+size_t MyDB_BulkLoader :: getBytesLoaded () {
+	return bytesLoaded;
+}
+
+// finds the next occurrence of the delimiter in [start, end); returns end if there is none.  memchr
+// is vectorized by the C library, so this scans 16 or 32 bytes of the line per instruction
+static inline const char *findDelimiter (const char *start, const char *end, char delim) {
+	const char *res = (const char *) memchr (start, delim, end - start);
+	return res == nullptr ? end : res;
+}
+
+size_t MyDB_BulkLoader :: parseLine (const char *start, const char *end, char *recLoc, size_t maxBytes,
+	vector <MyDB_HyperLogLog> &sketches, MyDB_PageZone &zone) {
+
+	// room for the record header
+	size_t totSize = sizeof (short);
+	const char *pos = start;
+
+	for (size_t i = 0; i < attTypes.size (); i++) {
+
+		// find the extent of this field
+		const char *fieldEnd = findDelimiter (pos, end, '|');
+		size_t fieldLen = fieldEnd - pos;
+		MyDB_AttTypePtr &type = attTypes[i];
+		size_t hash;
+
+		// this is an int
+		if (type->promotableToInt ()) {
+
+			if (totSize + sizeof (short) + sizeof (int) > maxBytes)
+				return 0;
+
+			const char *cur = pos;
+			while (cur < fieldEnd && (*cur == ' ' || *cur == '\t'))
+				cur++;
+			bool negative = false;
+			if (cur < fieldEnd && (*cur == '-' || *cur == '+')) {
+				negative = (*cur == '-');
+				cur++;
+			}
+			long val = 0;
+			while (cur < fieldEnd && *cur >= '0' && *cur <= '9')
+				val = val * 10 + (*cur++ - '0');
+			int res = (int) (negative ? -val : val);
+
+			*((short *) (recLoc + totSize)) = (short) (sizeof (short) + sizeof (int));
+			*((int *) (recLoc + totSize + sizeof (short))) = res;
+			totSize += sizeof (short) + sizeof (int);
+			hash = std :: hash <int> () (res);
+			zone.addValue (i, (double) res);
+
+		// this is a double
+		} else if (type->promotableToDouble ()) {
+
+			if (totSize + sizeof (short) + sizeof (double) > maxBytes)
+				return 0;
+
+			// strtod needs a terminated string
+			char buf[64];
+			size_t len = fieldLen < sizeof (buf) - 1 ? fieldLen : sizeof (buf) - 1;
+			memcpy (buf, pos, len);
+			buf[len] = 0;
+			double res = strtod (buf, nullptr);
+
+			*((short *) (recLoc + totSize)) = (short) (sizeof (short) + sizeof (double));
+			*((double *) (recLoc + totSize + sizeof (short))) = res;
+			totSize += sizeof (short) + sizeof (double);
+			hash = std :: hash <int> () (res);
+			zone.addValue (i, res);
+
+		// this is a bool
+		} else if (type->isBool ()) {
+
+			if (totSize + sizeof (short) + sizeof (char) > maxBytes)
+				return 0;
+
+			bool res = (fieldLen == 4 && strncmp (pos, "true", 4) == 0);
+			*((short *) (recLoc + totSize)) = (short) (sizeof (short) + sizeof (char));
+			*(recLoc + totSize + sizeof (short)) = res ? 1 : 0;
+			totSize += sizeof (short) + sizeof (char);
+			hash = std :: hash <int> () (res);
+
+		// and this is a string
+		} else {
+
+			if (totSize + sizeof (short) + fieldLen + 1 > maxBytes)
+				return 0;
+
+			*((short *) (recLoc + totSize)) = (short) (sizeof (short) + fieldLen + 1);
+			memcpy (recLoc + totSize + sizeof (short), pos, fieldLen);
+			*(recLoc + totSize + sizeof (short) + fieldLen) = 0;
+			totSize += sizeof (short) + fieldLen + 1;
+			string val (pos, fieldLen);
+			hash = std :: hash <string> () (val);
+			zone.addValue (i, val);
+		}
+
+		// these are the same hashes that MyDB_AttVal :: hash () would produce
+		sketches[i].add (hash);
+
+		// move past the delimiter
+		pos = fieldEnd < end ? fieldEnd + 1 : end;
+	}
+
+	*((short *) recLoc) = (short) totSize;
+	return totSize;
+}
+
+void MyDB_BulkLoader :: parseChunk (Chunk &parseMe, vector <MyDB_HyperLogLog> &sketches) {
+
+	// get the first page image
+	char *curPage = (char *) malloc (pageSize);
+	PAGE_TYPE (curPage) = MyDB_PageType :: RegularPage;
+	PAGE_FORMAT (curPage) = 0;
+	NUM_BYTES_USED (curPage) = 2 * sizeof (size_t);
+	parseMe.numRecs = 0;
+	MyDB_PageZone curZone;
+	curZone.setEmpty (attTypes.size ());
+
+	const char *pos = parseMe.start;
+	while (pos < parseMe.end) {
+
+		// find the end of the line
+		const char *lineEnd = findDelimiter (pos, parseMe.end, '\n');
+		const char *next = lineEnd < parseMe.end ? lineEnd + 1 : parseMe.end;
+		if (lineEnd > pos && lineEnd[-1] == '\r')
+			lineEnd--;
+
+		// skip empty lines
+		if (lineEnd == pos) {
+			pos = next;
+			continue;
+		}
+
+		// try to write the record at the end of the current page
+		size_t used = NUM_BYTES_USED (curPage);
+		size_t recSize = parseLine (pos, lineEnd, curPage + used, pageSize - used, sketches, curZone);
+
+		// it did not fit, so go on to a new page (the values of the record that were added to
+		// the old page's zone just make that zone a bit wider than it needs to be)
+		if (recSize == 0 && used != 2 * sizeof (size_t)) {
+			parseMe.pages.push_back (curPage);
+			parseMe.zones.push_back (curZone);
+			curZone.setEmpty (attTypes.size ());
+			curPage = (char *) malloc (pageSize);
+			PAGE_TYPE (curPage) = MyDB_PageType :: RegularPage;
+			PAGE_FORMAT (curPage) = 0;
+			NUM_BYTES_USED (curPage) = 2 * sizeof (size_t);
+			used = NUM_BYTES_USED (curPage);
+			recSize = parseLine (pos, lineEnd, curPage + used, pageSize - used, sketches, curZone);
+		}
+
+		// a record that is larger than a page is dropped, just like in loadFromTextFile
+		if (recSize != 0) {
+			NUM_BYTES_USED (curPage) += recSize;
+			parseMe.numRecs++;
+		}
+
+		pos = next;
+	}
+
+	// remember the last page
+	parseMe.pages.push_back (curPage);
+	parseMe.zones.push_back (curZone);
+}
+
+pair <vector <size_t>, size_t> MyDB_BulkLoader :: load (string fName, MyDB_TableReaderWriter &intoMe) {
+
+	bytesLoaded = 0;
+	size_t counter = 0;
+
+	// map the file
+	int fd = open (fName.c_str (), O_RDONLY);
+	struct stat fileInfo;
+	if (fd < 0 || fstat (fd, &fileInfo) != 0) {
+		if (fd >= 0)
+			close (fd);
+		cout << "Loaded 0 records.\n";
+		return make_pair (intoMe.getDistinctValues (), 0);
+	}
+
+	size_t fileSize = fileInfo.st_size;
+	const char *data = nullptr;
+	if (fileSize > 0) {
+		data = (const char *) mmap (nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED) {
+			close (fd);
+			cout << "Could not map " << fName << ".\n";
+			return make_pair (intoMe.getDistinctValues (), 0);
+		}
+		madvise ((void *) data, fileSize, MADV_SEQUENTIAL);
+	}
+
+	// cut the file into chunks, each ending on a line boundary
+	vector <Chunk> chunks;
+	const char *fileEnd = data + fileSize;
+	for (const char *pos = data; pos < fileEnd;) {
+		const char *end = pos + CHUNK_SIZE < fileEnd ? pos + CHUNK_SIZE : fileEnd;
+		end = findDelimiter (end, fileEnd, '\n');
+		if (end < fileEnd)
+			end++;
+		Chunk temp;
+		temp.start = pos;
+		temp.end = end;
+		temp.numRecs = 0;
+		chunks.push_back (temp);
+		pos = end;
+	}
+
+	// the table has been emptied, so we start writing at page zero
+	int nextPage = 0;
+	bool first = true;
+
+	// process the chunks a batch at a time, so that the memory used is bounded
+	size_t batchSize = numThreads * CHUNKS_PER_THREAD;
+	for (size_t batchStart = 0; batchStart < chunks.size (); batchStart += batchSize) {
+
+		size_t batchEnd = batchStart + batchSize < chunks.size () ? batchStart + batchSize : chunks.size ();
+
+		// each thread parses every numThreads^th chunk in the batch
+		vector <vector <MyDB_HyperLogLog>> threadSketches (numThreads, vector <MyDB_HyperLogLog> (attTypes.size ()));
+		vector <thread> workers;
+		for (int t = 0; t < numThreads; t++) {
+			workers.push_back (thread ([this, t, batchStart, batchEnd, &chunks, &threadSketches] {
+				for (size_t i = batchStart + t; i < batchEnd; i += numThreads)
+					parseChunk (chunks[i], threadSketches[t]);
+			}));
+		}
+		for (auto &w : workers)
+			w.join ();
+
+		// combine the distinct value sketches
+		for (auto &s : threadSketches)
+			intoMe.forMe->mergeSketches (s);
+
+		// and write the pages, in order, along with their zones
+		MyDB_ZoneMapPtr zoneMap = intoMe.getZoneMap ();
+		for (size_t i = batchStart; i < batchEnd; i++) {
+			for (size_t j = 0; j < chunks[i].pages.size (); j++) {
+				void *page = chunks[i].pages[j];
+
+				// don't write out empty pages, except to fill page zero of an empty table
+				if (NUM_BYTES_USED (page) == 2 * sizeof (size_t) && !first) {
+					free (page);
+					continue;
+				}
+
+				if (!first)
+					nextPage++;
+				first = false;
+
+				intoMe[nextPage].copyFrom (page);
+				if (zoneMap != nullptr)
+					zoneMap->setZone (nextPage, chunks[i].zones[j]);
+				free (page);
+			}
+			chunks[i].pages.clear ();
+			chunks[i].zones.clear ();
+			counter += chunks[i].numRecs;
+		}
+	}
+
+	if (data != nullptr)
+		munmap ((void *) data, fileSize);
+	close (fd);
+	bytesLoaded = fileSize;
+
+	cout << "Loaded " << counter << " records.\n";
+
+	// finally, record the tuple count and get the vector of estimates
+	intoMe.forMe->setTupleCount (intoMe.forMe->getTupleCount () + counter);
+	return make_pair (intoMe.getDistinctValues (), counter);
+}
+
+#endif
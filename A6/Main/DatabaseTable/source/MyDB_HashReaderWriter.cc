@@ -0,0 +1,218 @@
+
+#ifndef HASH_RW_C
+#define HASH_RW_C
+
+#include "MyDB_HashReaderWriter.h"
+#include "MyDB_PageReaderWriter.h"
+
+MyDB_HashReaderWriter :: MyDB_HashReaderWriter (string hashOnAttName, MyDB_TablePtr forMe,
+	MyDB_BufferManagerPtr myBuffer) : MyDB_TableReaderWriter (forMe, myBuffer) {
+
+	// find the attribute that we hash on
+	whichAttIsHashed = forMe->getSchema ()->getAttByName (hashOnAttName).first;
+
+	// the header is the level, the split pointer, and the first page of each doubling
+	MyDB_SchemaPtr headerSchema = make_shared <MyDB_Schema> ();
+	headerSchema->appendAtt (make_pair ("level", make_shared <MyDB_IntAttType> ()));
+	headerSchema->appendAtt (make_pair ("next", make_shared <MyDB_IntAttType> ()));
+	for (int i = 0; i < HASH_MAX_DOUBLINGS; i++)
+		headerSchema->appendAtt (make_pair ("doubling" + to_string (i), make_shared <MyDB_IntAttType> ()));
+	header = make_shared <MyDB_Record> (headerSchema);
+
+	// if there is a file already, get its header
+	level = 0;
+	next = 0;
+	if (getNumPages () > 1)
+		readHeader ();
+
+	// the records are not appended in page order, so the pages don't keep zones
+	keepsZones = false;
+	if (forMe->getZoneMap () != nullptr)
+		forMe->getZoneMap ()->clear ();
+}
+
+size_t MyDB_HashReaderWriter :: getNumBuckets () {
+	if (getNumPages () <= 1)
+		return 0;
+	return (((size_t) HASH_INITIAL_BUCKETS) << level) + next;
+}
+
+void MyDB_HashReaderWriter :: initialize () {
+
+	// the first doubling is the initial buckets, which go right after the header
+	level = 0;
+	next = 0;
+	firstPages.clear ();
+	firstPages.push_back (1);
+	getTable ()->setLastPage (HASH_INITIAL_BUCKETS);
+	for (int i = 1; i <= HASH_INITIAL_BUCKETS; i++)
+		(*this)[i].clearAsLinked ();
+	writeHeader ();
+}
+
+void MyDB_HashReaderWriter :: readHeader () {
+	(*this)[0].getRecord (0, header);
+	level = header->getAtt (0)->toInt ();
+	next = header->getAtt (1)->toInt ();
+	firstPages.clear ();
+	for (int i = 0; i < HASH_MAX_DOUBLINGS && header->getAtt (i + 2)->toInt () != -1; i++)
+		firstPages.push_back (header->getAtt (i + 2)->toInt ());
+}
+
+void MyDB_HashReaderWriter :: writeHeader () {
+	header->getAtt (0)->fromInt ((int) level);
+	header->getAtt (1)->fromInt ((int) next);
+	for (int i = 0; i < HASH_MAX_DOUBLINGS; i++)
+		header->getAtt (i + 2)->fromInt (i < (int) firstPages.size () ? firstPages[i] : -1);
+	header->recordContentHasChanged ();
+
+	MyDB_PageReaderWriter headerPage = (*this)[0];
+	headerPage.clearAsSlotted ();
+	headerPage.append (header);
+	headerPage.setType (MyDB_PageType :: DirectoryPage);
+}
+
+size_t MyDB_HashReaderWriter :: getBucket (MyDB_AttValPtr key) {
+
+	// hash on the number of buckets at the start of the round, unless that bucket has been
+	// split, in which case we hash on twice as many
+	size_t hashVal = key->hash ();
+	size_t whichBucket = hashVal % (((size_t) HASH_INITIAL_BUCKETS) << level);
+	if (whichBucket < next)
+		whichBucket = hashVal % (((size_t) HASH_INITIAL_BUCKETS) << (level + 1));
+	return whichBucket;
+}
+
+int MyDB_HashReaderWriter :: getBucketPage (size_t whichBucket) {
+
+	// the first doubling has the initial buckets, and after that, the d^th doubling has as many
+	// buckets as all of the ones before it
+	size_t doubling = 0;
+	size_t firstBucket = 0;
+	size_t numBuckets = HASH_INITIAL_BUCKETS;
+	while (whichBucket >= firstBucket + numBuckets) {
+		firstBucket += numBuckets;
+		if (doubling > 0)
+			numBuckets *= 2;
+		doubling++;
+	}
+	return firstPages[doubling] + (int) (whichBucket - firstBucket);
+}
+
+bool MyDB_HashReaderWriter :: appendToBucket (size_t whichBucket, MyDB_RecordPtr appendMe) {
+
+	int whichPage = getBucketPage (whichBucket);
+	while (true) {
+		MyDB_PageReaderWriter page = (*this)[whichPage];
+		if (page.append (appendMe))
+			return true;
+
+		// if we are at the end of the chain, add a page to the end of the file
+		if (page.getNextPage () == -1) {
+			int overflowPage = getNumPages ();
+			MyDB_PageReaderWriter overflow = (*this)[overflowPage];
+			overflow.clearAsLinked ();
+			overflow.setPrevPage (whichPage);
+			page.setNextPage (overflowPage);
+			overflow.append (appendMe);
+			return false;
+		}
+		whichPage = page.getNextPage ();
+	}
+}
+
+void MyDB_HashReaderWriter :: append (MyDB_RecordPtr appendMe) {
+
+	updateStats (appendMe);
+
+	// this file has never had any data in it (or it was just emptied out)
+	if (getNumPages () <= 1)
+		initialize ();
+
+	// if the bucket overflowed, the file grows by one bucket
+	if (!appendToBucket (getBucket (appendMe->getAtt (whichAttIsHashed)), appendMe))
+		split ();
+}
+
+void MyDB_HashReaderWriter :: split () {
+
+	size_t roundSize = ((size_t) HASH_INITIAL_BUCKETS) << level;
+	if (level + 1 >= HASH_MAX_DOUBLINGS)
+		return;
+
+	// the new bucket is the first one of a new doubling, so allocate pages for all of them
+	if (next == 0) {
+		firstPages.push_back (getNumPages ());
+		for (size_t i = 0; i < roundSize; i++)
+			(*this)[getNumPages ()].clearAsLinked ();
+	}
+
+	// copy out the pages of the bucket that is split, and empty them out, keeping the chain
+	vector <MyDB_PageReaderWriter> copies;
+	int whichPage = getBucketPage (next);
+	while (whichPage != -1) {
+		MyDB_PageReaderWriter page = (*this)[whichPage];
+		MyDB_PageReaderWriter copy (*getBufferMgr ());
+		copy.copyFrom (page.getBytes ());
+		copies.push_back (copy);
+
+		int prevPage = page.getPrevPage ();
+		int nextPage = page.getNextPage ();
+		page.clearAsLinked ();
+		page.setPrevPage (prevPage);
+		page.setNextPage (nextPage);
+		whichPage = nextPage;
+	}
+
+	// advance the split pointer, so that the records are now hashed into either the old
+	// bucket or the new one
+	next++;
+	if (next == roundSize) {
+		level++;
+		next = 0;
+	}
+
+	// and put the records back
+	MyDB_RecordPtr temp = getEmptyRecord ();
+	for (auto &copy : copies) {
+		MyDB_RecordIteratorAltPtr myIter = copy.getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			appendToBucket (getBucket (temp->getAtt (whichAttIsHashed)), temp);
+		}
+	}
+
+	writeHeader ();
+}
+
+size_t MyDB_HashReaderWriter :: lookup (MyDB_AttValPtr key, vector <MyDB_RecordPtr> &matches) {
+
+	if (getNumPages () <= 1)
+		return 0;
+
+	// go through the bucket's chain, looking for records with the key
+	size_t numMatches = 0;
+	size_t hashVal = key->hash ();
+	string keyString = key->toString ();
+	int whichPage = getBucketPage (getBucket (key));
+	while (whichPage != -1) {
+		MyDB_PageReaderWriter page = (*this)[whichPage];
+		size_t numRecords = page.getNumRecords ();
+		for (size_t i = 0; i < numRecords; i++) {
+			if (numMatches == matches.size ())
+				matches.push_back (getEmptyRecord ());
+			page.getRecord (i, matches[numMatches]);
+			MyDB_AttValPtr att = matches[numMatches]->getAtt (whichAttIsHashed);
+			if (att->hash () == hashVal && att->toString () == keyString)
+				numMatches++;
+		}
+		whichPage = page.getNextPage ();
+	}
+	return numMatches;
+}
+
+pair <vector <size_t>, size_t> MyDB_HashReaderWriter :: bulkLoadFromTextFile (string fName, int) {
+	return loadFromTextFile (fName);
+}
+
+#endif
@@ -0,0 +1,104 @@
+
+#ifndef LOSER_TREE_ITER_ALT_C
+#define LOSER_TREE_ITER_ALT_C
+
+#include "MyDB_LoserTreeIteratorAlt.h"
+
+using namespace std;
+
+void MyDB_LoserTreeIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
+	runs[winner].iter->getCurrent (intoMe);
+}
+
+void *MyDB_LoserTreeIteratorAlt :: getCurrentPointer () {
+	return runs[winner].iter->getCurrentPointer ();
+}
+
+MyDB_LoserTreeIteratorAlt :: MyDB_LoserTreeIteratorAlt (MyDB_KeyNormalizerPtr keysIn) {
+	keys = keysIn;
+	winner = 0;
+	firstTime = true;
+}
+
+void MyDB_LoserTreeIteratorAlt :: addRun (MyDB_RecordIteratorAltPtr addMe) {
+
+	// get the key of the run's current record
+	MyDB_KeyedIterator temp;
+	temp.iter = addMe;
+	addMe->getCurrent (keys->getLHS ());
+	keys->getLHSKey (temp.key);
+	runs.push_back (temp);
+	done.push_back (0);
+}
+
+bool MyDB_LoserTreeIteratorAlt :: isLess (size_t lhs, size_t rhs) {
+
+	if (done[lhs])
+		return false;
+	if (done[rhs])
+		return true;
+
+	// the keys usually tell us, but if not, compare the records
+	bool res;
+	if (MyDB_KeyNormalizer :: keysDecide (runs[lhs].key, runs[rhs].key, res))
+		return res;
+	runs[lhs].iter->getCurrent (keys->getLHS ());
+	runs[rhs].iter->getCurrent (keys->getRHS ());
+	return keys->compare ();
+}
+
+size_t MyDB_LoserTreeIteratorAlt :: play (size_t whichNode) {
+
+	// this is a leaf
+	if (whichNode >= runs.size ())
+		return whichNode - runs.size ();
+
+	size_t lhs = play (2 * whichNode);
+	size_t rhs = play (2 * whichNode + 1);
+	if (isLess (rhs, lhs)) {
+		losers[whichNode] = lhs;
+		return rhs;
+	}
+	losers[whichNode] = rhs;
+	return lhs;
+}
+
+bool MyDB_LoserTreeIteratorAlt :: advance () {
+
+	if (runs.size () == 0)
+		return false;
+
+	// the first time through, play the whole tournament
+	if (firstTime) {
+		firstTime = false;
+		losers.resize (runs.size ());
+		winner = play (1);
+		return !done[winner];
+	}
+
+	if (done[winner])
+		return false;
+
+	// move the winning run along, and get its new key
+	MyDB_KeyedIterator &run = runs[winner];
+	if (run.iter->advance ()) {
+		run.iter->getCurrent (keys->getLHS ());
+		keys->getLHSKey (run.key);
+	} else {
+		done[winner] = 1;
+	}
+
+	// and re-play the matches on the path up from its leaf
+	size_t cur = winner;
+	for (size_t node = (winner + runs.size ()) / 2; node > 0; node /= 2) {
+		if (isLess (losers[node], cur))
+			swap (losers[node], cur);
+	}
+	winner = cur;
+
+	return !done[winner];
+}
+
+MyDB_LoserTreeIteratorAlt :: ~MyDB_LoserTreeIteratorAlt () {}
+
+#endif
@@ -29,10 +29,18 @@ bool MyDB_PageListIteratorAlt :: advance () {
 		return false;
 
 	curPage++;
+	readChunk ();
 	myIter = forUs[curPage].getIteratorAlt ();
 	return advance ();
 }
 
+void MyDB_PageListIteratorAlt :: readChunk () {
+	if (readAhead <= 1 || curPage % readAhead != 0)
+		return;
+	for (int i = curPage; i < curPage + readAhead && i < (int) forUs.size (); i++)
+		forUs[i].getBytes ();
+}
+
 void *MyDB_PageListIteratorAlt :: getCurrentPointer () {
 	return myIter->getCurrentPointer ();
 }
@@ -40,6 +48,15 @@ void *MyDB_PageListIteratorAlt :: getCurrentPointer () {
 MyDB_PageListIteratorAlt :: MyDB_PageListIteratorAlt (vector <MyDB_PageReaderWriter> &forUsIn) {
 	forUs = forUsIn;
 	curPage = 0;
+	readAhead = 1;
+	myIter = forUsIn[curPage].getIteratorAlt ();		
+}
+
+MyDB_PageListIteratorAlt :: MyDB_PageListIteratorAlt (vector <MyDB_PageReaderWriter> &forUsIn, int readAheadIn) {
+	forUs = forUsIn;
+	curPage = 0;
+	readAhead = readAheadIn;
+	readChunk ();
 	myIter = forUsIn[curPage].getIteratorAlt ();		
 }
 
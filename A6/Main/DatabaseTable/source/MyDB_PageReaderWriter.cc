@@ -18,6 +18,12 @@
 #include "MyDB_PageRecIterator.h"
 #include "MyDB_PageRecIteratorAlt.h"
 #include "MyDB_PageListIteratorAlt.h"
+#include "MyDB_PaxPage.h"
+#include "MyDB_PaxPageRecIterator.h"
+#include "MyDB_PaxPageRecIteratorAlt.h"
+#include "MyDB_SlottedPage.h"
+#include "MyDB_SlottedPageRecIterator.h"
+#include "MyDB_SlottedPageRecIteratorAlt.h"
 #include "RecordComparator.h"
 
 #define PAGE_TYPE *((MyDB_PageType *) ((char *) myPage->getBytes ()))
@@ -29,6 +35,10 @@ MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_TableReaderWriter &parent,
 	// get the actual page
 	myPage = parent.getBufferMgr ()->getPage (parent.getTable (), whichPage);
 	pageSize = parent.getBufferMgr ()->getPageSize ();
+	slotted = parent.getTable ()->hasSlottedPages ();
+	paxSchema = parent.getTable ()->hasPaxPages () ? parent.getTable ()->getSchema () : nullptr;
+	zones = parent.getZoneMap ();
+	myPageNum = whichPage;
 }
 
 MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_TableReaderWriter &parent, int whichPage) {
@@ -40,11 +50,18 @@ MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_TableReaderWri
 		myPage = parent.getBufferMgr ()->getPage (parent.getTable (), whichPage);
 	}
 	pageSize = parent.getBufferMgr ()->getPageSize ();
+	slotted = parent.getTable ()->hasSlottedPages ();
+	paxSchema = parent.getTable ()->hasPaxPages () ? parent.getTable ()->getSchema () : nullptr;
+	zones = parent.getZoneMap ();
+	myPageNum = whichPage;
 }
 
 MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_BufferManager &parent) {
 	myPage = parent.getPage ();	
 	pageSize = parent.getPageSize ();
+	slotted = false;
+	paxSchema = nullptr;
+	myPageNum = -1;
 	clear ();
 }
 
@@ -56,13 +73,147 @@ MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_BufferManager
 		myPage = parent.getPage ();	
 	}
 	pageSize = parent.getPageSize ();
+	slotted = false;
+	paxSchema = nullptr;
+	myPageNum = -1;
 	clear ();
 }
 
+void MyDB_PageReaderWriter :: unpin () {
+	myPage->wroteBytes ();
+	myPage->getParent ().unpin (myPage->page);
+}
+
 void MyDB_PageReaderWriter :: clear () {
-	NUM_BYTES_USED = 2 * sizeof (size_t);
+	void *bytes = myPage->getBytes ();
+	if (paxSchema != nullptr) {
+		MyDB_PaxPage (bytes, pageSize).format (paxSchema);
+	} else if (slotted && IS_LINKED (bytes)) {
+
+		// a linked page stays in the same place in its list
+		int prev = PREV_PAGE (bytes, pageSize), next = NEXT_PAGE (bytes, pageSize);
+		clearAsLinked ();
+		PREV_PAGE (bytes, pageSize) = prev;
+		NEXT_PAGE (bytes, pageSize) = next;
+		return;
+	} else if (slotted) {
+		clearAsSlotted ();
+		return;
+	} else {
+		PAGE_FORMAT (bytes) = 0;
+		NUM_BYTES_USED = 2 * sizeof (size_t);
+	}
+	PAGE_TYPE = MyDB_PageType :: RegularPage;
+	myPage->wroteBytes ();	
+
+	// the zone of the page is now known... it is empty
+	if (zones != nullptr)
+		zones->resetPage (myPageNum);
+}
+
+void MyDB_PageReaderWriter :: clearAsSlotted () {
+	void *bytes = myPage->getBytes ();
+	PAGE_FORMAT (bytes) = SLOTTED_PAGE_MAGIC;
+	NUM_SLOTS (bytes) = 0;
+	RECORDS_START (bytes) = pageSize;
 	PAGE_TYPE = MyDB_PageType :: RegularPage;
 	myPage->wroteBytes ();	
+
+	if (zones != nullptr)
+		zones->resetPage (myPageNum);
+}
+
+void MyDB_PageReaderWriter :: clearAsLinked () {
+	clearAsSlotted ();
+	void *bytes = myPage->getBytes ();
+	PAGE_FORMAT (bytes) = LINKED_PAGE_MAGIC;
+	RECORDS_START (bytes) = pageSize - sizeof (size_t);
+	PREV_PAGE (bytes, pageSize) = -1;
+	NEXT_PAGE (bytes, pageSize) = -1;
+}
+
+int MyDB_PageReaderWriter :: getPrevPage () {
+	return PREV_PAGE (myPage->getBytes (), pageSize);
+}
+
+int MyDB_PageReaderWriter :: getNextPage () {
+	return NEXT_PAGE (myPage->getBytes (), pageSize);
+}
+
+void MyDB_PageReaderWriter :: setPrevPage (int toMe) {
+	PREV_PAGE (myPage->getBytes (), pageSize) = toMe;
+	myPage->wroteBytes ();
+}
+
+void MyDB_PageReaderWriter :: setNextPage (int toMe) {
+	NEXT_PAGE (myPage->getBytes (), pageSize) = toMe;
+	myPage->wroteBytes ();
+}
+
+bool MyDB_PageReaderWriter :: isSlotted () {
+	return IS_SLOTTED (myPage->getBytes ());
+}
+
+bool MyDB_PageReaderWriter :: isLinked () {
+	return IS_LINKED (myPage->getBytes ());
+}
+
+bool MyDB_PageReaderWriter :: isPax () {
+	return IS_PAX (myPage->getBytes ());
+}
+
+size_t MyDB_PageReaderWriter :: getNumRecords () {
+
+	void *bytes = myPage->getBytes ();
+	if (IS_SLOTTED (bytes))
+		return NUM_SLOTS (bytes);
+	if (IS_PAX (bytes))
+		return PAX_NUM_RECS (bytes);
+
+	// for a packed page, we have to walk the records, using their lengths
+	size_t count = 0;
+	for (size_t pos = 2 * sizeof (size_t); pos < NUM_BYTES_USED; pos += *((short *) (pos + (char *) bytes)))
+		count++;
+	return count;
+}
+
+void *MyDB_PageReaderWriter :: getRecordPointer (size_t whichSlot) {
+
+	void *bytes = myPage->getBytes ();
+	if (IS_SLOTTED (bytes)) {
+		if (whichSlot >= NUM_SLOTS (bytes))
+			return nullptr;
+		return SLOT (bytes, whichSlot) + (char *) bytes;
+	}
+
+	// the records on a PAX page are not stored in the binary format
+	if (IS_PAX (bytes))
+		return nullptr;
+
+	// for a packed page, we have to walk past all of the earlier records
+	size_t pos = 2 * sizeof (size_t);
+	for (size_t i = 0; i < whichSlot && pos < NUM_BYTES_USED; i++)
+		pos += *((short *) (pos + (char *) bytes));
+	if (pos >= NUM_BYTES_USED)
+		return nullptr;
+	return pos + (char *) bytes;
+}
+
+bool MyDB_PageReaderWriter :: getRecord (size_t whichSlot, MyDB_RecordPtr intoMe) {
+
+	// on a PAX page, the record is put together from the minipages
+	if (isPax ()) {
+		if (whichSlot >= PAX_NUM_RECS (myPage->getBytes ()))
+			return false;
+		MyDB_PaxPage (myPage->getBytes (), pageSize).getRecord (whichSlot, intoMe);
+		return true;
+	}
+
+	void *pos = getRecordPointer (whichSlot);
+	if (pos == nullptr)
+		return false;
+	intoMe->fromBinary (pos);
+	return true;
 }
 
 MyDB_PageType MyDB_PageReaderWriter :: getType () {
@@ -73,20 +224,50 @@ MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs)
 	return make_shared <MyDB_PageListIteratorAlt> (forUs);
 }
 
+MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs, int readAhead) {
+	return make_shared <MyDB_PageListIteratorAlt> (forUs, readAhead);
+}
+
 MyDB_RecordIteratorPtr MyDB_PageReaderWriter :: getIterator (MyDB_RecordPtr iterateIntoMe) {
+	if (isSlotted ())
+		return make_shared <MyDB_SlottedPageRecIterator> (myPage, iterateIntoMe);
+	if (isPax ())
+		return make_shared <MyDB_PaxPageRecIterator> (myPage, iterateIntoMe, pageSize);
 	return make_shared <MyDB_PageRecIterator> (myPage, iterateIntoMe);
 }
 
 MyDB_RecordIteratorAltPtr MyDB_PageReaderWriter :: getIteratorAlt () {
+	if (isSlotted ())
+		return make_shared <MyDB_SlottedPageRecIteratorAlt> (myPage);
+	if (isPax ())
+		return make_shared <MyDB_PaxPageRecIteratorAlt> (myPage, pageSize);
 	return make_shared <MyDB_PageRecIteratorAlt> (myPage);
 }
 
+MyDB_RecordIteratorAltPtr MyDB_PageReaderWriter :: getIteratorAlt (MyDB_ZoneFilterPtr filter, vector <int> &whichAtts) {
+	if (isPax ())
+		return make_shared <MyDB_PaxPageRecIteratorAlt> (myPage, pageSize, filter, whichAtts);
+	return getIteratorAlt ();
+}
+
 void MyDB_PageReaderWriter :: setType (MyDB_PageType toMe) {
 	PAGE_TYPE = toMe;
 	myPage->wroteBytes ();	
 }
 
 void *MyDB_PageReaderWriter :: appendAndReturnLocation (MyDB_RecordPtr appendMe) {
+
+	// on a slotted page, the new record is the one in the last slot
+	if (isSlotted ()) {
+		if (append (appendMe))
+			return getRecordPointer (NUM_SLOTS (myPage->getBytes ()) - 1);
+		return nullptr;
+	}
+
+	// a record on a PAX page has no location
+	if (isPax ())
+		return nullptr;
+
 	void *recLocation = NUM_BYTES_USED + (char *)  myPage->getBytes ();
 	if (append (appendMe))
 		return recLocation;
@@ -94,9 +275,71 @@ void *MyDB_PageReaderWriter :: appendAndReturnLocation (MyDB_RecordPtr appendMe)
 		return nullptr;
 }
 
+bool MyDB_PageReaderWriter :: insert (size_t whichSlot, MyDB_RecordPtr insertMe) {
+
+	void *bytes = myPage->getBytes ();
+	if (IS_PAX (bytes))
+		return false;
+
+	// on a slotted page, the record is appended, and then its slot is moved to where it goes
+	if (IS_SLOTTED (bytes)) {
+		size_t numSlots = NUM_SLOTS (bytes);
+		if (whichSlot > numSlots || !append (insertMe))
+			return false;
+		unsigned int newSlot = SLOT (bytes, numSlots);
+		memmove (&SLOT (bytes, whichSlot + 1), &SLOT (bytes, whichSlot), (numSlots - whichSlot) * sizeof (unsigned int));
+		SLOT (bytes, whichSlot) = newSlot;
+		return true;
+	}
+
+	// on a packed page, the records from the slot on are moved over to make room
+	char *pos = (char *) getRecordPointer (whichSlot);
+	if (pos == nullptr)
+		return whichSlot == getNumRecords () && append (insertMe);
+
+	size_t recSize = insertMe->getBinarySize ();
+	if (recSize > NUM_BYTES_LEFT)
+		return false;
+
+	memmove (pos + recSize, pos, NUM_BYTES_USED - (pos - (char *) bytes));
+	insertMe->toBinary (pos);
+	NUM_BYTES_USED += recSize;
+	myPage->wroteBytes ();
+	if (zones != nullptr)
+		zones->addRecord (myPageNum, insertMe);
+	return true;
+}
+
 bool MyDB_PageReaderWriter :: append (MyDB_RecordPtr appendMe) {
 	
 	size_t recSize = appendMe->getBinarySize ();
+	void *bytes = myPage->getBytes ();
+
+	// on a slotted page, the record goes in front of the last one, and it needs a new slot
+	if (IS_SLOTTED (bytes)) {
+		if (recSize + sizeof (unsigned int) > SLOTTED_FREE_SPACE (bytes))
+			return false;
+
+		RECORDS_START (bytes) -= recSize;
+		appendMe->toBinary (RECORDS_START (bytes) + (char *) bytes);
+		SLOT (bytes, NUM_SLOTS (bytes)) = (unsigned int) RECORDS_START (bytes);
+		NUM_SLOTS (bytes)++;
+		myPage->wroteBytes ();
+		if (zones != nullptr)
+			zones->addRecord (myPageNum, appendMe);
+		return true;
+	}
+
+	// on a PAX page, the values go into the minipages
+	if (IS_PAX (bytes)) {
+		if (!MyDB_PaxPage (bytes, pageSize).append (appendMe))
+			return false;
+		myPage->wroteBytes ();
+		if (zones != nullptr)
+			zones->addRecord (myPageNum, appendMe);
+		return true;
+	}
+
 	if (recSize > NUM_BYTES_LEFT)
 		return false;
 
@@ -105,36 +348,40 @@ bool MyDB_PageReaderWriter :: append (MyDB_RecordPtr appendMe) {
 	appendMe->toBinary (NUM_BYTES_USED + (char *) address);
 	NUM_BYTES_USED += recSize;
 	myPage->wroteBytes ();
+	if (zones != nullptr)
+		zones->addRecord (myPageNum, appendMe);
 	return true;
 }
 
 void MyDB_PageReaderWriter :: 
 	sortInPlace (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
+	sortInPlace (make_shared <MyDB_KeyNormalizer> (comparator, lhs, rhs));
+}
+
+void MyDB_PageReaderWriter :: sortInPlace (MyDB_KeyNormalizerPtr keys) {
 
+	MyDB_RecordPtr lhs = keys->getLHS ();
 	void *temp = malloc (pageSize);
 	memcpy (temp, myPage->getBytes (), pageSize);
 
-	// first, read in the positions of all of the records
-	vector <void *> positions;
-	
-	// this basically iterates through all of the records on the page
-	int bytesConsumed = sizeof (size_t) * 2;
-	while (bytesConsumed != NUM_BYTES_USED) {
-		void *pos = bytesConsumed + (char *) temp;
-		positions.push_back (pos);
-		void *nextPos = lhs->fromBinary (pos);
-		bytesConsumed += ((char *) nextPos) - ((char *) pos);
-	}
+	// first, read in the positions and the keys of all of the records
+	vector <pair <MyDB_NormalizedKey, void *>> positions;
+	vector <char> rows;
+	getKeys (temp, pageSize, keys, positions, rows);
 
-	// and now we sort the vector of positions, using the record contents to build a comparator
-	RecordComparator myComparator (comparator, lhs, rhs);
-	std::stable_sort (positions.begin (), positions.end (), myComparator);
+	// and now we sort the vector of positions on their keys (see MyDB_KeyNormalizer :: sort)
+	keys->sort (positions);
 
-	// and write the guys back
-	NUM_BYTES_USED = 2 * sizeof (size_t);
-	myPage->wroteBytes ();	
-	for (void *pos : positions) {
-		lhs->fromBinary (pos);
+	// and write the guys back, keeping the format of the page (and its links, if it has them)
+	slotted = isSlotted ();
+	if (!isPax ())
+		paxSchema = nullptr;
+	else if (paxSchema == nullptr)
+		paxSchema = lhs->getSchema ();
+	clear ();
+	setType (((MyDB_PageType *) temp)[0]);
+	for (auto &pos : positions) {
+		lhs->fromBinary (pos.second);
 		append (lhs);
 	}
 
@@ -143,36 +390,93 @@ void MyDB_PageReaderWriter ::
 
 MyDB_PageReaderWriterPtr MyDB_PageReaderWriter :: 
 	sort (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
+	return sort (make_shared <MyDB_KeyNormalizer> (comparator, lhs, rhs));
+}
 
-	// first, read in the positions of all of the records
-	vector <void *> positions;
-	
-	// this basically iterates through all of the records on the page
-	int bytesConsumed = sizeof (size_t) * 2;
-	while (bytesConsumed != NUM_BYTES_USED) {
-		void *pos = bytesConsumed + (char *) myPage->getBytes ();
-		positions.push_back (pos);
-		void *nextPos = lhs->fromBinary (pos);
-		bytesConsumed += ((char *) nextPos) - ((char *) pos);
-	}
+MyDB_PageReaderWriterPtr MyDB_PageReaderWriter :: sort (MyDB_KeyNormalizerPtr keys) {
 
-	// and now we sort the vector of positions, using the record contents to build a comparator
-	RecordComparator myComparator (comparator, lhs, rhs);
-	std::stable_sort (positions.begin (), positions.end (), myComparator);
+	MyDB_RecordPtr lhs = keys->getLHS ();
+
+	// first, read in the positions and the keys of all of the records
+	vector <pair <MyDB_NormalizedKey, void *>> positions;
+	vector <char> rows;
+	getKeys (myPage->getBytes (), pageSize, keys, positions, rows);
+
+	// and now we sort the vector of positions on their keys (see MyDB_KeyNormalizer :: sort)
+	keys->sort (positions);
 
 	// and now create the page to return
 	MyDB_PageReaderWriterPtr returnVal = make_shared <MyDB_PageReaderWriter> (myPage->getParent ());
 	returnVal->clear ();
 	
 	// loop through all of the sorted records and write them out
-	for (void *pos : positions) {
-		lhs->fromBinary (pos);
+	for (auto &pos : positions) {
+		lhs->fromBinary (pos.second);
 		returnVal->append (lhs);
 	}
 
 	return returnVal;
 }
 
+void MyDB_PageReaderWriter :: getKeys (void *bytes, size_t pageSize, MyDB_KeyNormalizerPtr keys,
+	vector <pair <MyDB_NormalizedKey, void *>> &positions, vector <char> &rows) {
+
+	MyDB_RecordPtr lhs = keys->getLHS ();
+
+	// on a PAX page, each record is put together and written into rows in the binary format
+	if (IS_PAX (bytes)) {
+		MyDB_PaxPage page (bytes, pageSize);
+		size_t numRecs = page.getNumRecords ();
+		positions.resize (numRecs);
+		vector <size_t> offsets (numRecs);
+		vector <int> whichAtts;
+		vector <MyDB_PaxColumn> columns;
+		vector <vector <char>> buffers;
+		size_t i = 0;
+		for (size_t group = page.getFirstGroup (); group != 0; group = page.getNextGroup (group)) {
+			page.getColumns (group, whichAtts, columns, buffers);
+			size_t groupSize = page.getGroupSize (group);
+			for (size_t j = 0; j < groupSize; j++, i++) {
+				MyDB_PaxPage :: getRecord (columns, whichAtts, j, lhs);
+				keys->getLHSKey (positions[i].first);
+				offsets[i] = rows.size ();
+				rows.resize (rows.size () + lhs->getBinarySize ());
+				lhs->toBinary (rows.data () + offsets[i]);
+			}
+		}
+
+		// rows is not resized after this, so the locations are now stable
+		for (size_t i = 0; i < numRecs; i++)
+			positions[i].second = rows.data () + offsets[i];
+		return;
+	}
+
+	// on a slotted page, the records are found using the slots
+	if (IS_SLOTTED (bytes)) {
+		size_t numSlots = NUM_SLOTS (bytes);
+		positions.resize (numSlots);
+		for (size_t i = 0; i < numSlots; i++) {
+			void *pos = SLOT (bytes, i) + (char *) bytes;
+			lhs->fromBinary (pos);
+			positions[i].second = pos;
+			keys->getLHSKey (positions[i].first);
+		}
+		return;
+	}
+
+	// this basically iterates through all of the records on the page
+	size_t bytesUsed = *((size_t *) (((char *) bytes) + sizeof (size_t)));
+	size_t bytesConsumed = sizeof (size_t) * 2;
+	while (bytesConsumed != bytesUsed) {
+		void *pos = bytesConsumed + (char *) bytes;
+		void *nextPos = lhs->fromBinary (pos);
+		positions.emplace_back ();
+		positions.back ().second = pos;
+		keys->getLHSKey (positions.back ().first);
+		bytesConsumed += ((char *) nextPos) - ((char *) pos);
+	}
+}
+
 size_t MyDB_PageReaderWriter :: getPageSize () {
 	return pageSize;
 }
@@ -181,4 +485,13 @@ void *MyDB_PageReaderWriter :: getBytes () {
 	return myPage->getBytes ();
 }
 
+void MyDB_PageReaderWriter :: copyFrom (void *fromMe) {
+	memcpy (myPage->getBytes (), fromMe, pageSize);
+	myPage->wroteBytes ();
+
+	// we don't know what is on the page any more
+	if (zones != nullptr)
+		zones->forgetPage (myPageNum);
+}
+
 #endif
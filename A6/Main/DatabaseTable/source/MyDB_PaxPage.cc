@@ -0,0 +1,515 @@
+
+#ifndef PAX_PAGE_C
+#define PAX_PAGE_C
+
+#include <math.h>
+#include <stdint.h>
+#include "MyDB_AttVal.h"
+#include "MyDB_PaxPage.h"
+#include <string.h>
+
+// rounds up to the next multiple of eight
+#define ALIGN_8(x) (((x) + 7) & ~((size_t) 7))
+
+// the largest scale tried for a double minipage, and the widest bit-packed value; the packed
+// values are read with one unaligned 64-bit load, so they must fit in 64 bits after being
+// shifted by up to seven bits
+#define MAX_SCALE 6
+#define MAX_BIT_WIDTH 56
+
+static const double powersOfTen[] = {1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0, 1000000.0};
+
+// the number of bits needed to hold the given value
+static unsigned int bitsFor (uint64_t val) {
+	return val == 0 ? 0 : 64 - __builtin_clzll (val);
+}
+
+// the number of bytes taken up by numVals bit-packed values of the given width; there are eight
+// extra bytes at the end, so that the last value can be read with a 64-bit load
+static size_t packedSize (size_t numVals, unsigned int width) {
+	return ALIGN_8 ((numVals * width + 7) / 8 + sizeof (uint64_t));
+}
+
+// writes the values (each of which must fit in width bits), back to back, into out (which
+// must be zeroed, and have room for packedSize (numVals, width) bytes)
+static void packBits (uint64_t *vals, size_t numVals, unsigned int width, char *out) {
+	for (size_t i = 0; i < numVals; i++) {
+		size_t pos = i * width;
+		uint64_t word;
+		memcpy (&word, out + (pos >> 3), sizeof (word));
+		word |= vals[i] << (pos & 7);
+		memcpy (out + (pos >> 3), &word, sizeof (word));
+	}
+}
+
+// the block decoder for bit-packed values: each value is found with one unaligned load, a shift
+// and a mask, and there are no branches, so the loop can be unrolled and pipelined
+static void unpackBits (const char *in, size_t numVals, unsigned int width, uint64_t base, uint64_t *out) {
+	uint64_t mask = (((uint64_t) 1) << width) - 1;
+	for (size_t i = 0; i < numVals; i++) {
+		size_t pos = i * width;
+		uint64_t word;
+		memcpy (&word, in + (pos >> 3), sizeof (word));
+		out[i] = base + ((word >> (pos & 7)) & mask);
+	}
+}
+
+// the layouts of the headers of the encoded minipages
+struct FrameOfRefHeader {
+	int64_t base;
+	unsigned int width;
+	unsigned int scale;
+};
+
+struct DeltaHeader {
+	int64_t first;
+	int64_t base;
+	unsigned int width;
+	unsigned int scale;
+};
+
+struct RunLengthHeader {
+	unsigned int numRuns;
+	unsigned int scale;
+};
+
+// gets the values of an int or double minipage as 64-bit integers; for a double minipage, this
+// finds the smallest scale such that each value times 10^scale is an integer that gives back
+// exactly the same double.  Returns false if there is no such scale
+static bool getIntegers (char *column, MyDB_PaxKind kind, size_t numVals, int64_t *vals, unsigned int &scale) {
+
+	scale = 0;
+	if (kind == PaxInt) {
+		for (size_t i = 0; i < numVals; i++)
+			vals[i] = ((int *) column)[i];
+		return true;
+	}
+
+	double *doubles = (double *) column;
+	for (scale = 0; scale <= MAX_SCALE; scale++) {
+		double factor = powersOfTen[scale];
+		size_t i;
+		for (i = 0; i < numVals; i++) {
+			double val = doubles[i];
+			if (!(fabs (val) * factor < 1e15))
+				break;
+			vals[i] = llround (val * factor);
+			double back = vals[i] / factor;
+			if (back != val || signbit (back) != signbit (val))
+				break;
+		}
+		if (i == numVals)
+			return true;
+	}
+	return false;
+}
+
+// encodes the int or double minipage of numVals values at column into out; returns the encoding
+// that takes up the least space
+static MyDB_PaxEncoding encodeColumn (char *column, MyDB_PaxKind kind, size_t numVals, vector <char> &out) {
+
+	size_t plainSize = ALIGN_8 (numVals * MyDB_PaxPage :: getWidth (kind));
+	int64_t vals[PAX_GROUP_SIZE];
+	unsigned int scale;
+	if (numVals == 0 || !getIntegers (column, kind, numVals, vals, scale)) {
+		out.assign (column, column + plainSize);
+		return PaxPlain;
+	}
+
+	// figure out the size of each of the encodings
+	int64_t low = vals[0], high = vals[0];
+	int64_t lowDelta = 0, highDelta = 0;
+	size_t numRuns = 1;
+	for (size_t i = 1; i < numVals; i++) {
+		low = vals[i] < low ? vals[i] : low;
+		high = vals[i] > high ? vals[i] : high;
+		int64_t delta = vals[i] - vals[i - 1];
+		lowDelta = (i == 1 || delta < lowDelta) ? delta : lowDelta;
+		highDelta = (i == 1 || delta > highDelta) ? delta : highDelta;
+		numRuns += (vals[i] != vals[i - 1]);
+	}
+
+	unsigned int forWidth = bitsFor ((uint64_t) high - (uint64_t) low);
+	size_t forSize = forWidth <= MAX_BIT_WIDTH ? sizeof (FrameOfRefHeader) + packedSize (numVals, forWidth) : SIZE_MAX;
+	unsigned int deltaWidth = bitsFor ((uint64_t) highDelta - (uint64_t) lowDelta);
+	size_t deltaSize = deltaWidth <= MAX_BIT_WIDTH ? sizeof (DeltaHeader) + packedSize (numVals - 1, deltaWidth) : SIZE_MAX;
+	size_t runSize = sizeof (RunLengthHeader) + ALIGN_8 (numRuns * (sizeof (int64_t) + sizeof (unsigned char)));
+
+	// ties go to the encoding that is faster to decode
+	uint64_t offsets[PAX_GROUP_SIZE];
+	if (plainSize <= forSize && plainSize <= deltaSize && plainSize <= runSize) {
+		out.assign (column, column + plainSize);
+		return PaxPlain;
+
+	} else if (forSize <= deltaSize && forSize <= runSize) {
+		out.assign (forSize, 0);
+		FrameOfRefHeader *header = (FrameOfRefHeader *) out.data ();
+		header->base = low;
+		header->width = forWidth;
+		header->scale = scale;
+		for (size_t i = 0; i < numVals; i++)
+			offsets[i] = (uint64_t) vals[i] - (uint64_t) low;
+		packBits (offsets, numVals, forWidth, out.data () + sizeof (FrameOfRefHeader));
+		return PaxFrameOfRef;
+
+	} else if (deltaSize <= runSize) {
+		out.assign (deltaSize, 0);
+		DeltaHeader *header = (DeltaHeader *) out.data ();
+		header->first = vals[0];
+		header->base = lowDelta;
+		header->width = deltaWidth;
+		header->scale = scale;
+		for (size_t i = 1; i < numVals; i++)
+			offsets[i - 1] = (uint64_t) (vals[i] - vals[i - 1]) - (uint64_t) lowDelta;
+		packBits (offsets, numVals - 1, deltaWidth, out.data () + sizeof (DeltaHeader));
+		return PaxDelta;
+
+	} else {
+		out.assign (runSize, 0);
+		RunLengthHeader *header = (RunLengthHeader *) out.data ();
+		header->numRuns = numRuns;
+		header->scale = scale;
+		int64_t *runVals = (int64_t *) (out.data () + sizeof (RunLengthHeader));
+		unsigned char *runLengths = (unsigned char *) (runVals + numRuns);
+		size_t run = 0;
+		runVals[0] = vals[0];
+		runLengths[0] = 1;
+		for (size_t i = 1; i < numVals; i++) {
+			if (vals[i] != vals[i - 1]) {
+				run++;
+				runVals[run] = vals[i];
+			}
+			runLengths[run]++;
+		}
+		return PaxRunLength;
+	}
+}
+
+// decodes an encoded int or double minipage of numVals values into out
+static void decodeColumn (char *in, MyDB_PaxKind kind, MyDB_PaxEncoding encoding, size_t numVals, char *out) {
+
+	// first, get the 64-bit integers
+	uint64_t vals[PAX_GROUP_SIZE];
+	unsigned int scale;
+	if (encoding == PaxFrameOfRef) {
+		FrameOfRefHeader *header = (FrameOfRefHeader *) in;
+		unpackBits (in + sizeof (FrameOfRefHeader), numVals, header->width, header->base, vals);
+		scale = header->scale;
+
+	} else if (encoding == PaxDelta) {
+		DeltaHeader *header = (DeltaHeader *) in;
+		vals[0] = header->first;
+		unpackBits (in + sizeof (DeltaHeader), numVals - 1, header->width, header->base, vals + 1);
+		for (size_t i = 1; i < numVals; i++)
+			vals[i] += vals[i - 1];
+		scale = header->scale;
+
+	} else {
+		RunLengthHeader *header = (RunLengthHeader *) in;
+		int64_t *runVals = (int64_t *) (in + sizeof (RunLengthHeader));
+		unsigned char *runLengths = (unsigned char *) (runVals + header->numRuns);
+		size_t pos = 0;
+		for (size_t run = 0; run < header->numRuns; run++) {
+			for (size_t i = 0; i < runLengths[run]; i++)
+				vals[pos++] = runVals[run];
+		}
+		scale = header->scale;
+	}
+
+	// and then convert them
+	if (kind == PaxInt) {
+		int *ints = (int *) out;
+		for (size_t i = 0; i < numVals; i++)
+			ints[i] = (int) (int64_t) vals[i];
+	} else {
+		double *doubles = (double *) out;
+		double factor = powersOfTen[scale];
+		for (size_t i = 0; i < numVals; i++)
+			doubles[i] = ((int64_t) vals[i]) / factor;
+	}
+}
+
+MyDB_PaxPage :: MyDB_PaxPage (void *bytesIn, size_t pageSizeIn) {
+	bytes = (char *) bytesIn;
+	pageSize = pageSizeIn;
+}
+
+size_t MyDB_PaxPage :: getWidth (MyDB_PaxKind ofMe) {
+	if (ofMe == PaxInt)
+		return sizeof (int);
+	if (ofMe == PaxDouble)
+		return sizeof (double);
+	if (ofMe == PaxBool)
+		return sizeof (char);
+	return sizeof (unsigned int);
+}
+
+void MyDB_PaxPage :: format (MyDB_SchemaPtr forMe) {
+
+	PAGE_FORMAT (bytes) = PAX_PAGE_MAGIC;
+	PAX_NUM_RECS (bytes) = 0;
+	PAX_NUM_GROUPS (bytes) = 0;
+	PAX_LAST_GROUP (bytes) = 0;
+	PAX_STRINGS_START (bytes) = pageSize;
+
+	// the order of these checks is the same as in the bulk loader
+	size_t numCols = forMe->getAtts ().size ();
+	PAX_NUM_COLS (bytes) = numCols;
+	for (size_t i = 0; i < numCols; i++) {
+		MyDB_AttTypePtr type = forMe->getAtts ()[i].second;
+		MyDB_PaxKind kind;
+		if (type->promotableToInt ())
+			kind = PaxInt;
+		else if (type->promotableToDouble ())
+			kind = PaxDouble;
+		else if (type->isBool ())
+			kind = PaxBool;
+		else
+			kind = PaxString;
+		PAX_COL_KIND (bytes, i) = kind;
+	}
+}
+
+size_t MyDB_PaxPage :: getNumRecords () {
+	return PAX_NUM_RECS (bytes);
+}
+
+size_t MyDB_PaxPage :: getFirstGroup () {
+	return PAX_NUM_GROUPS (bytes) == 0 ? 0 : PAX_HEADER_SIZE (PAX_NUM_COLS (bytes));
+}
+
+size_t MyDB_PaxPage :: getNextGroup (size_t whichGroup) {
+	if (whichGroup == PAX_LAST_GROUP (bytes))
+		return 0;
+	return whichGroup + PAX_GROUP_NUM_BYTES (bytes + whichGroup);
+}
+
+size_t MyDB_PaxPage :: getGroupSize (size_t whichGroup) {
+	return PAX_GROUP_NUM_RECS (bytes + whichGroup);
+}
+
+MyDB_PaxColumn MyDB_PaxPage :: getColumn (size_t whichGroup, int whichAtt, vector <char> &buffer) {
+
+	char *group = bytes + whichGroup;
+	MyDB_PaxColumn returnVal;
+	returnVal.kind = (MyDB_PaxKind) PAX_COL_KIND (bytes, whichAtt);
+	returnVal.numRecs = PAX_GROUP_NUM_RECS (group);
+	returnVal.page = bytes;
+
+	// make sure that there is room for the values
+	size_t numBytes = returnVal.numRecs * getWidth (returnVal.kind);
+	if (buffer.size () < numBytes || buffer.size () == 0)
+		buffer.resize (numBytes + sizeof (double));
+	returnVal.data = buffer.data ();
+
+	char *column = group + PAX_GROUP_COL_OFFSET (group, whichAtt);
+	MyDB_PaxEncoding encoding = (MyDB_PaxEncoding) PAX_GROUP_COL_ENCODING (group, whichAtt);
+	if (encoding == PaxPlain)
+		memcpy (buffer.data (), column, numBytes);
+	else
+		decodeColumn (column, returnVal.kind, encoding, returnVal.numRecs, buffer.data ());
+	return returnVal;
+}
+
+void MyDB_PaxPage :: setAtt (MyDB_PaxColumn &column, size_t whichRec, MyDB_RecordPtr intoMe, int whichAtt) {
+
+	MyDB_AttVal *att = intoMe->getAtt (whichAtt).get ();
+	switch (column.kind) {
+	case PaxInt:
+		((MyDB_IntAttVal *) att)->set (column.getInts ()[whichRec]);
+		break;
+	case PaxDouble:
+		((MyDB_DoubleAttVal *) att)->set (column.getDoubles ()[whichRec]);
+		break;
+	case PaxBool:
+		((MyDB_BoolAttVal *) att)->set (column.getBools ()[whichRec] != 0);
+		break;
+	default:
+		((MyDB_StringAttVal *) att)->set (string (column.getString (whichRec)));
+	}
+}
+
+size_t MyDB_PaxPage :: getPlainGroupSize (size_t capacity) {
+	size_t numCols = PAX_NUM_COLS (bytes);
+	size_t size = PAX_GROUP_HEADER_SIZE (numCols);
+	for (size_t i = 0; i < numCols; i++)
+		size += ALIGN_8 (capacity * getWidth ((MyDB_PaxKind) PAX_COL_KIND (bytes, i)));
+	return size;
+}
+
+bool MyDB_PaxPage :: addGroup (size_t recBytes, size_t limit) {
+
+	size_t numCols = PAX_NUM_COLS (bytes);
+	size_t last = PAX_LAST_GROUP (bytes);
+	size_t start = last == 0 ? PAX_HEADER_SIZE (numCols) : last + PAX_GROUP_NUM_BYTES (bytes + last);
+	if (start >= limit)
+		return false;
+
+	// the capacity is the number of records that would fill up the rest of the page, if they
+	// all took up recBytes... but it must fit
+	size_t capacity = (limit - start) / recBytes;
+	capacity = capacity < 1 ? 1 : (capacity > PAX_GROUP_SIZE ? PAX_GROUP_SIZE : capacity);
+	while (capacity > 0 && start + getPlainGroupSize (capacity) > limit)
+		capacity--;
+	if (capacity == 0)
+		return false;
+
+	// and set up the group
+	char *group = bytes + start;
+	PAX_GROUP_NUM_RECS (group) = 0;
+	PAX_GROUP_CAPACITY (group) = capacity;
+	PAX_GROUP_NUM_BYTES (group) = getPlainGroupSize (capacity);
+	size_t pos = PAX_GROUP_HEADER_SIZE (numCols);
+	for (size_t i = 0; i < numCols; i++) {
+		PAX_GROUP_COL_OFFSET (group, i) = pos;
+		PAX_GROUP_COL_ENCODING (group, i) = PaxPlain;
+		pos += ALIGN_8 (capacity * getWidth ((MyDB_PaxKind) PAX_COL_KIND (bytes, i)));
+	}
+
+	PAX_LAST_GROUP (bytes) = start;
+	PAX_NUM_GROUPS (bytes)++;
+	return true;
+}
+
+void MyDB_PaxPage :: sealLastGroup () {
+
+	size_t numCols = PAX_NUM_COLS (bytes);
+	char *group = bytes + PAX_LAST_GROUP (bytes);
+	size_t numRecs = PAX_GROUP_NUM_RECS (group);
+
+	// build the sealed group off to the side; it is never larger than the open one
+	vector <char> sealed (PAX_GROUP_HEADER_SIZE (numCols));
+	vector <char> column;
+	memcpy (sealed.data (), group, sealed.size ());
+	for (size_t i = 0; i < numCols; i++) {
+		MyDB_PaxKind kind = (MyDB_PaxKind) PAX_COL_KIND (bytes, i);
+		char *start = group + PAX_GROUP_COL_OFFSET (group, i);
+		MyDB_PaxEncoding encoding = PaxPlain;
+		if (kind == PaxInt || kind == PaxDouble)
+			encoding = encodeColumn (start, kind, numRecs, column);
+		else
+			column.assign (start, start + ALIGN_8 (numRecs * getWidth (kind)));
+		PAX_GROUP_COL_OFFSET (sealed.data (), i) = sealed.size ();
+		PAX_GROUP_COL_ENCODING (sealed.data (), i) = encoding;
+		sealed.insert (sealed.end (), column.begin (), column.end ());
+	}
+
+	PAX_GROUP_CAPACITY (sealed.data ()) = 0;
+	PAX_GROUP_NUM_BYTES (sealed.data ()) = sealed.size ();
+	memcpy (group, sealed.data (), sealed.size ());
+}
+
+bool MyDB_PaxPage :: append (MyDB_RecordPtr appendMe) {
+
+	size_t numCols = PAX_NUM_COLS (bytes);
+	size_t numRecs = PAX_NUM_RECS (bytes);
+
+	// get the strings, since we need to know how much space they will take up
+	vector <string> strings;
+	size_t stringBytes = 0;
+	for (size_t i = 0; i < numCols; i++) {
+		if (PAX_COL_KIND (bytes, i) == PaxString) {
+			strings.push_back (appendMe->getAtt (i)->toString ());
+			stringBytes += strings.back ().size () + 1;
+		}
+	}
+	if (PAX_STRINGS_START (bytes) < stringBytes)
+		return false;
+	size_t limit = PAX_STRINGS_START (bytes) - stringBytes;
+
+	// see if the record fits in the last group
+	size_t last = PAX_LAST_GROUP (bytes);
+	char *group = bytes + last;
+	if (last == 0 || PAX_GROUP_NUM_RECS (group) >= PAX_GROUP_CAPACITY (group) ||
+		last + PAX_GROUP_NUM_BYTES (group) > limit) {
+
+		// it does not, so seal that group, and start a new one
+		if (last != 0 && PAX_GROUP_CAPACITY (group) != 0)
+			sealLastGroup ();
+
+		// the new group is sized for records with strings as long as the ones seen so far
+		size_t recBytes = 1;
+		for (size_t i = 0; i < numCols; i++)
+			recBytes += getWidth ((MyDB_PaxKind) PAX_COL_KIND (bytes, i));
+		recBytes += (pageSize - PAX_STRINGS_START (bytes) + stringBytes) / (numRecs + 1);
+		if (!addGroup (recBytes, limit))
+			return false;
+		group = bytes + PAX_LAST_GROUP (bytes);
+	}
+
+	// and write the values
+	size_t whichString = 0;
+	size_t stringsStart = PAX_STRINGS_START (bytes);
+	size_t pos = PAX_GROUP_NUM_RECS (group);
+	for (size_t i = 0; i < numCols; i++) {
+		char *column = group + PAX_GROUP_COL_OFFSET (group, i);
+		MyDB_AttValPtr &att = appendMe->getAtt (i);
+		switch (PAX_COL_KIND (bytes, i)) {
+		case PaxInt:
+			((int *) column)[pos] = att->toInt ();
+			break;
+		case PaxDouble:
+			((double *) column)[pos] = att->toDouble ();
+			break;
+		case PaxBool:
+			column[pos] = att->toBool () ? 1 : 0;
+			break;
+		default:
+			string &val = strings[whichString++];
+			stringsStart -= val.size () + 1;
+			memcpy (bytes + stringsStart, val.c_str (), val.size () + 1);
+			((unsigned int *) column)[pos] = (unsigned int) stringsStart;
+		}
+	}
+
+	PAX_GROUP_NUM_RECS (group)++;
+	PAX_STRINGS_START (bytes) = stringsStart;
+	PAX_NUM_RECS (bytes) = numRecs + 1;
+	return true;
+}
+
+void MyDB_PaxPage :: getRecord (size_t whichRec, MyDB_RecordPtr intoMe) {
+	vector <int> whichAtts;
+	getRecord (whichRec, intoMe, whichAtts);
+}
+
+void MyDB_PaxPage :: getRecord (size_t whichRec, MyDB_RecordPtr intoMe, vector <int> &whichAtts) {
+
+	// find the group that the record is in
+	size_t group = getFirstGroup ();
+	while (group != 0 && whichRec >= getGroupSize (group)) {
+		whichRec -= getGroupSize (group);
+		group = getNextGroup (group);
+	}
+	if (group == 0)
+		return;
+
+	vector <int> atts = whichAtts;
+	vector <MyDB_PaxColumn> columns;
+	vector <vector <char>> buffers;
+	getColumns (group, atts, columns, buffers);
+	getRecord (columns, atts, whichRec, intoMe);
+}
+
+void MyDB_PaxPage :: getColumns (size_t whichGroup, vector <int> &whichAtts, vector <MyDB_PaxColumn> &columns,
+	vector <vector <char>> &buffers) {
+
+	if (whichAtts.size () == 0) {
+		for (size_t i = 0; i < PAX_NUM_COLS (bytes); i++)
+			whichAtts.push_back (i);
+	}
+
+	columns.resize (whichAtts.size ());
+	buffers.resize (whichAtts.size ());
+	for (size_t i = 0; i < whichAtts.size (); i++)
+		columns[i] = getColumn (whichGroup, whichAtts[i], buffers[i]);
+}
+
+void MyDB_PaxPage :: getRecord (vector <MyDB_PaxColumn> &columns, vector <int> &whichAtts, size_t whichRec,
+	MyDB_RecordPtr intoMe) {
+	for (size_t i = 0; i < whichAtts.size (); i++)
+		setAtt (columns[i], whichRec, intoMe, whichAtts[i]);
+	intoMe->recordContentHasChanged ();
+}
+
+#endif
@@ -0,0 +1,47 @@
+
+#ifndef PAX_PAGE_REC_ITER_C
+#define PAX_PAGE_REC_ITER_C
+
+#include "MyDB_PaxPage.h"
+#include "MyDB_PaxPageRecIterator.h"
+
+void MyDB_PaxPageRecIterator :: getNext () {
+
+	char *bytes = (char *) myPage->getBytes ();
+	MyDB_PaxPage page (bytes, pageSize);
+
+	// move on to the next group, if we are done with this one
+	while (curGroup == 0 || curRec >= page.getGroupSize (curGroup)) {
+		curGroup = curGroup == 0 ? page.getFirstGroup () : page.getNextGroup (curGroup);
+		curRec = 0;
+		page.getColumns (curGroup, whichAtts, columns, buffers);
+	}
+
+	// the page may have moved since the group was decoded
+	for (auto &c : columns)
+		c.page = bytes;
+	MyDB_PaxPage :: getRecord (columns, whichAtts, curRec, myRec);
+	curRec++;
+	numSeen++;
+}
+
+void *MyDB_PaxPageRecIterator :: getCurrentPointer () {
+	return nullptr;
+}
+
+bool MyDB_PaxPageRecIterator :: hasNext () {
+	return numSeen < PAX_NUM_RECS (myPage->getBytes ());
+}
+
+MyDB_PaxPageRecIterator :: MyDB_PaxPageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn, size_t pageSizeIn) {
+	curGroup = 0;
+	curRec = 0;
+	numSeen = 0;
+	pageSize = pageSizeIn;
+	myPage = myPageIn;
+	myRec = myRecIn;
+}
+
+MyDB_PaxPageRecIterator :: ~MyDB_PaxPageRecIterator () {}
+
+#endif
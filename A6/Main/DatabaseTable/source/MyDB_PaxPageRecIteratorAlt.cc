@@ -0,0 +1,97 @@
+
+#ifndef PAX_PAGE_REC_ITER_ALT_C
+#define PAX_PAGE_REC_ITER_ALT_C
+
+#include <iostream>
+#include "MyDB_PaxPage.h"
+#include "MyDB_PaxPageRecIteratorAlt.h"
+
+void MyDB_PaxPageRecIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
+
+	// the page may have moved since the group was decoded
+	char *bytes = (char *) myPage->getBytes ();
+	for (auto &c : columns)
+		c.page = bytes;
+	MyDB_PaxPage :: getRecord (columns, whichAtts, curRec, intoMe);
+	gotCurrent = true;
+}
+
+void *MyDB_PaxPageRecIteratorAlt :: getCurrentPointer () {
+	return nullptr;
+}
+
+bool MyDB_PaxPageRecIteratorAlt :: nextGroup (MyDB_PaxPage &page) {
+
+	curGroup = curGroup == 0 ? page.getFirstGroup () : page.getNextGroup (curGroup);
+	curRec = 0;
+	if (curGroup == 0) {
+		groupSize = 0;
+		return false;
+	}
+
+	groupSize = page.getGroupSize (curGroup);
+	page.getColumns (curGroup, whichAtts, columns, buffers);
+	if (filter != nullptr)
+		filter->markMatches (page, curGroup, matches);
+	return true;
+}
+
+bool MyDB_PaxPageRecIteratorAlt :: advance () {
+	if (!gotCurrent) {
+		cout << "You can't call advance without calling getCurrent!!\n";
+		exit (1);
+	}
+	gotCurrent = false;
+
+	MyDB_PaxPage page (myPage->getBytes (), pageSize);
+
+	// the first call to advance gets us into the first group
+	bool started = curGroup != 0;
+	if (!started && !nextGroup (page))
+		return false;
+	else if (started)
+		curRec++;
+
+	while (true) {
+
+		// skip the records that did not pass the filter
+		if (filter != nullptr) {
+			while (curRec < groupSize && !matches[curRec])
+				curRec++;
+		}
+
+		if (curRec < groupSize)
+			return true;
+
+		if (!nextGroup (page))
+			return false;
+	}
+}
+
+MyDB_PaxPageRecIteratorAlt :: MyDB_PaxPageRecIteratorAlt (MyDB_PageHandle myPageIn, size_t pageSizeIn) {
+	curGroup = 0;
+	curRec = 0;
+	groupSize = 0;
+	pageSize = pageSizeIn;
+	myPage = myPageIn;
+	gotCurrent = true;
+}
+
+MyDB_PaxPageRecIteratorAlt :: MyDB_PaxPageRecIteratorAlt (MyDB_PageHandle myPageIn, size_t pageSizeIn,
+	MyDB_ZoneFilterPtr filterIn, vector <int> &whichAttsIn) {
+	curGroup = 0;
+	curRec = 0;
+	groupSize = 0;
+	pageSize = pageSizeIn;
+	myPage = myPageIn;
+	gotCurrent = true;
+	whichAtts = whichAttsIn;
+
+	// the filter is run over the minipages of each group as we get to it
+	if (filterIn != nullptr && filterIn->canPrune ())
+		filter = filterIn;
+}
+
+MyDB_PaxPageRecIteratorAlt :: ~MyDB_PaxPageRecIteratorAlt () {}
+
+#endif
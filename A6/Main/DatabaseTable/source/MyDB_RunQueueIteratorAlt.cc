@@ -19,14 +19,27 @@
 using namespace std;
 
 void MyDB_RunQueueIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
-	auto myIter = pq.top ();
-	myIter->getCurrent (intoMe);
+	pq.top ().iter->getCurrent (intoMe);
 }
 
 MyDB_RunQueueIteratorAlt :: MyDB_RunQueueIteratorAlt (function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) : 
-	pq (IteratorComparator (comparator, lhs, rhs)) {
+	MyDB_RunQueueIteratorAlt (make_shared <MyDB_KeyNormalizer> (comparator, lhs, rhs)) {}
+
+MyDB_RunQueueIteratorAlt :: MyDB_RunQueueIteratorAlt (MyDB_KeyNormalizerPtr keysIn) : 
+	pq (KeyedIteratorComparator (keysIn)) {
+	keys = keysIn;
 	firstTime = true;
 }
+
+void MyDB_RunQueueIteratorAlt :: addRun (MyDB_RecordIteratorAltPtr addMe) {
+
+	// get the key of the run's current record
+	MyDB_KeyedIterator temp;
+	temp.iter = addMe;
+	addMe->getCurrent (keys->getLHS ());
+	keys->getLHSKey (temp.key);
+	pq.push (temp);
+}
 	
 bool MyDB_RunQueueIteratorAlt :: advance () {
 
@@ -39,18 +52,18 @@ bool MyDB_RunQueueIteratorAlt :: advance () {
 		return false;
 
 	// remove from the q
-	auto myIter = pq.top ();
+	auto myIter = pq.top ().iter;
 	pq.pop ();
 	
-	// re-insert
+	// re-insert, with the key of the run's next record
 	if (myIter->advance ()) 
-		pq.push (myIter);
+		addRun (myIter);
 
 	return (pq.size () != 0);
 }
 
 void *MyDB_RunQueueIteratorAlt :: getCurrentPointer () {
-	return pq.top ()->getCurrentPointer ();
+	return pq.top ().iter->getCurrentPointer ();
 }
 
 MyDB_RunQueueIteratorAlt :: ~MyDB_RunQueueIteratorAlt () {}
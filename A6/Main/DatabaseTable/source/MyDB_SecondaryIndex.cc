@@ -0,0 +1,139 @@
+
+#ifndef SECONDARY_INDEX_C
+#define SECONDARY_INDEX_C
+
+#include "MyDB_IndexFetchIteratorAlt.h"
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_SecondaryIndex.h"
+#include <algorithm>
+#include <ctype.h>
+
+MyDB_TablePtr MyDB_SecondaryIndex :: makeIndexTable (string indexName, string storageLoc, MyDB_TablePtr baseTable,
+	string keyAtt, vector <string> includedAtts) {
+
+	auto res = baseTable->getSchema ()->getAttByName (keyAtt);
+	if (res.first == -1)
+		return nullptr;
+
+	// each entry is the key, the location of the record, and then the included atts
+	MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema> ();
+	mySchema->appendAtt (make_pair (keyAtt, res.second));
+	mySchema->appendAtt (make_pair ("page", make_shared <MyDB_IntAttType> ()));
+	mySchema->appendAtt (make_pair ("slot", make_shared <MyDB_IntAttType> ()));
+	vector <string> seen {keyAtt};
+	for (auto &a : includedAtts) {
+		if (find (seen.begin (), seen.end (), a) != seen.end ())
+			continue;
+		seen.push_back (a);
+		res = baseTable->getSchema ()->getAttByName (a);
+		if (res.first == -1)
+			return nullptr;
+		mySchema->appendAtt (make_pair (a, res.second));
+	}
+
+	MyDB_TablePtr returnVal = make_shared <MyDB_Table> (indexName, storageLoc, mySchema, "bplustree", keyAtt);
+	returnVal->setIndexOf (baseTable->getName ());
+	return returnVal;
+}
+
+MyDB_SecondaryIndex :: MyDB_SecondaryIndex (MyDB_TablePtr indexTable, MyDB_TableReaderWriter &baseTableIn,
+	MyDB_BufferManagerPtr myBuffer) : baseTable (baseTableIn) {
+
+	tree = make_shared <MyDB_BPlusTreeReaderWriter> (indexTable->getSortAtt (), indexTable, myBuffer);
+	whichAtt = baseTable.getTable ()->getSchema ()->getAttByName (indexTable->getSortAtt ()).first;
+	vector <pair <string, MyDB_AttTypePtr>> &atts = indexTable->getSchema ()->getAtts ();
+	for (size_t i = 3; i < atts.size (); i++)
+		includedAtts.push_back (baseTable.getTable ()->getSchema ()->getAttByName (atts[i].first).first);
+	entry = tree->getEmptyRecord ();
+}
+
+size_t MyDB_SecondaryIndex :: build () {
+
+	// write the entries into the index's file as plain pages, and then build the tree over them
+	tree->emptyOut ();
+	MyDB_RecordPtr baseRec = baseTable.getEmptyRecord ();
+	for (int i = 0; i < baseTable.getNumPages (); i++) {
+		MyDB_RecordIteratorAltPtr myIter = baseTable[i].getIteratorAlt ();
+		size_t whichSlot = 0;
+		while (myIter->advance ()) {
+			myIter->getCurrent (baseRec);
+			setEntry (baseRec, i, whichSlot++);
+			tree->MyDB_TableReaderWriter :: append (entry);
+		}
+	}
+
+	pair <vector <size_t>, size_t> res = tree->bulkLoad (*tree, BPLUS_DEFAULT_FILL_FACTOR);
+	tree->getTable ()->setDistinctValues (res.first);
+	tree->getTable ()->setTupleCount (res.second);
+	return res.second;
+}
+
+void MyDB_SecondaryIndex :: add (MyDB_RecordPtr baseRec, int whichPage, size_t whichSlot) {
+	setEntry (baseRec, whichPage, whichSlot);
+	tree->append (entry);
+}
+
+void MyDB_SecondaryIndex :: setEntry (MyDB_RecordPtr baseRec, int whichPage, size_t whichSlot) {
+	entry->getAtt (0)->set (baseRec->getAtt (whichAtt));
+	entry->getAtt (1)->fromInt (whichPage);
+	entry->getAtt (2)->fromInt ((int) whichSlot);
+	for (size_t i = 0; i < includedAtts.size (); i++)
+		entry->getAtt (i + 3)->set (baseRec->getAtt (includedAtts[i]));
+	entry->recordContentHasChanged ();
+}
+
+MyDB_RecordIteratorAltPtr MyDB_SecondaryIndex :: getRangeIteratorAlt (MyDB_AttValPtr low, MyDB_AttValPtr high) {
+
+	// find all of the records in the range, and sort them by location
+	vector <pair <int, size_t>> locations;
+	MyDB_RecordIteratorAltPtr myIter = tree->getRangeIteratorAlt (low, high);
+	while (myIter->advance ()) {
+		myIter->getCurrent (entry);
+		locations.push_back (make_pair (entry->getAtt (1)->toInt (), (size_t) entry->getAtt (2)->toInt ()));
+	}
+	std::sort (locations.begin (), locations.end ());
+
+	return make_shared <MyDB_IndexFetchIteratorAlt> (baseTable, locations);
+}
+
+bool MyDB_SecondaryIndex :: covers (string computation) {
+
+	// the atts are the names in brackets; brackets that come right after a type name (as in
+	// int[5] or string [abc]) hold a literal instead
+	size_t pos = 0;
+	while ((pos = computation.find ('[', pos)) != string :: npos) {
+		size_t end = computation.find (']', pos);
+		if (end == string :: npos)
+			return false;
+		size_t before = pos;
+		while (before > 0 && computation[before - 1] == ' ')
+			before--;
+		if (before == 0 || !isalpha (computation[before - 1])) {
+
+			// the page and the slot are not atts of the table
+			string name = computation.substr (pos + 1, end - pos - 1);
+			vector <pair <string, MyDB_AttTypePtr>> &atts = tree->getTable ()->getSchema ()->getAtts ();
+			size_t which = 0;
+			while (which < atts.size () && atts[which].first != name)
+				which++;
+			if (which == atts.size () || which == 1 || which == 2)
+				return false;
+		}
+		pos = end + 1;
+	}
+	return true;
+}
+
+MyDB_TableReaderWriter &MyDB_SecondaryIndex :: getBaseTable () {
+	return baseTable;
+}
+
+MyDB_BPlusTreeReaderWriterPtr MyDB_SecondaryIndex :: getTree () {
+	return tree;
+}
+
+string &MyDB_SecondaryIndex :: getKeyAtt () {
+	return tree->getTable ()->getSortAtt ();
+}
+
+#endif
@@ -0,0 +1,31 @@
+
+#ifndef SLOTTED_PAGE_REC_ITER_C
+#define SLOTTED_PAGE_REC_ITER_C
+
+#include "MyDB_SlottedPage.h"
+#include "MyDB_SlottedPageRecIterator.h"
+
+void MyDB_SlottedPageRecIterator :: getNext () {
+	void *bytes = myPage->getBytes ();
+ 	myRec->fromBinary (SLOT (bytes, curSlot) + (char *) bytes);
+	curSlot++;
+}
+
+void *MyDB_SlottedPageRecIterator :: getCurrentPointer () {
+	void *bytes = myPage->getBytes ();
+	return SLOT (bytes, curSlot) + (char *) bytes;
+}
+
+bool MyDB_SlottedPageRecIterator :: hasNext () {
+	return curSlot < NUM_SLOTS (myPage->getBytes ());
+}
+
+MyDB_SlottedPageRecIterator :: MyDB_SlottedPageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn) {
+	curSlot = 0;
+	myPage = myPageIn;
+	myRec = myRecIn;
+}
+
+MyDB_SlottedPageRecIterator :: ~MyDB_SlottedPageRecIterator () {}
+
+#endif
@@ -0,0 +1,38 @@
+
+#ifndef SLOTTED_PAGE_REC_ITER_ALT_C
+#define SLOTTED_PAGE_REC_ITER_ALT_C
+
+#include <iostream>
+#include "MyDB_SlottedPage.h"
+#include "MyDB_SlottedPageRecIteratorAlt.h"
+
+void MyDB_SlottedPageRecIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
+	void *bytes = myPage->getBytes ();
+ 	intoMe->fromBinary (SLOT (bytes, curSlot) + (char *) bytes);
+	gotCurrent = true;
+}
+
+void *MyDB_SlottedPageRecIteratorAlt :: getCurrentPointer () {
+	void *bytes = myPage->getBytes ();
+	return SLOT (bytes, curSlot) + (char *) bytes;
+}
+
+bool MyDB_SlottedPageRecIteratorAlt :: advance () {
+	if (!gotCurrent) {
+		cout << "You can't call advance without calling getCurrent!!\n";
+		exit (1);
+	}
+	curSlot++;
+	gotCurrent = false;
+	return curSlot < NUM_SLOTS (myPage->getBytes ());
+}
+
+MyDB_SlottedPageRecIteratorAlt :: MyDB_SlottedPageRecIteratorAlt (MyDB_PageHandle myPageIn) {
+	curSlot = (size_t) -1;
+	myPage = myPageIn;
+	gotCurrent = true;
+}
+
+MyDB_SlottedPageRecIteratorAlt :: ~MyDB_SlottedPageRecIteratorAlt () {}
+
+#endif
@@ -16,7 +16,10 @@
 #include <fstream>
 #include <limits>
 #include <queue>
+#include <random>
+#include "MyDB_BulkLoader.h"
 #include "MyDB_PageReaderWriter.h"
+#include "MyDB_SecondaryIndex.h"
 #include "MyDB_TableRecIterator.h"
 #include "MyDB_TableRecIteratorAlt.h"
 #include "MyDB_TableReaderWriter.h"
@@ -29,6 +32,8 @@ using namespace std;
 MyDB_TableReaderWriter :: MyDB_TableReaderWriter (MyDB_TablePtr forMeIn, MyDB_BufferManagerPtr myBufferIn) {
 	forMe = forMeIn;
 	myBuffer = myBufferIn;
+	keepsZones = true;
+	numOnLastPage = -1;
 
 	if (forMe->lastPage () == -1) {
 		forMe->setLastPage (0);
@@ -47,11 +52,19 @@ MyDB_TablePtr MyDB_TableReaderWriter :: getTable () {
 	return forMe;
 }
 
+MyDB_ZoneMapPtr MyDB_TableReaderWriter :: getZoneMap () {
+	if (!keepsZones)
+		return nullptr;
+	return forMe->getZoneMap ();
+}
+
 int MyDB_TableReaderWriter :: getNumPages () {
 	return forMe->lastPage () + 1;
 }
 
 MyDB_PageReaderWriter MyDB_TableReaderWriter :: getPinned (size_t i) {
+	if ((int) i >= forMe->lastPage ())
+		numOnLastPage = -1;
 	return MyDB_PageReaderWriter (true, *this, i);
 }
 
@@ -64,6 +77,10 @@ MyDB_PageReaderWriter MyDB_TableReaderWriter :: operator [] (size_t i) {
 		lastPage->clear ();	
 	}
 
+	// the last page may be written through the page that is returned, so its records are counted again
+	if ((int) i == forMe->lastPage ())
+		numOnLastPage = -1;
+
 	// now get the page
 	MyDB_PageReaderWriter arrayAccessBuffer (*this, i);
 	return arrayAccessBuffer;
@@ -80,8 +97,25 @@ MyDB_PageReaderWriter MyDB_TableReaderWriter :: last () {
 	return arrayAccessBuffer;
 }
 
+void MyDB_TableReaderWriter :: updateStats (MyDB_RecordPtr fromMe) {
+	int numAtts = forMe->getSchema ()->getAtts ().size ();
+	for (int i = 0; i < numAtts; i++)
+		forMe->getSketch (i).add (fromMe->getAtt (i)->hash ());
+	forMe->setTupleCount (forMe->getTupleCount () + 1);
+}
+
+vector <size_t> MyDB_TableReaderWriter :: getDistinctValues () {
+	vector <size_t> returnVal;
+	int numAtts = forMe->getSchema ()->getAtts ().size ();
+	for (int i = 0; i < numAtts; i++)
+		returnVal.push_back (forMe->getSketch (i).estimate ());
+	return returnVal;
+}
+
 void MyDB_TableReaderWriter :: append (MyDB_RecordPtr appendMe) {
 
+	updateStats (appendMe);
+
 	// try to append the record on the current page...
 	if (!lastPage->append (appendMe)) {
 
@@ -90,15 +124,52 @@ void MyDB_TableReaderWriter :: append (MyDB_RecordPtr appendMe) {
 		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
 		lastPage->clear ();
 		lastPage->append (appendMe);
+		numOnLastPage = 0;
 	}
+
+	// counting the records on a packed page means going through all of them, so the count is
+	// only done when it is not known, and is otherwise kept up to date here
+	if (numOnLastPage < 0)
+		numOnLastPage = lastPage->getNumRecords ();
+	else
+		numOnLastPage++;
+
+	// the record is the last one on the last page
+	for (auto &a : indexes)
+		a->add (appendMe, forMe->lastPage (), numOnLastPage - 1);
 }
 
-pair <vector <size_t>, size_t>  MyDB_TableReaderWriter :: loadFromTextFile (string fName) {
+void MyDB_TableReaderWriter :: addIndex (MyDB_SecondaryIndexPtr addMe) {
+	indexes.push_back (addMe);
+}
 
-	// empty out the database file
+vector <MyDB_SecondaryIndexPtr> &MyDB_TableReaderWriter :: getIndexes () {
+	return indexes;
+}
+
+void MyDB_TableReaderWriter :: emptyOut () {
+	if (getZoneMap () != nullptr)
+		getZoneMap ()->clear ();
 	forMe->setLastPage (0);
 	lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
 	lastPage->clear ();
+	numOnLastPage = 0;
+	forMe->clearStats ();
+}
+
+void MyDB_TableReaderWriter :: rebuildIndexes () {
+	for (auto &a : indexes)
+		a->build ();
+}
+
+pair <vector <size_t>, size_t>  MyDB_TableReaderWriter :: loadFromTextFile (string fName) {
+
+	// empty out the database file; the statistics are rebuilt as the records are appended
+	emptyOut ();
+
+	// the indexes are rebuilt at the end, rather than adding to them one record at a time
+	vector <MyDB_SecondaryIndexPtr> myIndexes;
+	myIndexes.swap (indexes);
 
 	// try to open the file
 	string line;
@@ -106,14 +177,6 @@ pair <vector <size_t>, size_t>  MyDB_TableReaderWriter :: loadFromTextFile (stri
 
 	MyDB_RecordPtr tempRec = getEmptyRecord ();
 
-	// this data structure is used for apporoximate counting of the number of distinct
-	// values of each attribute
-	vector <pair <set <size_t>, int>> allHashes;
-	for (int i = 0; i < tempRec->getSchema ()->getAtts ().size (); i++) {
-		set <size_t> temp1;
-		allHashes.push_back (make_pair (temp1, 1));
-	}
-
 	// if we opened it, read the contents
 	size_t counter = 0;
 	if (myfile.is_open()) {
@@ -122,43 +185,98 @@ pair <vector <size_t>, size_t>  MyDB_TableReaderWriter :: loadFromTextFile (stri
 		while (getline (myfile,line)) {
 			tempRec->fromString (line);		
 			counter++;
-			// hash all of the attributes... this is used for counting
-			int i = 0;
-			for (auto &a : allHashes) {
-
-				// insert the hash
-				size_t hash = tempRec->getAtt (i)->hash ();
-				i++;
-				if (hash % a.second != 0)
-					continue;
-
-				a.first.insert (hash);
-
-				// if we have too many items, compact them
-				#define MAX_SIZE 1000
-				if (a.first.size () > MAX_SIZE) {
-					a.second *= 2;
-					set <size_t> newSet;
-					for (auto &num : a.first) {
-						if (num % a.second == 0)
-							newSet.insert (num);
-					}
-					a.first = newSet;	
-				}
-			}
 			append (tempRec);
 		}
 		myfile.close ();
 	}
 	cout << "Loaded " << counter << " records.\n";
+	indexes.swap (myIndexes);
+	rebuildIndexes ();
 
-	// finally, compute the vector of estimates
-	vector <size_t> returnVal;
-	for (auto &a : allHashes) {
-		size_t est = ((size_t) a.first.size ()) * a.second;
-		returnVal.push_back (est);
+	// finally, get the vector of estimates from the sketches
+	return make_pair (getDistinctValues (), counter);
+}
+
+pair <vector <size_t>, size_t>  MyDB_TableReaderWriter :: bulkLoadFromTextFile (string fName, int numThreads) {
+
+	// the bulk loader only builds packed pages
+	if (forMe->hasSlottedPages () || forMe->hasPaxPages ())
+		return loadFromTextFile (fName);
+
+	// empty out the database file
+	emptyOut ();
+
+	// and let the loader fill it up; it writes the pages itself, so the indexes are rebuilt after
+	MyDB_BulkLoader myLoader (forMe->getSchema (), myBuffer->getPageSize (), numThreads);
+	pair <vector <size_t>, size_t> res = myLoader.load (fName, *this);
+	rebuildIndexes ();
+	return res;
+}
+
+// compares two attribute values of the given type
+static bool lessThan (MyDB_AttValPtr lhs, MyDB_AttValPtr rhs, MyDB_AttTypePtr type) {
+	if (type->promotableToDouble ())
+		return lhs->toDouble () < rhs->toDouble ();
+	return lhs->toString () < rhs->toString ();
+}
+
+void MyDB_TableReaderWriter :: analyze (size_t sampleSize) {
+
+	MyDB_RecordPtr tempRec = getEmptyRecord ();
+	vector <pair <string, MyDB_AttTypePtr>> &allAtts = forMe->getSchema ()->getAtts ();
+	size_t numAtts = allAtts.size ();
+
+	// the statistics are rebuilt as we scan
+	forMe->clearStats ();
+
+	// this is the reservoir sample, one vector of values per attribute, and the extremes
+	vector <vector <string>> sample (numAtts);
+	vector <MyDB_AttValPtr> minVals (numAtts), maxVals (numAtts);
+	mt19937 generator (sampleSize);
+
+	size_t counter = 0;
+	MyDB_RecordIteratorAltPtr myIter = getIteratorAlt ();
+	while (myIter->advance ()) {
+		myIter->getCurrent (tempRec);
+		updateStats (tempRec);
+		counter++;
+
+		// see if this record goes in the sample, and where
+		size_t where = counter - 1;
+		if (counter > sampleSize)
+			where = uniform_int_distribution <size_t> (0, counter - 1) (generator);
+
+		for (size_t i = 0; i < numAtts; i++) {
+			MyDB_AttValPtr att = tempRec->getAtt (i);
+
+			// update the min and the max
+			if (minVals[i] == nullptr) {
+				minVals[i] = allAtts[i].second->createAtt ();
+				maxVals[i] = allAtts[i].second->createAtt ();
+				minVals[i]->set (att);
+				maxVals[i]->set (att);
+			} else if (lessThan (att, minVals[i], allAtts[i].second)) {
+				minVals[i]->set (att);
+			} else if (lessThan (maxVals[i], att, allAtts[i].second)) {
+				maxVals[i]->set (att);
+			}
+
+			if (counter <= sampleSize)
+				sample[i].push_back (att->toString ());
+			else if (where < sampleSize)
+				sample[i][where] = att->toString ();
+		}
 	}
-	return make_pair (returnVal, counter);
+
+	// now build the stats
+	vector <MyDB_ColumnStats> allStats (numAtts);
+	for (size_t i = 0; i < numAtts; i++) {
+		string minVal = minVals[i] == nullptr ? "" : minVals[i]->toString ();
+		string maxVal = maxVals[i] == nullptr ? "" : maxVals[i]->toString ();
+		allStats[i].build (sample[i], minVal, maxVal, counter, forMe->getDistinctValues ((int) i),
+			allAtts[i].second->promotableToDouble ());
+	}
+	forMe->setColumnStats (allStats);
 }
 
 MyDB_RecordIteratorPtr MyDB_TableReaderWriter :: getIterator (MyDB_RecordPtr iterateIntoMe) {
@@ -173,6 +291,14 @@ MyDB_RecordIteratorAltPtr MyDB_TableReaderWriter :: getIteratorAlt (int lowPage,
 	return make_shared <MyDB_TableRecIteratorAlt> (*this, forMe, lowPage, highPage);
 }
 
+MyDB_RecordIteratorAltPtr MyDB_TableReaderWriter :: getIteratorAlt (MyDB_ZoneFilterPtr filter) {
+	return make_shared <MyDB_TableRecIteratorAlt> (*this, forMe, filter);
+}
+
+MyDB_RecordIteratorAltPtr MyDB_TableReaderWriter :: getIteratorAlt (MyDB_ZoneFilterPtr filter, vector <int> &whichAtts) {
+	return make_shared <MyDB_TableRecIteratorAlt> (*this, forMe, filter, whichAtts);
+}
+
 void MyDB_TableReaderWriter :: writeIntoTextFile (string fName) {
 	
 	// open up the output file
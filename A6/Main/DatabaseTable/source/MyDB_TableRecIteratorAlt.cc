@@ -26,15 +26,24 @@ void *MyDB_TableRecIteratorAlt :: getCurrentPointer () {
 
 bool MyDB_TableRecIteratorAlt :: advance () {
 
-	if (myParent[curPage].getType () == MyDB_PageType :: RegularPage && myIter->advance ())
-		return true;
+	// this is a loop, since any number of pages in a row may be skipped
+	while (true) {
+		if (myIter != nullptr && myParent[curPage].getType () == MyDB_PageType :: RegularPage && myIter->advance ())
+			return true;
 
-	if (curPage == myTable->lastPage () || curPage == highPage)
-		return false;
+		if (curPage == myTable->lastPage () || curPage == highPage)
+			return false;
 
-	curPage++;
-	myIter = myParent[curPage].getIteratorAlt ();
-	return advance ();
+		curPage++;
+		startPage ();
+	}
+}
+
+void MyDB_TableRecIteratorAlt :: startPage () {
+	if (filter != nullptr && filter->canSkip (curPage))
+		myIter = nullptr;
+	else
+		myIter = myParent[curPage].getIteratorAlt (checkRecords ? filter : nullptr, whichAtts);
 }
 
 MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn,
@@ -43,14 +52,39 @@ MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &my
 	myTable = myTableIn;
 	curPage = lowPage;
 	highPage = highPageIn;
+	checkRecords = false;
 	myIter = myParent[curPage].getIteratorAlt ();		
 }
 
+MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn,
+	MyDB_ZoneFilterPtr filterIn) :
+	myParent (myParent) {
+	myTable = myTableIn;
+	curPage = 0;
+	highPage = 1999999999;
+	filter = filterIn;
+	checkRecords = false;
+	startPage ();
+}
+
+MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn,
+	MyDB_ZoneFilterPtr filterIn, vector <int> &whichAttsIn) :
+	myParent (myParent) {
+	myTable = myTableIn;
+	curPage = 0;
+	highPage = 1999999999;
+	filter = filterIn;
+	checkRecords = true;
+	whichAtts = whichAttsIn;
+	startPage ();
+}
+
 MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn) :
 	myParent (myParent) {
 	myTable = myTableIn;
 	curPage = 0;
 	highPage = 1999999999;
+	checkRecords = false;
 	myIter = myParent[curPage].getIteratorAlt ();		
 }
 
@@ -0,0 +1,223 @@
+
+#ifndef ZONE_FILTER_C
+#define ZONE_FILTER_C
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MyDB_ZoneFilter.h"
+
+MyDB_ZoneFilter :: MyDB_ZoneFilter (string predicate, MyDB_TablePtr forMe) {
+	myTable = forMe;
+	zones = forMe->getZoneMap ();
+	pagesRead = 0;
+	pagesSkipped = 0;
+
+	// a predicate that we cannot understand gives no checks at all
+	size_t pos = 0;
+	Term result;
+	if (!parse (predicate, pos, true, result))
+		checks.clear ();
+}
+
+static void skipSpace (const string &predicate, size_t &pos) {
+	while (pos < predicate.size () && isspace (predicate[pos]))
+		pos++;
+}
+
+bool MyDB_ZoneFilter :: parse (const string &predicate, size_t &pos, bool mustHold, Term &result) {
+
+	skipSpace (predicate, pos);
+	if (pos >= predicate.size ())
+		return false;
+
+	// an attribute
+	if (predicate[pos] == '[') {
+		size_t end = predicate.find (']', pos);
+		if (end == string :: npos)
+			return false;
+		result.kind = Term :: Att;
+		result.text = predicate.substr (pos + 1, end - pos - 1);
+		pos = end + 1;
+		return true;
+	}
+
+	// a literal
+	static const char *literals[] = {"int", "double", "bool", "string"};
+	for (int i = 0; i < 4; i++) {
+		size_t len = string (literals[i]).size ();
+		if (predicate.compare (pos, len, literals[i]) != 0)
+			continue;
+		size_t start = predicate.find ('[', pos);
+		size_t end = predicate.find (']', start);
+		if (start == string :: npos || end == string :: npos)
+			return false;
+		result.text = predicate.substr (start + 1, end - start - 1);
+		if (i < 2) {
+			result.kind = Term :: Number;
+			result.numVal = strtod (result.text.c_str (), nullptr);
+		} else {
+			result.kind = i == 2 ? Term :: Other : Term :: String;
+		}
+		pos = end + 1;
+		return true;
+	}
+
+	// otherwise, this is an operation, followed by its arguments in parens
+	size_t start = predicate.find ('(', pos);
+	if (start == string :: npos)
+		return false;
+	string op = predicate.substr (pos, start - pos);
+	while (op.size () > 0 && isspace (op.back ()))
+		op.pop_back ();
+	pos = start + 1;
+
+	// the arguments of an "and" must hold if the "and" must hold; for anything else,
+	// we know nothing about the arguments
+	bool argsMustHold = mustHold && op == "&&";
+	vector <Term> args;
+	while (true) {
+		args.emplace_back ();
+		if (!parse (predicate, pos, argsMustHold, args.back ()))
+			return false;
+		skipSpace (predicate, pos);
+		if (pos >= predicate.size ())
+			return false;
+		if (predicate[pos++] == ')')
+			break;
+	}
+
+	if (mustHold && args.size () == 2)
+		addCheck (args[0], op, args[1]);
+	result.kind = Term :: Other;
+	return true;
+}
+
+void MyDB_ZoneFilter :: addCheck (Term &lhs, string op, Term &rhs) {
+
+	// get the comparison, with the attribute on the left
+	MyDB_CompOp compOp;
+	bool flip = false;
+	if (lhs.kind != Term :: Att) {
+		if (rhs.kind != Term :: Att)
+			return;
+		flip = true;
+	}
+
+	if (op == "==")
+		compOp = MyDB_CompOp :: Equals;
+	else if (op == "!=")
+		compOp = MyDB_CompOp :: NotEquals;
+	else if (op == "<")
+		compOp = flip ? MyDB_CompOp :: GreaterThan : MyDB_CompOp :: LessThan;
+	else if (op == ">")
+		compOp = flip ? MyDB_CompOp :: LessThan : MyDB_CompOp :: GreaterThan;
+	else
+		return;
+
+	Term &att = flip ? rhs : lhs;
+	Term &val = flip ? lhs : rhs;
+	int whichAtt = myTable->getSchema ()->getAttByName (att.text).first;
+	if (whichAtt == -1 || zones == nullptr)
+		return;
+
+	// the attribute must be compared with a literal of a matching kind
+	Check check;
+	check.whichAtt = whichAtt;
+	check.op = compOp;
+	if (zones->getKind (whichAtt) == ZoneNumeric && val.kind == Term :: Number) {
+		check.numeric = true;
+		check.numVal = val.numVal;
+	} else if (zones->getKind (whichAtt) == ZoneString && val.kind == Term :: String) {
+		check.numeric = false;
+		check.strVal = val.text;
+	} else {
+		return;
+	}
+	checks.push_back (check);
+}
+
+bool MyDB_ZoneFilter :: canSkip (int whichPage) {
+
+	if (canPrune ()) {
+		MyDB_PageZone &zone = zones->getZone (whichPage);
+		for (auto &c : checks) {
+			bool mayMatch = c.numeric ? zone.mayMatch (c.whichAtt, c.op, c.numVal) :
+				zone.mayMatch (c.whichAtt, c.op, c.strVal);
+			if (!mayMatch) {
+				pagesSkipped++;
+				return true;
+			}
+		}
+	}
+
+	pagesRead++;
+	return false;
+}
+
+// clears matches[i] for each of the values that fails "value op val"; the loops are kept simple
+// so that the compiler can vectorize them
+template <class T>
+static void markNumeric (T *vals, size_t numVals, MyDB_CompOp op, double val, char *matches) {
+	switch (op) {
+	case MyDB_CompOp :: Equals:
+		for (size_t i = 0; i < numVals; i++)
+			matches[i] &= (vals[i] == val);
+		break;
+	case MyDB_CompOp :: NotEquals:
+		for (size_t i = 0; i < numVals; i++)
+			matches[i] &= (vals[i] != val);
+		break;
+	case MyDB_CompOp :: LessThan:
+		for (size_t i = 0; i < numVals; i++)
+			matches[i] &= (vals[i] < val);
+		break;
+	case MyDB_CompOp :: GreaterThan:
+		for (size_t i = 0; i < numVals; i++)
+			matches[i] &= (vals[i] > val);
+		break;
+	default:
+		break;
+	}
+}
+
+void MyDB_ZoneFilter :: markMatches (MyDB_PaxPage &page, size_t whichGroup, vector <char> &matches) {
+
+	size_t numRecs = page.getGroupSize (whichGroup);
+	matches.assign (numRecs, 1);
+	for (auto &c : checks) {
+		MyDB_PaxColumn column = page.getColumn (whichGroup, c.whichAtt, columnBuffer);
+		if (c.numeric && column.kind == PaxInt) {
+			markNumeric (column.getInts (), numRecs, c.op, c.numVal, matches.data ());
+		} else if (c.numeric && column.kind == PaxDouble) {
+			markNumeric (column.getDoubles (), numRecs, c.op, c.numVal, matches.data ());
+		} else if (!c.numeric && column.kind == PaxString) {
+			const char *val = c.strVal.c_str ();
+			for (size_t i = 0; i < numRecs; i++) {
+				int res = strcmp (column.getString (i), val);
+				if (c.op == MyDB_CompOp :: Equals)
+					matches[i] &= (res == 0);
+				else if (c.op == MyDB_CompOp :: NotEquals)
+					matches[i] &= (res != 0);
+				else if (c.op == MyDB_CompOp :: LessThan)
+					matches[i] &= (res < 0);
+				else if (c.op == MyDB_CompOp :: GreaterThan)
+					matches[i] &= (res > 0);
+			}
+		}
+	}
+}
+
+bool MyDB_ZoneFilter :: canPrune () {
+	return zones != nullptr && checks.size () > 0;
+}
+
+size_t MyDB_ZoneFilter :: getPagesRead () {
+	return pagesRead;
+}
+
+size_t MyDB_ZoneFilter :: getPagesSkipped () {
+	return pagesSkipped;
+}
+
+#endif
@@ -2,13 +2,20 @@
 #ifndef SORT_C
 #define SORT_C
 
+#include <algorithm>
+#include <cstring>
 #include <queue>
+#include <stdlib.h>
+#include <thread>
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_TableRecIterator.h"
 #include "MyDB_TableRecIteratorAlt.h"
 #include "MyDB_TableReaderWriter.h"
 #include "MyDB_RunQueueIteratorAlt.h"
+#include "MyDB_LoserTreeIteratorAlt.h"
 #include "IteratorComparator.h"
+#include "MyDB_SlottedPage.h"
+#include "RecordComparator.h"
 #include "Sorting.h"
 
 using namespace std;
@@ -29,7 +36,15 @@ void appendRecord (MyDB_PageReaderWriter &curPage, vector <MyDB_PageReaderWriter
 
 vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB_RecordIteratorAltPtr leftIter, 
 	MyDB_RecordIteratorAltPtr rightIter, function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
+	return mergeIntoList (parent, leftIter, rightIter, make_shared <MyDB_KeyNormalizer> (comparator, lhs, rhs));
+}
+
+vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB_RecordIteratorAltPtr leftIter, 
+	MyDB_RecordIteratorAltPtr rightIter, MyDB_KeyNormalizerPtr keys) {
 	
+	MyDB_RecordPtr lhs = keys->getLHS ();
+	MyDB_RecordPtr rhs = keys->getRHS ();
+	MyDB_NormalizedKey lhsKey, rhsKey;
 	vector <MyDB_PageReaderWriter> returnVal;
 	MyDB_PageReaderWriter curPage (*parent);
 	bool lhsLoaded = false, rhsLoaded = false;
@@ -53,16 +68,21 @@ vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB
 			// here's a bit of an optimization... if one of the records is loaded, don't re-load
 			if (!lhsLoaded) {
 				leftIter->getCurrent (lhs);
+				keys->getLHSKey (lhsKey);
 				lhsLoaded = true;
 			}
 
 			if (!rhsLoaded) {
 				rightIter->getCurrent (rhs);		
+				keys->getRHSKey (rhsKey);
 				rhsLoaded = true;
 			}
 	
-			// see if the lhs is less
-			if (comparator ()) {
+			// see if the lhs is less; the keys usually tell us, but if not, compare the records
+			bool isLess;
+			if (!MyDB_KeyNormalizer :: keysDecide (lhsKey, rhsKey, isLess))
+				isLess = keys->compare ();
+			if (isLess) {
 				appendRecord (curPage, returnVal, lhs, parent);
 				lhsLoaded = false;
 
@@ -98,6 +118,29 @@ vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB
 	// outta here!
 	return returnVal;
 }
+
+vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, vector <MyDB_RecordIteratorAltPtr> &iters,
+	MyDB_KeyNormalizerPtr keys) {
+
+	vector <MyDB_PageReaderWriter> returnVal;
+	MyDB_PageReaderWriter curPage (*parent);
+
+	// put all of the non-empty lists into a loser tree, and then just drain it
+	MyDB_LoserTreeIteratorAlt tree (keys);
+	for (auto &iter : iters) {
+		if (iter->advance ())
+			tree.addRun (iter);
+	}
+
+	MyDB_RecordPtr rec = keys->getLHS ();
+	while (tree.advance ()) {
+		tree.getCurrent (rec);
+		appendRecord (curPage, returnVal, rec, parent);
+	}
+
+	returnVal.push_back (curPage);
+	return returnVal;
+}
 	
 MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe, 
 	function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
@@ -108,6 +151,426 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe, 
 	function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs, string lhsPred) {
 
+	return buildItertorOverSortedRuns (runSize, sortMe, make_shared <MyDB_KeyNormalizer> (comparator, lhs, rhs), lhsPred);
+}
+
+MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe, 
+	MyDB_KeyNormalizerPtr keys) {
+
+	return buildItertorOverSortedRuns (runSize, sortMe, keys, "bool[true]");
+}
+
+MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe, 
+	MyDB_KeyNormalizerPtr keys, string lhsPred) {
+
+	return buildItertorOverSortedRuns (runSize, sortMe, keys, lhsPred, MyDB_MergeKind :: LoserTree, 1, 
+		MyDB_RunKind :: SortPages);
+}
+
+MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe, 
+	MyDB_KeyNormalizerPtr keys, string lhsPred, int numThreads) {
+
+	return buildItertorOverSortedRuns (runSize, sortMe, keys, lhsPred, MyDB_MergeKind :: LoserTree, numThreads, 
+		MyDB_RunKind :: SortPages);
+}
+
+// one worker's share of a batch of pages that are being sorted into a run: the records that pass
+// the predicate, in sorted order (along with their keys), their sizes, the PAX rows that some of
+// them are stored in, and the first record on each page of the run
+struct SortedShare {
+	vector <pair <MyDB_NormalizedKey, void *>> positions;
+	vector <size_t> sizes;
+	vector <vector <char>> rows;
+	vector <size_t> pageStarts;
+};
+
+// run by a worker thread: sorts all of the records on the pinned page images that pass the
+// predicate (if there is one), and works out which of them go on each packed page of the run
+static void sortShare (vector <void *> &inPages, size_t pageSize, MyDB_KeyNormalizerPtr keys, func pred,
+	bool skipPred, SortedShare &share) {
+
+	MyDB_RecordPtr lhs = keys->getLHS ();
+
+	// get the keys of all of the records; the PAX rows need to stay where they are
+	vector <pair <MyDB_NormalizedKey, void *>> pagePositions;
+	share.rows.resize (inPages.size ());
+	for (size_t i = 0; i < inPages.size (); i++) {
+		pagePositions.clear ();
+		MyDB_PageReaderWriter :: getKeys (inPages[i], pageSize, keys, pagePositions, share.rows[i]);
+		for (auto &pos : pagePositions) {
+			if (!skipPred) {
+				lhs->fromBinary (pos.second);
+				if (!pred ()->toBool ())
+					continue;
+			}
+			share.positions.push_back (pos);
+		}
+	}
+
+	// sorting all of them at once is the same as sorting the pages and merging them
+	keys->sort (share.positions);
+
+	// and lay them out on pages
+	size_t bytesUsed = pageSize;
+	for (size_t i = 0; i < share.positions.size (); i++) {
+		void *pos = share.positions[i].second;
+		size_t recSize = ((char *) lhs->fromBinary (pos)) - ((char *) pos);
+		if (bytesUsed + recSize > pageSize) {
+			share.pageStarts.push_back (i);
+			bytesUsed = PACKED_HEADER_SIZE;
+		}
+		share.sizes.push_back (recSize);
+		bytesUsed += recSize;
+	}
+}
+
+// run by a worker thread: copies the sorted records into the (pinned, empty) packed pages of the run
+static void writeShare (SortedShare &share, vector <void *> &outPages) {
+	for (size_t page = 0; page < outPages.size (); page++) {
+		char *bytes = (char *) outPages[page];
+		size_t last = (page + 1 < share.pageStarts.size ()) ? share.pageStarts[page + 1] : share.positions.size ();
+		for (size_t i = share.pageStarts[page]; i < last; i++) {
+			memcpy (bytes + PACKED_BYTES_USED (bytes), share.positions[i].second, share.sizes[i]);
+			PACKED_BYTES_USED (bytes) += share.sizes[i];
+		}
+	}
+}
+
+// builds the sorted runs of sortMe using numThreads worker threads, and adds them to runs
+static void buildRunsInParallel (int runSize, MyDB_TableReaderWriter &sortMe, vector <MyDB_KeyNormalizerPtr> &workerKeys, 
+	string lhsPred, vector <vector <MyDB_PageReaderWriter>> &runs) {
+
+	int numThreads = workerKeys.size ();
+	bool skipPred = (lhsPred == "bool[true]");
+	vector <func> preds;
+	for (auto &k : workerKeys)
+		preds.push_back (k->getLHS ()->compileComputation (lhsPred));
+
+	// the pages of the input and of the runs made from them are both pinned while the workers
+	// write the runs, so only half of the run's pages are read at a time; each worker gets an
+	// equal share of them
+	int perThread = runSize / (2 * numThreads);
+	if (perThread < 1)
+		perThread = 1;
+
+	MyDB_BufferManagerPtr parent = sortMe.getBufferMgr ();
+	size_t pageSize = parent->getPageSize ();
+	int numPages = sortMe.getNumPages ();
+	for (int nextPage = 0; nextPage < numPages;) {
+
+		// pin the next pages, and give them to the workers
+		vector <MyDB_PageReaderWriter> pinned;
+		vector <vector <void *>> inPages (numThreads);
+		for (int t = 0; t < numThreads && nextPage < numPages; t++) {
+			for (int i = 0; i < perThread && nextPage < numPages; i++, nextPage++) {
+				MyDB_PageReaderWriter page (true, sortMe, nextPage);
+				if (page.getType () != MyDB_PageType :: RegularPage)
+					continue;
+				pinned.push_back (page);
+				inPages[t].push_back (page.getBytes ());
+			}
+		}
+
+		// the workers sort their pages...
+		vector <SortedShare> shares (numThreads);
+		vector <thread> workers;
+		for (int t = 0; t < numThreads; t++) {
+			if (inPages[t].size () == 0)
+				continue;
+			workers.push_back (thread ([t, pageSize, skipPred, &inPages, &workerKeys, &preds, &shares] {
+				sortShare (inPages[t], pageSize, workerKeys[t], preds[t], skipPred, shares[t]);
+			}));
+		}
+		for (auto &w : workers)
+			w.join ();
+
+		// ...then, since they cannot use the buffer manager, they are given pinned anonymous pages
+		// to write their runs into...
+		vector <vector <MyDB_PageReaderWriter>> newRuns (numThreads);
+		vector <vector <void *>> outPages (numThreads);
+		for (int t = 0; t < numThreads; t++) {
+			for (size_t i = 0; i < shares[t].pageStarts.size (); i++) {
+				MyDB_PageReaderWriter page (true, *parent);
+				newRuns[t].push_back (page);
+				outPages[t].push_back (page.getBytes ());
+			}
+		}
+		workers.clear ();
+		for (int t = 0; t < numThreads; t++) {
+			if (outPages[t].size () == 0)
+				continue;
+			workers.push_back (thread ([t, &shares, &outPages] {
+				writeShare (shares[t], outPages[t]);
+			}));
+		}
+		for (auto &w : workers)
+			w.join ();
+
+		// ...which can be written out of the buffer once the runs are done
+		for (int t = 0; t < numThreads; t++) {
+			if (newRuns[t].size () == 0)
+				continue;
+			for (auto &page : newRuns[t])
+				page.unpin ();
+			runs.push_back (newRuns[t]);
+		}
+	}
+}
+
+// each run being merged is read MERGE_READ_AHEAD pages at a time, as long as that still lets at
+// least MIN_FAN_IN runs be merged at once
+#define MERGE_READ_AHEAD 8
+#define MIN_FAN_IN 16
+
+// works out how many pages of each run to read at a time, and how many runs can be merged at once,
+// so that the merge uses about runSize pages (one of which is for the output)
+static void planMerge (int runSize, int &readAhead, int &fanIn) {
+	readAhead = runSize / MIN_FAN_IN;
+	if (readAhead > MERGE_READ_AHEAD)
+		readAhead = MERGE_READ_AHEAD;
+	if (readAhead < 1)
+		readAhead = 1;
+	fanIn = (runSize - 1) / readAhead;
+	if (fanIn < 2)
+		fanIn = 2;
+}
+
+// the pages that the replacement selection heap is stored in are compacted once at least
+// 1/REPLACEMENT_SLACK of their bytes belong to records that have already been written out
+#define REPLACEMENT_SLACK 8
+
+// one record in the replacement selection heap: the run it goes into, its key, and where it is
+struct ReplacementEntry {
+	size_t run;
+	MyDB_NormalizedKey key;
+	size_t page;
+	size_t offset;
+	size_t size;
+};
+
+vector <vector <MyDB_PageReaderWriter>> replacementSelection (int runSize, MyDB_TableReaderWriter &sortMe,
+	MyDB_KeyNormalizerPtr keys, string lhsPred) {
+
+	MyDB_RecordPtr lhs = keys->getLHS ();
+	MyDB_RecordPtr rhs = keys->getRHS ();
+	MyDB_BufferManagerPtr parent = sortMe.getBufferMgr ();
+	bool skipPred = (lhsPred == "bool[true]");
+	func pred = lhs->compileComputation (lhsPred);
+
+	// the records in the heap are stored one after another in runSize pinned pages (at least two,
+	// so that the last record written out and a new one always fit)
+	size_t pageSize = parent->getPageSize ();
+	vector <MyDB_PageReaderWriter> space;
+	vector <char *> spaceBytes;
+	for (int i = 0; i < (runSize < 2 ? 2 : runSize); i++) {
+		space.push_back (MyDB_PageReaderWriter (true, *parent));
+		spaceBytes.push_back ((char *) space.back ().getBytes ());
+	}
+	size_t curSpacePage = 0;
+	size_t curSpacePos = 0;
+	size_t deadBytes = 0;
+
+	// finds room for the entry's record after the last one stored; returns false if there is none
+	auto allocate = [&] (ReplacementEntry &entry) {
+		if (curSpacePos + entry.size > pageSize) {
+			if (curSpacePage + 1 == spaceBytes.size ())
+				return false;
+			curSpacePage++;
+			curSpacePos = 0;
+		}
+		entry.page = curSpacePage;
+		entry.offset = curSpacePos;
+		curSpacePos += entry.size;
+		return true;
+	};
+	auto location = [&] (const ReplacementEntry &entry) {
+		return (void *) (spaceBytes[entry.page] + entry.offset);
+	};
+
+	// returns true if the lhs record comes before the rhs one
+	auto recLess = [&] (const ReplacementEntry &lhsEntry, const ReplacementEntry &rhsEntry) {
+		bool isLess;
+		if (MyDB_KeyNormalizer :: keysDecide (lhsEntry.key, rhsEntry.key, isLess))
+			return isLess;
+		lhs->fromBinary (location (lhsEntry));
+		rhs->fromBinary (location (rhsEntry));
+		return keys->compare ();
+	};
+
+	// the heap puts the largest item on top, so this returns true if rhs comes first
+	auto entryComp = [&] (const ReplacementEntry &lhsEntry, const ReplacementEntry &rhsEntry) {
+		if (lhsEntry.run != rhsEntry.run)
+			return rhsEntry.run < lhsEntry.run;
+		return recLess (rhsEntry, lhsEntry);
+	};
+	vector <ReplacementEntry> heap;
+
+	// the last record written out stays where it is, so that new records can be checked against it
+	ReplacementEntry last;
+	bool haveLast = false;
+
+	// slides the records that are still needed (the ones in the heap and the last one written out)
+	// down to the front of the pages, keeping them in the same order, so that the space of the
+	// others can be used again.  No record moves past where it was, so none is overwritten
+	auto compact = [&] () {
+		vector <ReplacementEntry *> live;
+		for (auto &entry : heap)
+			live.push_back (&entry);
+		if (haveLast)
+			live.push_back (&last);
+		sort (live.begin (), live.end (), [] (ReplacementEntry *lhsEntry, ReplacementEntry *rhsEntry) {
+			return lhsEntry->page < rhsEntry->page || 
+				(lhsEntry->page == rhsEntry->page && lhsEntry->offset < rhsEntry->offset);
+		});
+		curSpacePage = 0;
+		curSpacePos = 0;
+		for (auto entry : live) {
+			void *from = location (*entry);
+			allocate (*entry);
+			memmove (location (*entry), from, entry->size);
+		}
+		deadBytes = 0;
+	};
+
+	vector <vector <MyDB_PageReaderWriter>> runs;
+	vector <MyDB_PageReaderWriter> curRun;
+	MyDB_PageReaderWriter curPage (*parent);
+	size_t curRunNum = 0;
+
+	MyDB_RecordIteratorAltPtr input = sortMe.getIteratorAlt ();
+	bool inputLeft = input->advance ();
+	while (true) {
+
+		// fill the heap up with as many input records as fit; the input is only advanced
+		// past a record once it is in the heap
+		while (inputLeft) {
+
+			input->getCurrent (lhs);
+			if (!skipPred && !pred ()->toBool ()) {
+				inputLeft = input->advance ();
+				continue;
+			}
+
+			// the record does not fit after the others, so either make room by compacting the pages,
+			// or write something out first (there is always room once the heap is empty)
+			ReplacementEntry entry;
+			entry.size = lhs->getBinarySize ();
+			if (!allocate (entry)) {
+				if (!heap.empty () && deadBytes * REPLACEMENT_SLACK < spaceBytes.size () * pageSize)
+					break;
+				compact ();
+				if (!allocate (entry))
+					break;
+			}
+			keys->getLHSKey (entry.key);
+			lhs->toBinary (location (entry));
+
+			// it can go into the current run only if it does not come before the last record written
+			entry.run = curRunNum;
+			if (haveLast && recLess (entry, last))
+				entry.run = curRunNum + 1;
+			heap.push_back (entry);
+			push_heap (heap.begin (), heap.end (), entryComp);
+			inputLeft = input->advance ();
+		}
+
+		if (heap.empty ())
+			break;
+
+		// write out the smallest record, starting a new run if need be
+		pop_heap (heap.begin (), heap.end (), entryComp);
+		ReplacementEntry top = heap.back ();
+		heap.pop_back ();
+		if (top.run != curRunNum) {
+			curRun.push_back (curPage);
+			runs.push_back (curRun);
+			curRun.clear ();
+			curPage = MyDB_PageReaderWriter (*parent);
+			curRunNum = top.run;
+		}
+
+		MyDB_RecordPtr outRec = keys->getRHS ();
+		outRec->fromBinary (location (top));
+		appendRecord (curPage, curRun, outRec, parent);
+
+		// and remember it as the last record written; the one before it is no longer needed
+		if (haveLast)
+			deadBytes += last.size;
+		last = top;
+		haveLast = true;
+	}
+
+	curRun.push_back (curPage);
+	runs.push_back (curRun);
+	return runs;
+}
+
+MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe, 
+	MyDB_KeyNormalizerPtr keys, string lhsPred, MyDB_RunKind runKind) {
+
+	return buildItertorOverSortedRuns (runSize, sortMe, keys, lhsPred, MyDB_MergeKind :: LoserTree, 1, runKind);
+}
+
+MyDB_RecordIteratorAltPtr mergeSortedRuns (int runSize, MyDB_BufferManagerPtr parent,
+	vector <vector <MyDB_PageReaderWriter>> &runs, MyDB_KeyNormalizerPtr keys) {
+
+	// a single run is already sorted, so there is nothing to merge
+	if (runs.size () == 1)
+		return getIteratorAlt (runs[0]);
+
+	// if there are more runs than can be merged at once, merge them in groups into longer runs
+	int readAhead, fanIn;
+	planMerge (runSize, readAhead, fanIn);
+	while ((int) runs.size () > fanIn) {
+		vector <vector <MyDB_PageReaderWriter>> longerRuns;
+		for (size_t i = 0; i < runs.size (); i += fanIn) {
+			vector <MyDB_RecordIteratorAltPtr> iters;
+			for (size_t j = i; j < i + fanIn && j < runs.size (); j++)
+				iters.push_back (getIteratorAlt (runs[j], readAhead));
+			if (iters.size () == 1)
+				longerRuns.push_back (runs[i]);
+			else
+				longerRuns.push_back (mergeIntoList (parent, iters, keys));
+		}
+
+		// this lets go of the pages of the shorter runs
+		runs = longerRuns;
+	}
+
+	// and now, we are ready to merge everything
+	MyDB_LoserTreeIteratorAltPtr temp = make_shared <MyDB_LoserTreeIteratorAlt> (keys);
+	for (auto &run : runs) {
+		MyDB_RecordIteratorAltPtr m = getIteratorAlt (run, readAhead);
+		if (m->advance ()) {
+			temp->addRun (m);
+		}
+	}
+	return temp;
+}
+
+MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe, 
+	MyDB_KeyNormalizerPtr keys, string lhsPred, MyDB_MergeKind mergeKind, int numThreads, MyDB_RunKind runKind) {
+
+	// this is the list of all of the runs
+	vector <vector <MyDB_PageReaderWriter>> runs;
+
+	if (runKind == MyDB_RunKind :: ReplacementSelection) {
+		runs = replacementSelection (runSize, sortMe, keys, lhsPred);
+		numThreads = 0;
+	}
+
+	// see if we can give each worker its own copy of the keys
+	vector <MyDB_KeyNormalizerPtr> workerKeys;
+	for (int t = 0; t < numThreads && numThreads > 1; t++) {
+		MyDB_KeyNormalizerPtr temp = keys->copyFor (sortMe.getEmptyRecord (), sortMe.getEmptyRecord ());
+		if (temp == nullptr) {
+			workerKeys.clear ();
+			break;
+		}
+		workerKeys.push_back (temp);
+	}
+
+	MyDB_RecordPtr lhs = keys->getLHS ();
 	bool skipPred = false;
 	if (lhsPred == "bool[true]")
 		skipPred = true;
@@ -120,18 +583,21 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 	// this is the pages making up the current run
 	vector <vector<MyDB_PageReaderWriter>> pagesToSort;
 
-	// this is the list of all of the iterators, with one for each run
-	vector <MyDB_RecordIteratorAltPtr> runIters;
+	if (workerKeys.size () > 0)
+		buildRunsInParallel (runSize, sortMe, workerKeys, lhsPred, runs);
 	
 	// process the file 
-	MyDB_PageReaderWriter tempPage (true, *sortMe.getBufferMgr ());
-	for (int i = 0; i < sortMe.getNumPages (); i++) {
+	bool sortPages = runKind == MyDB_RunKind :: SortPages && workerKeys.size () == 0;
+	MyDB_PageReaderWriterPtr tempPage;
+	if (sortPages)
+		tempPage = make_shared <MyDB_PageReaderWriter> (true, *sortMe.getBufferMgr ());
+	for (int i = 0; i < sortMe.getNumPages () && sortPages; i++) {
 		
 		if (sortMe[i].getType () == MyDB_PageType :: RegularPage) {
 
 			if (skipPred) {
 				vector <MyDB_PageReaderWriter> run;
-				run.push_back (*(sortMe[i].sort (comparator, lhs, rhs)));	
+				run.push_back (*(sortMe[i].sort (keys)));	
 				pagesToSort.push_back (run);
 			} else {
 				MyDB_RecordIteratorAltPtr temp = sortMe[i].getIteratorAlt ();
@@ -141,17 +607,17 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 					if (!f ()->toBool ())
 						continue;
 
-					if (!tempPage.append (lhs)) {
+					if (!tempPage->append (lhs)) {
 	
 						// remember the old page
 						vector <MyDB_PageReaderWriter> run;
-						run.push_back (*(tempPage.sort (comparator, lhs, rhs)));
+						run.push_back (*(tempPage->sort (keys)));
 						pagesToSort.push_back (run);
 	
 						// get the new page
-						tempPage = MyDB_PageReaderWriter (true, *sortMe.getBufferMgr ());	
+						tempPage = make_shared <MyDB_PageReaderWriter> (true, *sortMe.getBufferMgr ());	
 						temp->getCurrent (lhs);
-						tempPage.append (lhs);
+						tempPage->append (lhs);
 					}
 				}
 			}
@@ -160,7 +626,7 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 		// if we are all done, remember the last page
 		if (i == sortMe.getNumPages () - 1) {
 			vector <MyDB_PageReaderWriter> run;
-			run.push_back (*(tempPage.sort (comparator, lhs, rhs)));
+			run.push_back (*(tempPage->sort (keys)));
 			pagesToSort.push_back (run);
 		}
 
@@ -168,7 +634,17 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 		if (pagesToSort.size () != runSize && i != sortMe.getNumPages () - 1)
 			continue;
 
-		// while we don't have a single sorted list
+		// merge all of the sorted pages in the run at once
+		if (mergeKind == MyDB_MergeKind :: LoserTree && pagesToSort.size () > 1) {
+			vector <MyDB_RecordIteratorAltPtr> pageIters;
+			for (auto &run : pagesToSort)
+				pageIters.push_back (getIteratorAlt (run));
+			vector <MyDB_PageReaderWriter> merged = mergeIntoList (sortMe.getBufferMgr (), pageIters, keys);
+			pagesToSort.clear ();
+			pagesToSort.push_back (merged);
+		}
+
+		// or, while we don't have a single sorted list, merge them two at a time
 		while (pagesToSort.size () > 1) {
 			
 			// the new version of the pages to sort vector
@@ -192,27 +668,34 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 		
 				// merge them
 				newPagesToSort.push_back (mergeIntoList (sortMe.getBufferMgr (), getIteratorAlt (runOne), 
-					getIteratorAlt (runTwo), comparator, lhs, rhs));
+					getIteratorAlt (runTwo), keys));
 			}
 	
 			pagesToSort = newPagesToSort;
 		}
 
 		
-		// now we have a single list, so create an iterator for it
-		runIters.push_back (getIteratorAlt (pagesToSort[0]));
+		// now we have a single list, so remember it
+		runs.push_back (pagesToSort[0]);
 
 		// and start over on the next run
 		pagesToSort.clear ();
 	}
 	
-	// and now, we are ready to merge everything
-	MyDB_RunQueueIteratorAltPtr temp = make_shared <MyDB_RunQueueIteratorAlt> (comparator, lhs, rhs);
+	// a single run is already sorted, so there is nothing to merge
+	if (runs.size () == 1)
+		return getIteratorAlt (runs[0]);
+
+	if (mergeKind == MyDB_MergeKind :: LoserTree)
+		return mergeSortedRuns (runSize, sortMe.getBufferMgr (), runs, keys);
+
+	MyDB_RunQueueIteratorAltPtr temp = make_shared <MyDB_RunQueueIteratorAlt> (keys);
 
 	// load up the set
-	for (MyDB_RecordIteratorAltPtr m : runIters) {
+	for (auto &run : runs) {
+		MyDB_RecordIteratorAltPtr m = getIteratorAlt (run);
 		if (m->advance ()) {
-			temp->getQ ().push (m);
+			temp->addRun (m);
 		}
 	}
 
@@ -222,9 +705,31 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 
 void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe,
 	function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
+	sort (runSize, sortMe, sortIntoMe, make_shared <MyDB_KeyNormalizer> (comparator, lhs, rhs));
+}
+
+void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe,
+	MyDB_KeyNormalizerPtr keys) {
+	sort (runSize, sortMe, sortIntoMe, keys, 1);
+}
+
+void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe,
+	MyDB_KeyNormalizerPtr keys, MyDB_RunKind runKind) {
+
+	MyDB_RecordPtr lhs = keys->getLHS ();
+	MyDB_RecordIteratorAltPtr myIter = buildItertorOverSortedRuns (runSize, sortMe, keys, "bool[true]", runKind);
+	while (myIter->advance ()) {
+		myIter->getCurrent (lhs);
+		sortIntoMe.append (lhs);
+	}
+}
+
+void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe,
+	MyDB_KeyNormalizerPtr keys, int numThreads) {
 
 	// get the sorted runs
-	MyDB_RecordIteratorAltPtr myIter = buildItertorOverSortedRuns (runSize, sortMe, comparator, lhs, rhs);
+	MyDB_RecordPtr lhs = keys->getLHS ();
+	MyDB_RecordIteratorAltPtr myIter = buildItertorOverSortedRuns (runSize, sortMe, keys, "bool[true]", numThreads);
 
 	// and write everyone out
 	while (myIter->advance ()) {
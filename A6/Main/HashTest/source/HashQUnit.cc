@@ -0,0 +1,88 @@
+
+#ifndef HASH_TEST_H
+#define HASH_TEST_H
+
+#include "MyDB_AttType.h"  
+#include "MyDB_BufferManager.h"
+#include "MyDB_Catalog.h"  
+#include "MyDB_HashReaderWriter.h"
+#include "MyDB_Record.h"
+#include "MyDB_Table.h"
+#include "MyDB_Schema.h"
+#include "QUnit.h"
+#include <iostream>
+
+int main () {
+
+	QUnit::UnitTest qunit(cerr, QUnit::verbose);
+
+	{
+		// hash files on a unique key, and on a key with many duplicates
+		MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema> ();
+		mySchema->appendAtt (make_pair ("suppkey", make_shared <MyDB_IntAttType> ()));
+		mySchema->appendAtt (make_pair ("name", make_shared <MyDB_StringAttType> ()));
+		mySchema->appendAtt (make_pair ("address", make_shared <MyDB_StringAttType> ()));
+		mySchema->appendAtt (make_pair ("nationkey", make_shared <MyDB_IntAttType> ()));
+		mySchema->appendAtt (make_pair ("phone", make_shared <MyDB_StringAttType> ()));
+		mySchema->appendAtt (make_pair ("acctbal", make_shared <MyDB_DoubleAttType> ()));
+		mySchema->appendAtt (make_pair ("comment", make_shared <MyDB_StringAttType> ()));
+
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (4096, 128, "tempFile");
+		MyDB_TablePtr byKeyTable = make_shared <MyDB_Table> ("supplierHashed", "supplierHashed.bin", mySchema,
+			"hash", "suppkey");
+		MyDB_HashReaderWriterPtr byKey = make_shared <MyDB_HashReaderWriter> ("suppkey", byKeyTable, myMgr);
+		MyDB_TablePtr byNationTable = make_shared <MyDB_Table> ("supplierByNation", "supplierByNation.bin", mySchema,
+			"hash", "nationkey");
+		MyDB_HashReaderWriterPtr byNation = make_shared <MyDB_HashReaderWriter> ("nationkey", byNationTable, myMgr);
+		byKey->loadFromTextFile ("supplier.tbl");
+		byNation->loadFromTextFile ("supplier.tbl");
+
+		// the buckets were split as the records went in, and a scan gets all of the records
+		QUNIT_IS_TRUE (byKey->getNumBuckets () > HASH_INITIAL_BUCKETS);
+		MyDB_RecordPtr temp = byKey->getEmptyRecord ();
+		vector <int> nationCounts (25, 0);
+		int counter = 0;
+		MyDB_RecordIteratorAltPtr myIter = byKey->getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			nationCounts[temp->getAtt (3)->toInt ()]++;
+			counter++;
+		}
+		QUNIT_IS_EQUAL (counter, 10000);
+
+		// every key is found exactly once
+		vector <MyDB_RecordPtr> matches;
+		MyDB_IntAttValPtr key = make_shared <MyDB_IntAttVal> ();
+		int found = 0;
+		for (int i = 1; i <= 10000; i++) {
+			key->set (i);
+			if (byKey->lookup (key, matches) == 1 && matches[0]->getAtt (0)->toInt () == i)
+				found++;
+		}
+		QUNIT_IS_EQUAL (found, 10000);
+		key->set (10001);
+		QUNIT_IS_EQUAL (byKey->lookup (key, matches), 0);
+
+		// and all of the duplicates are found
+		int same = 0;
+		for (int i = 0; i < 25; i++) {
+			key->set (i);
+			size_t numMatches = byNation->lookup (key, matches);
+			bool allMatch = numMatches == (size_t) nationCounts[i];
+			for (size_t j = 0; j < numMatches; j++)
+				allMatch = allMatch && matches[j]->getAtt (3)->toInt () == i;
+			if (allMatch)
+				same++;
+		}
+		QUNIT_IS_EQUAL (same, 25);
+
+		// a file that is opened again gets its buckets from the header
+		MyDB_HashReaderWriterPtr byKeyAgain = make_shared <MyDB_HashReaderWriter> ("suppkey", byKeyTable, myMgr);
+		QUNIT_IS_EQUAL (byKeyAgain->getNumBuckets (), byKey->getNumBuckets ());
+		key->set (7654);
+		QUNIT_IS_EQUAL (byKeyAgain->lookup (key, matches), 1);
+		QUNIT_IS_EQUAL (matches[0]->getAtt (0)->toInt (), 7654);
+	}
+}
+
+#endif
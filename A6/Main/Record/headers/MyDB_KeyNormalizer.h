@@ -0,0 +1,111 @@
+
+#ifndef KEY_NORMALIZER_H
+#define KEY_NORMALIZER_H
+
+#include <functional>
+#include <memory>
+#include "MyDB_Record.h"
+#include <string.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// the number of bytes in a normalized key
+#define NORMALIZED_KEY_SIZE 16
+
+// A normalized key is an order-preserving binary encoding of (a prefix of) a sort key, so
+// that two records can be compared by running memcmp on their keys.  If complete is true,
+// then the key encodes the entire sort key; otherwise, two keys that tie may still belong to
+// records that are not equal, and the records themselves need to be compared.
+struct MyDB_NormalizedKey {
+	unsigned char bytes[NORMALIZED_KEY_SIZE];
+	bool complete;
+};
+
+// create a smart pointer for key normalizers
+class MyDB_KeyNormalizer;
+typedef shared_ptr <MyDB_KeyNormalizer> MyDB_KeyNormalizerPtr;
+
+// This class is used to sort records using normalized keys.  It is built from the same
+// computation string that is given to buildRecordComparator, and it extracts the normalized
+// key of the records loaded into lhs and rhs.  Ints are encoded big-endian with the sign
+// bit flipped, doubles have their bits flipped so that negative numbers come first, and
+// strings are zero-padded (or cut off) to NORMALIZED_KEY_SIZE bytes.
+class MyDB_KeyNormalizer {
+
+public:
+
+	// sort using the given computation (ex: "[acctbal]"), evaluated over lhs and over rhs
+	MyDB_KeyNormalizer (MyDB_RecordPtr lhs, MyDB_RecordPtr rhs, string computation);
+
+	// sort using an arbitrary comparator over lhs and rhs (as built by buildRecordComparator);
+	// no keys are extracted, so every comparison ends up running the comparator
+	MyDB_KeyNormalizer (function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
+
+	// get the normalized key of the record currently loaded into lhs (or rhs)
+	void getLHSKey (MyDB_NormalizedKey &key);
+	void getRHSKey (MyDB_NormalizedKey &key);
+
+	// see if the two keys are enough to decide whether lhsKey < rhsKey; if they are, true is
+	// returned and the answer is put into isLess.  If false is returned, then the records
+	// need to be compared using compare ()
+	static inline bool keysDecide (const MyDB_NormalizedKey &lhsKey, const MyDB_NormalizedKey &rhsKey, 
+		bool &isLess) {
+		int res = memcmp (lhsKey.bytes, rhsKey.bytes, NORMALIZED_KEY_SIZE);
+		if (res != 0) {
+			isLess = res < 0;
+			return true;
+		}
+		isLess = false;
+		return lhsKey.complete && rhsKey.complete;
+	}
+
+	// run the full comparison over the records loaded into lhs and rhs; true if lhs < rhs
+	inline bool compare () {
+		return comparator ();
+	}
+
+	// sorts the (key, record location) pairs, which must have been extracted by this normalizer,
+	// keeping records that are equal in the order that they came in.  When there is a key, and
+	// there are enough records, this is an LSD radix sort over the bytes of the key that are
+	// used (four for an int and eight for a double), which skips any byte that is the same in all
+	// of the keys; records whose keys tie but are not complete are then sorted by the comparator.
+	// Otherwise, this is a std :: stable_sort that compares the keys and then the records
+	void sort (vector <pair <MyDB_NormalizedKey, void *>> &positions);
+
+	// builds a normalizer that sorts the same way, but over the given records; this is used to
+	// give each thread of a parallel sort its own records.  Returns nullptr if the normalizer was
+	// built from a comparator, since that comparator can only be run over its own records
+	MyDB_KeyNormalizerPtr copyFor (MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
+
+	// the records that this normalizer works over, and the full comparator
+	MyDB_RecordPtr getLHS ();
+	MyDB_RecordPtr getRHS ();
+	function <bool ()> getComparator ();
+
+private:
+
+	// extract the key from the result of the computation
+	void getKey (func &computation, MyDB_NormalizedKey &key);
+
+	// true if the record at lhsPos comes before the one at rhsPos
+	bool isLess (const pair <MyDB_NormalizedKey, void *> &lhsPos, const pair <MyDB_NormalizedKey, void *> &rhsPos);
+
+	// the full comparator, and the computation that it was built from (empty if the
+	// normalizer was built from a comparator)
+	function <bool ()> comparator;
+	string computation;
+
+	// the records, and the sort computation over each of them
+	MyDB_RecordPtr lhs;
+	MyDB_RecordPtr rhs;
+	func lhsFunc;
+	func rhsFunc;
+
+	// the type of the sort key
+	enum {NoKey, IntKey, DoubleKey, StringKey} keyType;
+};
+
+#endif
@@ -113,6 +113,9 @@ public:
 
 	friend function <bool ()> buildRecordComparatorEq (MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs, string computation1, string computation2);
 
+	// the key normalizer needs to know the type of a computation
+	friend class MyDB_KeyNormalizer;
+
 	// access the schema
 	MyDB_SchemaPtr &getSchema ();
 
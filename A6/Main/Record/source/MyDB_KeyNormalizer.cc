@@ -0,0 +1,190 @@
+
+#ifndef KEY_NORMALIZER_C
+#define KEY_NORMALIZER_C
+
+#include <algorithm>
+#include "MyDB_KeyNormalizer.h"
+
+using namespace std;
+
+// below this many records, a comparison sort is faster than making the radix sort's passes
+#define MIN_RADIX_SORT_SIZE 64
+
+MyDB_KeyNormalizer :: MyDB_KeyNormalizer (MyDB_RecordPtr lhsIn, MyDB_RecordPtr rhsIn, string computationIn) {
+
+	computation = computationIn;
+	lhs = lhsIn;
+	rhs = rhsIn;
+	comparator = buildRecordComparator (lhs, rhs, computation);
+
+	// compile the computation over both records
+	char *str = (char *) computation.c_str ();
+	pair <func, MyDB_AttTypePtr> lhsRes = lhs->compileHelper (str);
+	str = (char *) computation.c_str ();
+	pair <func, MyDB_AttTypePtr> rhsRes = rhs->compileHelper (str);
+	lhsFunc = lhsRes.first;
+	rhsFunc = rhsRes.first;
+
+	// these are the same cases, in the same order, as in MyDB_Record :: lt
+	if (lhsRes.second->promotableToInt ())
+		keyType = IntKey;
+	else if (lhsRes.second->promotableToDouble ())
+		keyType = DoubleKey;
+	else
+		keyType = StringKey;
+}
+
+MyDB_KeyNormalizer :: MyDB_KeyNormalizer (function <bool ()> comparatorIn, MyDB_RecordPtr lhsIn, MyDB_RecordPtr rhsIn) {
+	lhs = lhsIn;
+	rhs = rhsIn;
+	comparator = comparatorIn;
+	keyType = NoKey;
+}
+
+void MyDB_KeyNormalizer :: getLHSKey (MyDB_NormalizedKey &key) {
+	getKey (lhsFunc, key);
+}
+
+void MyDB_KeyNormalizer :: getRHSKey (MyDB_NormalizedKey &key) {
+	getKey (rhsFunc, key);
+}
+
+void MyDB_KeyNormalizer :: getKey (func &computation, MyDB_NormalizedKey &key) {
+
+	memset (key.bytes, 0, NORMALIZED_KEY_SIZE);
+	key.complete = true;
+
+	if (keyType == IntKey) {
+
+		// flip the sign bit so that negative numbers come first, and write big-endian
+		unsigned int val = ((unsigned int) computation ()->toInt ()) ^ 0x80000000U;
+		for (int i = 0; i < 4; i++)
+			key.bytes[i] = (unsigned char) (val >> (24 - 8 * i));
+
+	} else if (keyType == DoubleKey) {
+
+		// -0.0 and 0.0 are equal, so they need to get the same key
+		double dVal = computation ()->toDouble ();
+		if (dVal == 0.0)
+			dVal = 0.0;
+
+		// positive numbers just get their sign bit flipped; negative numbers get all of
+		// their bits flipped, so that larger magnitudes come first
+		unsigned long long val;
+		memcpy (&val, &dVal, sizeof (double));
+		if (val >> 63)
+			val = ~val;
+		else
+			val ^= 1ULL << 63;
+		for (int i = 0; i < 8; i++)
+			key.bytes[i] = (unsigned char) (val >> (56 - 8 * i));
+
+	} else if (keyType == StringKey) {
+
+		// strings compare byte-by-byte, so we can just copy the prefix
+		string sVal = computation ()->toString ();
+		if (sVal.size () < NORMALIZED_KEY_SIZE) {
+			memcpy (key.bytes, sVal.c_str (), sVal.size ());
+		} else {
+			memcpy (key.bytes, sVal.c_str (), NORMALIZED_KEY_SIZE);
+			key.complete = false;
+		}
+
+	} else {
+
+		// we have no key, so the records always need to be compared
+		key.complete = false;
+	}
+}
+
+bool MyDB_KeyNormalizer :: isLess (const pair <MyDB_NormalizedKey, void *> &lhsPos, 
+	const pair <MyDB_NormalizedKey, void *> &rhsPos) {
+	bool res;
+	if (keysDecide (lhsPos.first, rhsPos.first, res))
+		return res;
+	lhs->fromBinary (lhsPos.second);
+	rhs->fromBinary (rhsPos.second);
+	return comparator ();
+}
+
+void MyDB_KeyNormalizer :: sort (vector <pair <MyDB_NormalizedKey, void *>> &positions) {
+
+	auto comp = [this] (const pair <MyDB_NormalizedKey, void *> &lhsPos, const pair <MyDB_NormalizedKey, void *> &rhsPos) {
+		return isLess (lhsPos, rhsPos);
+	};
+
+	if (keyType == NoKey || positions.size () < MIN_RADIX_SORT_SIZE) {
+		std :: stable_sort (positions.begin (), positions.end (), comp);
+		return;
+	}
+
+	// the number of bytes of the key that are used
+	int keyBytes = NORMALIZED_KEY_SIZE;
+	if (keyType == IntKey)
+		keyBytes = 4;
+	else if (keyType == DoubleKey)
+		keyBytes = 8;
+
+	// count the values of each byte, all in one pass
+	vector <size_t> counts (keyBytes * 256, 0);
+	for (auto &pos : positions)
+		for (int i = 0; i < keyBytes; i++)
+			counts[i * 256 + pos.first.bytes[i]]++;
+
+	// and then distribute the records on each byte, starting with the least significant; since
+	// each pass is stable, the records end up sorted on all of the bytes
+	vector <pair <MyDB_NormalizedKey, void *>> other (positions.size ());
+	for (int i = keyBytes - 1; i >= 0; i--) {
+
+		size_t *count = &counts[i * 256];
+		if (count[positions[0].first.bytes[i]] == positions.size ())
+			continue;
+
+		size_t next[256];
+		size_t total = 0;
+		for (int j = 0; j < 256; j++) {
+			next[j] = total;
+			total += count[j];
+		}
+		for (auto &pos : positions)
+			other[next[pos.first.bytes[i]]++] = pos;
+		positions.swap (other);
+	}
+
+	// a key that is not complete only sorts the records on a prefix, so each group of records
+	// whose keys tie has to be sorted using the comparator
+	if (keyType != StringKey)
+		return;
+	for (size_t start = 0; start < positions.size ();) {
+		size_t end = start + 1;
+		bool complete = positions[start].first.complete;
+		while (end < positions.size () && 
+			memcmp (positions[start].first.bytes, positions[end].first.bytes, NORMALIZED_KEY_SIZE) == 0) {
+			complete = complete && positions[end].first.complete;
+			end++;
+		}
+		if (!complete && end - start > 1)
+			std :: stable_sort (positions.begin () + start, positions.begin () + end, comp);
+		start = end;
+	}
+}
+
+MyDB_KeyNormalizerPtr MyDB_KeyNormalizer :: copyFor (MyDB_RecordPtr lhsIn, MyDB_RecordPtr rhsIn) {
+	if (keyType == NoKey)
+		return nullptr;
+	return make_shared <MyDB_KeyNormalizer> (lhsIn, rhsIn, computation);
+}
+
+MyDB_RecordPtr MyDB_KeyNormalizer :: getLHS () {
+	return lhs;
+}
+
+MyDB_RecordPtr MyDB_KeyNormalizer :: getRHS () {
+	return rhs;
+}
+
+function <bool ()> MyDB_KeyNormalizer :: getComparator () {
+	return comparator;
+}
+
+#endif
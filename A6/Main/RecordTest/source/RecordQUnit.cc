@@ -7,6 +7,7 @@
 #include "MyDB_Catalog.h"  
 #include "MyDB_Page.h"
 #include "MyDB_PageReaderWriter.h"
+#include "MyDB_PaxPage.h"
 #include "MyDB_Record.h"
 #include "MyDB_Table.h"
 #include "MyDB_TableReaderWriter.h"
@@ -53,7 +54,7 @@ void initialize() {
 int main(int argc, char *argv[]) {
 	int start = 1;
 	if (argc > 1 && argv[1][0] >= '0' && argv[1][0] <= '9') {
-		start = argv[1][0] - '0';
+		start = atoi(argv[1]);
 	}
 	cout << "start from test " << start << endl << flush;
 
@@ -463,6 +464,301 @@ int main(int argc, char *argv[]) {
 		QUNIT_IS_FALSE(result);
 	}
 	FALLTHROUGH_INTENDED;
+	case 11:
+	{
+		// slotted pages: iterate, then fetch every record by its slot
+		cout << "TEST 11..." << flush;
+		initialize();
+		bool result = true;
+		int counter = 0;
+		string last;
+		{
+			cout << "create slotted table..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_TablePtr myTable = make_shared <MyDB_Table>("supplierSlotted", "supplierSlotted.bin",
+				allTables["supplier"]->getSchema ());
+			myTable->setPageFormat("slotted");
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter slottedTable(myTable, myMgr);
+			slottedTable.loadFromTextFile("supplier.tbl");
+			myTable->putInCatalog(myCatalog);
+
+			cout << "compare to iterator..." << flush;
+			MyDB_RecordPtr temp = slottedTable.getEmptyRecord();
+			MyDB_RecordPtr other = slottedTable.getEmptyRecord();
+			for (int page = 0; page < slottedTable.getNumPages(); page++) {
+				MyDB_PageReaderWriter myPage = slottedTable[page];
+				result = result && myPage.isSlotted();
+				MyDB_RecordIteratorPtr myIter = myPage.getIterator(temp);
+				size_t slot = 0;
+				while (myIter->hasNext()) {
+					myIter->getNext();
+					counter++;
+					result = result && myPage.getRecord(slot++, other);
+					stringstream ss1, ss2;
+					ss1 << temp;
+					ss2 << other;
+					result = result && (ss1.str() == ss2.str());
+					last = ss1.str();
+				}
+				result = result && (slot == myPage.getNumRecords()) && !myPage.getRecord(slot, other);
+			}
+
+			cout << "sort a page in place..." << flush;
+			MyDB_RecordPtr lhs = slottedTable.getEmptyRecord();
+			MyDB_RecordPtr rhs = slottedTable.getEmptyRecord();
+			function <bool ()> comparator = buildRecordComparator(lhs, rhs, "um ([suppkey])");
+			MyDB_PageReaderWriter myPage = slottedTable[3];
+			size_t numRecs = myPage.getNumRecords();
+			myPage.sortInPlace(comparator, lhs, rhs);
+			result = result && myPage.isSlotted() && myPage.getNumRecords() == numRecs;
+			for (size_t i = 1; i < numRecs; i++) {
+				myPage.getRecord(i - 1, lhs);
+				myPage.getRecord(i, rhs);
+				result = result && (lhs->getAtt(0)->toInt() > rhs->getAtt(0)->toInt());
+			}
+			cout << "shutdown manager..." << flush;
+		}
+
+		// the page format should come back from the catalog
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+		result = result && allTables["supplierSlotted"]->hasSlottedPages() && !allTables["supplier"]->hasSlottedPages();
+
+		const string answer = "10000|Supplier#000010000|R7kfmyzoIfXlrbnqNwUUW3phJctocp0J|19|29-578-432-2146|8968.420000|furiously final ideas believe furiously. furiously final ideas|";
+		if (result && counter == 10000 && last == answer) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+		QUNIT_IS_EQUAL(counter, 10000);
+		QUNIT_IS_EQUAL(last, answer);
+	}
+	FALLTHROUGH_INTENDED;
+	case 12:
+	{
+		// PAX pages: the records should come back just like they do from a heap file
+		cout << "TEST 12..." << flush;
+		initialize();
+		bool result = true;
+		int counter = 0;
+		int numMatches = 0;
+		{
+			cout << "create pax table..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_TablePtr myTable = make_shared <MyDB_Table>("supplierPax", "supplierPax.bin",
+				allTables["supplier"]->getSchema (), "pax", "none");
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter paxTable(myTable, myMgr);
+			paxTable.bulkLoadFromTextFile("supplier.tbl", 2);
+			myTable->putInCatalog(myCatalog);
+			MyDB_TableReaderWriter heapTable(allTables["supplier"], myMgr);
+
+			cout << "compare to heap file..." << flush;
+			MyDB_RecordPtr temp = paxTable.getEmptyRecord();
+			MyDB_RecordPtr other = heapTable.getEmptyRecord();
+			MyDB_RecordIteratorAltPtr paxIter = paxTable.getIteratorAlt();
+			MyDB_RecordIteratorAltPtr heapIter = heapTable.getIteratorAlt();
+			while (paxIter->advance()) {
+				result = result && heapIter->advance();
+				paxIter->getCurrent(temp);
+				heapIter->getCurrent(other);
+				stringstream ss1, ss2;
+				ss1 << temp;
+				ss2 << other;
+				result = result && (ss1.str() == ss2.str()) && paxIter->getCurrentPointer() == nullptr;
+				counter++;
+			}
+			result = result && !heapIter->advance();
+
+			cout << "sum a minipage..." << flush;
+			long sum = 0;
+			for (int page = 0; page < paxTable.getNumPages(); page++) {
+				MyDB_PageReaderWriter myPage = paxTable[page];
+				result = result && myPage.isPax();
+				MyDB_PaxPage paxPage(myPage.getBytes(), myPage.getPageSize());
+				vector <char> buffer;
+				for (size_t group = paxPage.getFirstGroup(); group != 0; group = paxPage.getNextGroup(group)) {
+					MyDB_PaxColumn column = paxPage.getColumn(group, 0, buffer);
+					for (size_t i = 0; i < column.numRecs; i++)
+						sum += column.getInts()[i];
+				}
+			}
+			result = result && (sum == 50005000);
+
+			cout << "filter and load one attribute..." << flush;
+			MyDB_ZoneFilterPtr filter = make_shared <MyDB_ZoneFilter>("&& (< ([suppkey], int[100]), == ([nationkey], int[3]))", myTable);
+			vector <int> whichAtts;
+			whichAtts.push_back(0);
+			MyDB_RecordIteratorAltPtr myIter = paxTable.getIteratorAlt(filter, whichAtts);
+			temp = paxTable.getEmptyRecord();
+			while (myIter->advance()) {
+				myIter->getCurrent(temp);
+
+				// nationkey was not asked for, so it is never loaded
+				result = result && temp->getAtt(0)->toInt() < 100 && temp->getAtt(3)->toInt() == 0;
+				numMatches++;
+			}
+
+			cout << "sort a page in place..." << flush;
+			MyDB_RecordPtr lhs = paxTable.getEmptyRecord();
+			MyDB_RecordPtr rhs = paxTable.getEmptyRecord();
+			function <bool ()> comparator = buildRecordComparator(lhs, rhs, "um ([suppkey])");
+			MyDB_PageReaderWriter myPage = paxTable[3];
+			size_t numRecs = myPage.getNumRecords();
+			myPage.sortInPlace(comparator, lhs, rhs);
+			result = result && myPage.isPax() && myPage.getNumRecords() == numRecs;
+			for (size_t i = 1; i < numRecs; i++) {
+				myPage.getRecord(i - 1, lhs);
+				myPage.getRecord(i, rhs);
+				result = result && (lhs->getAtt(0)->toInt() > rhs->getAtt(0)->toInt());
+			}
+			cout << "shutdown manager..." << flush;
+		}
+
+		// the file type should come back from the catalog
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+		result = result && allTables["supplierPax"]->hasPaxPages() && !allTables["supplier"]->hasPaxPages();
+
+		if (result && counter == 10000 && numMatches == 3) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+		QUNIT_IS_EQUAL(counter, 10000);
+		QUNIT_IS_EQUAL(numMatches, 3);
+	}
+	FALLTHROUGH_INTENDED;
+	case 13:
+	{
+		// PAX pages with only numeric columns: the minipages should be encoded, so the table
+		// should be much smaller than a heap file, and scan to the same answers
+		cout << "TEST 13..." << flush;
+		initialize();
+		bool result = true;
+		int numHeap = 0;
+		int numPax = 0;
+		{
+			cout << "create tables..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema>();
+			mySchema->appendAtt(make_pair("suppkey", make_shared <MyDB_IntAttType>()));
+			mySchema->appendAtt(make_pair("nationkey", make_shared <MyDB_IntAttType>()));
+			mySchema->appendAtt(make_pair("acctbal", make_shared <MyDB_DoubleAttType>()));
+			MyDB_TablePtr heapTable = make_shared <MyDB_Table>("numbersHeap", "numbersHeap.bin", mySchema);
+			MyDB_TablePtr paxTable = make_shared <MyDB_Table>("numbersPax", "numbersPax.bin", mySchema, "pax", "none");
+			MyDB_BufferManagerPtr supplierMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(65536, 64, "tempFile2");
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], supplierMgr);
+			MyDB_TableReaderWriter heapWriter(heapTable, myMgr);
+			MyDB_TableReaderWriter paxWriter(paxTable, myMgr);
+
+			// 32 copies of the numeric columns of supplier, with the keys in sorted order
+			cout << "append 320000 records..." << flush;
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			MyDB_RecordPtr numbers = heapWriter.getEmptyRecord();
+			for (int copy = 0; copy < 32; copy++) {
+				MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt();
+				while (myIter->advance()) {
+					myIter->getCurrent(temp);
+					numbers->getAtt(0)->fromInt(copy * 10000 + temp->getAtt(0)->toInt());
+					numbers->getAtt(1)->set(temp->getAtt(3));
+					numbers->getAtt(2)->set(temp->getAtt(5));
+					numbers->recordContentHasChanged();
+					heapWriter.append(numbers);
+					paxWriter.append(numbers);
+				}
+			}
+			cout << "heap pages " << heapWriter.getNumPages() << ", pax pages " << paxWriter.getNumPages() << "..." << flush;
+			result = result && paxWriter.getNumPages() * 3 < heapWriter.getNumPages();
+
+			// scan both with the same filter; the PAX scan only loads the attribute it needs
+			cout << "filtered scans..." << flush;
+			string predicate = "&& (== ([nationkey], int[7]), > ([acctbal], double[5000.0]))";
+			vector <int> whichAtts;
+			whichAtts.push_back(2);
+			long double heapSum = 0, paxSum = 0;
+			clock_t start = clock();
+			MyDB_RecordIteratorAltPtr myIter = heapWriter.getIteratorAlt();
+			while (myIter->advance()) {
+				myIter->getCurrent(numbers);
+				if (numbers->getAtt(1)->toInt() == 7 && numbers->getAtt(2)->toDouble() > 5000.0) {
+					heapSum += numbers->getAtt(2)->toDouble();
+					numHeap++;
+				}
+			}
+			clock_t middle = clock();
+			MyDB_ZoneFilterPtr filter = make_shared <MyDB_ZoneFilter>(predicate, paxTable);
+			myIter = paxWriter.getIteratorAlt(filter, whichAtts);
+			while (myIter->advance()) {
+				myIter->getCurrent(numbers);
+				paxSum += numbers->getAtt(2)->toDouble();
+				numPax++;
+			}
+			clock_t end = clock();
+			cout << "heap scan " << (double) (middle - start) / CLOCKS_PER_SEC << " sec, pax scan "
+				<< (double) (end - middle) / CLOCKS_PER_SEC << " sec..." << flush;
+			result = result && heapSum == paxSum;
+			cout << "shutdown manager..." << flush;
+		}
+
+		if (result && numHeap == numPax && numHeap > 0) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+		QUNIT_IS_EQUAL(numHeap, numPax);
+	}
+	FALLTHROUGH_INTENDED;
+	case 14:
+	{
+		// a linked page (a leaf of a B+-Tree) sorted in place should keep its links
+		cout << "TEST 14..." << flush;
+		initialize();
+		bool result = true;
+		size_t numRecs = 0;
+		{
+			cout << "fill a linked page..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+			MyDB_PageReaderWriter myPage(true, *myMgr);
+			myPage.clearAsLinked();
+			myPage.setPrevPage(7);
+			myPage.setNextPage(9);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt();
+			while (myIter->advance()) {
+				myIter->getCurrent(temp);
+				if (!myPage.append(temp))
+					break;
+				numRecs++;
+			}
+
+			cout << "sort it in place..." << flush;
+			MyDB_RecordPtr lhs = supplierTable.getEmptyRecord();
+			MyDB_RecordPtr rhs = supplierTable.getEmptyRecord();
+			function <bool ()> comparator = buildRecordComparator(lhs, rhs, "um ([suppkey])");
+			myPage.sortInPlace(comparator, lhs, rhs);
+			result = result && myPage.isLinked() && myPage.getNumRecords() == numRecs && numRecs > 1;
+			result = result && myPage.getPrevPage() == 7 && myPage.getNextPage() == 9;
+			for (size_t i = 1; i < numRecs; i++) {
+				myPage.getRecord(i - 1, lhs);
+				myPage.getRecord(i, rhs);
+				result = result && (lhs->getAtt(0)->toInt() > rhs->getAtt(0)->toInt());
+			}
+
+			// and clearing it should not unlink it either
+			myPage.clear();
+			result = result && myPage.isLinked() && myPage.getNumRecords() == 0;
+			result = result && myPage.getPrevPage() == 7 && myPage.getNextPage() == 9;
+			cout << "shutdown manager..." << flush;
+		}
+
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
 	default:
 		break;
 	}
@@ -17,10 +17,15 @@
 #include "ScanJoin.h"
 #include "Aggregate.h"
 #include "BPlusSelection.h"
+#include "IndexNestedLoopJoin.h"
 #include "RegularSelection.h"
 #include "ScanJoin.h"
 #include "SortMergeJoin.h"
+#include "TopN.h"
+#include <algorithm>
 #include <iostream>
+#include <map>
+#include <math.h>
 #include <vector>
 #include <utility>
 
@@ -265,6 +270,215 @@ int main () {
                 }
 	}
 
+	{
+		// get the output schema and tables
+		MyDB_SchemaPtr mySchemaOut = make_shared <MyDB_Schema> ();
+		mySchemaOut->appendAtt (make_pair ("r_name", make_shared <MyDB_StringAttType> ()));
+		mySchemaOut->appendAtt (make_pair ("r_acctbal", make_shared <MyDB_DoubleAttType> ()));
+		MyDB_TablePtr myTableOut = make_shared <MyDB_Table> ("topOut", "topOut.bin", mySchemaOut);
+		MyDB_TableReaderWriterPtr topTableOut = make_shared <MyDB_TableReaderWriter> (myTableOut, myMgr);
+		MyDB_TablePtr myTableSorted = make_shared <MyDB_Table> ("topSortedOut", "topSortedOut.bin", mySchemaOut);
+		MyDB_TableReaderWriterPtr topTableSorted = make_shared <MyDB_TableReaderWriter> (myTableSorted, myMgr);
+
+		// This basically runs:
+		//
+		// SELECT r_name, r_acctbal
+		// FROM supplierRight
+		// ORDER BY r_acctbal DESC
+		// LIMIT 100
+
+		vector <string> projections;
+		projections.push_back ("[r_name]");
+		projections.push_back ("[r_acctbal]");
+
+		TopN myOp (supplierTableRNoBPlus, topTableOut, "bool[true]", projections, "[r_acctbal]", true, 100);
+		cout << "running top 100\n";
+		myOp.run ();
+
+		// asking for many more records than fit in the buffer makes the operator sort the input
+		TopN myOpAgain (supplierTableRNoBPlus, topTableSorted, "bool[true]", projections, "[r_acctbal]", true, 300000);
+		cout << "running top 300000\n";
+		myOpAgain.run ();
+
+		MyDB_RecordPtr temp = topTableOut->getEmptyRecord ();
+		MyDB_RecordPtr tempSorted = topTableSorted->getEmptyRecord ();
+		MyDB_RecordIteratorAltPtr myIter = topTableOut->getIteratorAlt ();
+		MyDB_RecordIteratorAltPtr myIterSorted = topTableSorted->getIteratorAlt ();
+
+		int count = 0, same = 0;
+		double last = 1e100;
+		bool inOrder = true;
+		while (myIter->advance () && myIterSorted->advance ()) {
+			myIter->getCurrent (temp);
+			myIterSorted->getCurrent (tempSorted);
+			if (count == 0)
+				cout << "The largest balance should be 9999.72: " << temp->getAtt (1)->toDouble () << "\n";
+			inOrder = inOrder && temp->getAtt (1)->toDouble () <= last;
+			last = temp->getAtt (1)->toDouble ();
+			if (temp->getAtt (1)->toDouble () == tempSorted->getAtt (1)->toDouble ())
+				same++;
+			count++;
+		}
+		cout << "Top 100 count should be 100: " << count << "\n";
+		cout << "Top 100 in order should be 1: " << inOrder << "\n";
+		cout << "Top 100 should agree with the sort on 100 balances: " << same << "\n";
+		cout << "Only the second should have sorted, so this should be 0 1: " << myOp.usedExternalSort () << " " <<
+			myOpAgain.usedExternalSort () << "\n";
+	}
+
+	{
+		// a top-N query in a small buffer pool, where the heap only has a few pages, so the records
+		// that are still in it are copied over from one half of the pages to the other many times
+		MyDB_BufferManagerPtr smallMgr = make_shared <MyDB_BufferManager> (8192, 16, "tempFile5");
+		MyDB_TablePtr mySmallTable = make_shared <MyDB_Table> ("supplierTopSmall", "supplierTopSmall.bin", mySchemaL);
+		MyDB_TableReaderWriterPtr supplierTableSmall = make_shared <MyDB_TableReaderWriter> (mySmallTable, smallMgr);
+		cout << "loading left table into a small buffer pool.\n";
+		supplierTableSmall->loadFromTextFile ("supplier.tbl");
+		MyDB_SchemaPtr mySchemaOut = make_shared <MyDB_Schema> ();
+		mySchemaOut->appendAtt (make_pair ("l_name", make_shared <MyDB_StringAttType> ()));
+		mySchemaOut->appendAtt (make_pair ("l_acctbal", make_shared <MyDB_DoubleAttType> ()));
+		MyDB_TablePtr myTableOut = make_shared <MyDB_Table> ("topSmallOut", "topSmallOut.bin", mySchemaOut);
+		MyDB_TableReaderWriterPtr topTableOut = make_shared <MyDB_TableReaderWriter> (myTableOut, smallMgr);
+
+		// This basically runs:
+		//
+		// SELECT l_name, l_acctbal
+		// FROM supplierLeft
+		// ORDER BY l_acctbal DESC
+		// LIMIT 150
+
+		vector <string> projections;
+		projections.push_back ("[l_name]");
+		projections.push_back ("[l_acctbal]");
+		TopN myOp (supplierTableSmall, topTableOut, "bool[true]", projections, "[l_acctbal]", true, 150);
+		cout << "running top 150 in a small buffer pool\n";
+		myOp.run ();
+
+		// the balance of each supplier, and all of the balances, largest first
+		map <string, double> balances;
+		vector <double> sorted;
+		MyDB_RecordPtr temp = supplierTableSmall->getEmptyRecord ();
+		MyDB_RecordIteratorAltPtr myIter = supplierTableSmall->getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			balances[temp->getAtt (1)->toString ()] = temp->getAtt (5)->toDouble ();
+			sorted.push_back (temp->getAtt (5)->toDouble ());
+		}
+		sort (sorted.begin (), sorted.end (), greater <double> ());
+
+		// each output record has to be a real supplier, with its own balance, in the right place
+		int count = 0, right = 0;
+		temp = topTableOut->getEmptyRecord ();
+		myIter = topTableOut->getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			auto res = balances.find (temp->getAtt (0)->toString ());
+			if (res != balances.end () && res->second == temp->getAtt (1)->toDouble () &&
+				sorted[count] == temp->getAtt (1)->toDouble ())
+				right++;
+			count++;
+		}
+		cout << "Top 150 in the small pool should give 150 records, all right, without sorting (150 150 0): " <<
+			count << " " << right << " " << myOp.usedExternalSort () << "\n";
+	}
+
+	{
+		// a high-cardinality GROUP BY, run through a small buffer pool, which should make the
+		// aggregation pick sorting over hashing
+		MyDB_BufferManagerPtr smallMgr = make_shared <MyDB_BufferManager> (131072, 16, "tempFile2");
+		MyDB_TablePtr mySmallTable = make_shared <MyDB_Table> ("supplierSmallPool", "supplierSmallPool.bin", mySchemaR);
+		MyDB_TableReaderWriterPtr supplierTableSmall = make_shared <MyDB_TableReaderWriter> (mySmallTable, smallMgr);
+		cout << "loading right table into a small buffer pool.\n";
+		supplierTableSmall->loadFromTextFile ("supplierBig.tbl");
+
+		// This basically runs:
+		//
+		// SELECT r_name, SUM (r_acctbal), COUNT (*)
+		// FROM supplierRight
+		// GROUP BY r_name
+
+		vector <pair <MyDB_AggType, string>> aggsToCompute;
+		aggsToCompute.push_back (make_pair (MyDB_AggType :: sum, "[r_acctbal]"));
+		aggsToCompute.push_back (make_pair (MyDB_AggType :: cnt, "int[0]"));
+		vector <string> groupings;
+		groupings.push_back ("[r_name]");
+
+		MyDB_SchemaPtr mySchemaOut = make_shared <MyDB_Schema> ();
+		mySchemaOut->appendAtt (make_pair ("r_name", make_shared <MyDB_StringAttType> ()));
+		mySchemaOut->appendAtt (make_pair ("mysum", make_shared <MyDB_DoubleAttType> ()));
+		mySchemaOut->appendAtt (make_pair ("mycnt", make_shared <MyDB_IntAttType> ()));
+		MyDB_TablePtr sortAggTable = make_shared <MyDB_Table> ("sortAggOut", "sortAggOut.bin", mySchemaOut);
+		MyDB_TableReaderWriterPtr sortAggOut = make_shared <MyDB_TableReaderWriter> (sortAggTable, smallMgr);
+		MyDB_TablePtr hashAggTable = make_shared <MyDB_Table> ("hashAggOut", "hashAggOut.bin", mySchemaOut);
+		MyDB_TableReaderWriterPtr hashAggOut = make_shared <MyDB_TableReaderWriter> (hashAggTable, myMgr);
+
+		Aggregate sortAgg (supplierTableSmall, sortAggOut, aggsToCompute, groupings, "bool[true]");
+		cout << "running aggregate in the small buffer pool\n";
+		sortAgg.run ();
+		Aggregate hashAgg (supplierTableRNoBPlus, hashAggOut, aggsToCompute, groupings, "bool[true]");
+		cout << "running aggregate in the large buffer pool\n";
+		hashAgg.run ();
+		cout << "The aggregations should use sort and hash (1 0): " << (sortAgg.getKindUsed () == MyDB_AggKind :: Sort) 
+			<< " " << (hashAgg.getKindUsed () == MyDB_AggKind :: Sort) << "\n";
+
+		map <string, pair <double, int>> hashResults;
+		MyDB_RecordPtr temp = hashAggOut->getEmptyRecord ();
+		MyDB_RecordIteratorAltPtr myIter = hashAggOut->getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			hashResults[temp->getAtt (0)->toString ()] = make_pair (temp->getAtt (1)->toDouble (), temp->getAtt (2)->toInt ());
+		}
+
+		// the sorted groups come out in order
+		int numGroups = 0, same = 0;
+		bool inOrder = true;
+		string last = "";
+		myIter = sortAggOut->getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			string name = temp->getAtt (0)->toString ();
+			inOrder = inOrder && (numGroups == 0 || last < name);
+			last = name;
+			auto res = hashResults.find (name);
+			if (res != hashResults.end () && res->second.second == temp->getAtt (2)->toInt () &&
+				fabs (res->second.first - temp->getAtt (1)->toDouble ()) < 0.01)
+				same++;
+			numGroups++;
+		}
+		cout << "The number of groups should be 10000: " << numGroups << " and " << hashResults.size () << "\n";
+		cout << "The groups that agree should be 10000: " << same << "\n";
+		cout << "The groups in order should be 1: " << inOrder << "\n";
+
+		// and now, with two groupings and an average, sorting in the large buffer pool
+		groupings.push_back ("[r_nationkey]");
+		aggsToCompute[0].first = MyDB_AggType :: avg;
+		MyDB_SchemaPtr mySchemaOutAgain = make_shared <MyDB_Schema> ();
+		mySchemaOutAgain->appendAtt (make_pair ("r_name", make_shared <MyDB_StringAttType> ()));
+		mySchemaOutAgain->appendAtt (make_pair ("r_nationkey", make_shared <MyDB_IntAttType> ()));
+		mySchemaOutAgain->appendAtt (make_pair ("myavg", make_shared <MyDB_DoubleAttType> ()));
+		mySchemaOutAgain->appendAtt (make_pair ("mycnt", make_shared <MyDB_IntAttType> ()));
+		MyDB_TablePtr sortAggTableAgain = make_shared <MyDB_Table> ("sortAggOutAgain", "sortAggOutAgain.bin", mySchemaOutAgain);
+		MyDB_TableReaderWriterPtr sortAggOutAgain = make_shared <MyDB_TableReaderWriter> (sortAggTableAgain, myMgr);
+		Aggregate sortAggAgain (supplierTableRNoBPlus, sortAggOutAgain, aggsToCompute, groupings, "bool[true]", 
+			MyDB_AggKind :: Sort);
+		sortAggAgain.run ();
+
+		numGroups = 0;
+		same = 0;
+		temp = sortAggOutAgain->getEmptyRecord ();
+		myIter = sortAggOutAgain->getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			auto res = hashResults.find (temp->getAtt (0)->toString ());
+			if (res != hashResults.end () && res->second.second == temp->getAtt (3)->toInt () &&
+				fabs (res->second.first / res->second.second - temp->getAtt (2)->toDouble ()) < 0.01)
+				same++;
+			numGroups++;
+		}
+		cout << "The number of groups by name and nation should be 10000: " << numGroups << "\n";
+		cout << "The averages that agree should be 10000: " << same << "\n";
+	}
+
 	MyDB_BPlusTreeReaderWriterPtr supplierTableR = make_shared <MyDB_BPlusTreeReaderWriter> ("r_address", myTableRight, myMgr);
 	MyDB_TablePtr myTableRightNoBPlus = make_shared <MyDB_Table> ("supplierRightNoBPlus", "supplierRightNoBPlus.bin", mySchemaR);
 
@@ -316,6 +530,161 @@ int main () {
 
 	}
 
+	{
+		// a B+-Tree over the right table on the join key
+		MyDB_TablePtr myTableBySuppkey = make_shared <MyDB_Table> ("supplierRightBySuppkey", "supplierRightBySuppkey.bin", mySchemaR);
+		MyDB_BPlusTreeReaderWriterPtr supplierTableBySuppkey = make_shared <MyDB_BPlusTreeReaderWriter> ("r_suppkey",
+			myTableBySuppkey, myMgr);
+		cout << "bulk loading right into B+-Tree indexed on r_suppkey.\n";
+		supplierTableBySuppkey->bulkLoad (*supplierTableRNoBPlus, BPLUS_DEFAULT_FILL_FACTOR);
+
+		MyDB_SchemaPtr mySchemaOut = make_shared <MyDB_Schema> ();
+		mySchemaOut->appendAtt (make_pair ("l_name", make_shared <MyDB_StringAttType> ()));
+		mySchemaOut->appendAtt (make_pair ("combined_comment", make_shared <MyDB_StringAttType> ()));
+		MyDB_TablePtr myTableOut = make_shared <MyDB_Table> ("supplierOut", "supplierOut.bin", mySchemaOut);
+		MyDB_TableReaderWriterPtr supplierTableOut = make_shared <MyDB_TableReaderWriter> (myTableOut, myMgr);
+		MyDB_TablePtr myTableOutAgain = make_shared <MyDB_Table> ("supplierOutAgain", "supplierOutAgain.bin", mySchemaOut);
+		MyDB_TableReaderWriterPtr supplierTableOutAgain = make_shared <MyDB_TableReaderWriter> (myTableOutAgain, myMgr);
+
+		vector <string> projections;
+		projections.push_back ("[l_name]");
+		projections.push_back ("+ (+ ([l_comment], string[ ]), [r_comment])");
+
+		// This basically runs:
+		//
+		// SELECT supplierLeft.l_name, supplierLeft.l_comment + " " + supplierRight.r_comment
+		// FROM supplierLeft, supplierRight
+		// WHERE (supplierLeft.l_nationkey = 1) AND
+		//       (supplierLeft.l_suppkey = supplierRight.r_suppkey)
+		//
+		// by probing the tree with the suppkey of each supplierLeft record
+		IndexNestedLoopJoin myOp (supplierTableL, supplierTableBySuppkey, supplierTableOut,
+			"== ([l_suppkey], [r_suppkey])", projections, "[l_suppkey]",
+			"== ([l_nationkey], int[1])", "bool[true]");
+		cout << "running index nested-loop join\n";
+		myOp.run ();
+
+		// and the same, with a predicate on the right input, checked against a scan join
+		IndexNestedLoopJoin myOpAgain (supplierTableL, supplierTableBySuppkey, supplierTableOutAgain,
+			"&& ( == ([l_suppkey], [r_suppkey]), > ([l_acctbal], [r_acctbal]))", projections, "[l_suppkey]",
+			"|| ( == ([l_nationkey], int[3]), == ([l_nationkey], int[4]))",
+			"> ([r_acctbal], int[5000])");
+		myOpAgain.run ();
+
+		MyDB_TablePtr myTableOutScan = make_shared <MyDB_Table> ("supplierOutScan", "supplierOutScan.bin", mySchemaOut);
+		MyDB_TableReaderWriterPtr supplierTableOutScan = make_shared <MyDB_TableReaderWriter> (myTableOutScan, myMgr);
+		vector <pair <string, string>> hashAtts;
+		hashAtts.push_back (make_pair (string ("[l_suppkey]"), string ("[r_suppkey]")));
+		ScanJoin myScanOp (supplierTableL, supplierTableRNoBPlus, supplierTableOutScan,
+			"&& ( == ([l_suppkey], [r_suppkey]), > ([l_acctbal], [r_acctbal]))", projections, hashAtts,
+			"|| ( == ([l_nationkey], int[3]), == ([l_nationkey], int[4]))",
+			"> ([r_acctbal], int[5000])");
+		myScanOp.run ();
+
+		// count up the results
+		MyDB_RecordPtr temp = supplierTableOut->getEmptyRecord ();
+		map <string, int> counts;
+		int count = 0;
+		MyDB_RecordIteratorAltPtr myIter = supplierTableOut->getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			count++;
+		}
+		int indexCount = 0;
+		myIter = supplierTableOutAgain->getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			indexCount++;
+			counts[temp->getAtt (0)->toString () + temp->getAtt (1)->toString ()]++;
+		}
+		int same = 0, scanCount = 0;
+		myIter = supplierTableOutScan->getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			if (counts[temp->getAtt (0)->toString () + temp->getAtt (1)->toString ()]-- > 0)
+				same++;
+			scanCount++;
+		}
+		cout << "The index nested-loop join should give 413 * 32 = 13216 records: " << count << "\n";
+		cout << "The index nested-loop join and the scan join should both give the same " << scanCount << " records: " <<
+			indexCount << " " << same << "\n";
+	}
+
+	{
+		// two secondary indexes on the balance of a table in a small buffer pool, one of which also
+		// includes the name in its entries, so that it covers the query below
+		MyDB_BufferManagerPtr smallMgr = make_shared <MyDB_BufferManager> (8192, 16, "tempFile4");
+		MyDB_TablePtr myTableIndexed = make_shared <MyDB_Table> ("supplierIndexed", "supplierIndexed.bin", mySchemaL);
+		MyDB_TableReaderWriterPtr supplierTableIndexed = make_shared <MyDB_TableReaderWriter> (myTableIndexed, smallMgr);
+		MyDB_SecondaryIndexPtr byBal = make_shared <MyDB_SecondaryIndex> (MyDB_SecondaryIndex :: makeIndexTable (
+			"supplierByBal", "supplierByBal.bin", myTableIndexed, "l_acctbal", vector <string> ()),
+			*supplierTableIndexed, smallMgr);
+		MyDB_SecondaryIndexPtr byBalWithName = make_shared <MyDB_SecondaryIndex> (MyDB_SecondaryIndex :: makeIndexTable (
+			"supplierByBalWithName", "supplierByBalWithName.bin", myTableIndexed, "l_acctbal", vector <string> {"l_name"}),
+			*supplierTableIndexed, smallMgr);
+		supplierTableIndexed->addIndex (byBal);
+		supplierTableIndexed->addIndex (byBalWithName);
+		cout << "loading left table into a small buffer pool, and indexing it.\n";
+		supplierTableIndexed->loadFromTextFile ("supplier.tbl");
+
+		MyDB_SchemaPtr mySchemaOut = make_shared <MyDB_Schema> ();
+		mySchemaOut->appendAtt (make_pair ("l_name", make_shared <MyDB_StringAttType> ()));
+		mySchemaOut->appendAtt (make_pair ("l_acctbal", make_shared <MyDB_DoubleAttType> ()));
+		MyDB_TablePtr myTableOut = make_shared <MyDB_Table> ("supplierOut", "supplierOut.bin", mySchemaOut);
+		MyDB_TableReaderWriterPtr supplierTableOut = make_shared <MyDB_TableReaderWriter> (myTableOut, myMgr);
+		MyDB_TablePtr myTableOutAgain = make_shared <MyDB_Table> ("supplierOutAgain", "supplierOutAgain.bin", mySchemaOut);
+		MyDB_TableReaderWriterPtr supplierTableOutAgain = make_shared <MyDB_TableReaderWriter> (myTableOutAgain, myMgr);
+
+		// This basically runs:
+		//
+		// SELECT l_name, l_acctbal
+		// FROM supplierLeft
+		// WHERE l_acctbal >= 1000 AND l_acctbal <= 2000 AND l_name > "Supplier#000005000"
+		//
+		// once using each index, counting the pages that each one reads
+		vector <string> projections;
+		projections.push_back ("[l_name]");
+		projections.push_back ("[l_acctbal]");
+		MyDB_DoubleAttValPtr low = make_shared <MyDB_DoubleAttVal> ();
+		MyDB_DoubleAttValPtr high = make_shared <MyDB_DoubleAttVal> ();
+		low->set (1000.0);
+		high->set (2000.0);
+		BPlusSelection myOp (byBal, supplierTableOut, low, high,
+			"> ([l_name], string[Supplier#000005000])", projections);
+		BPlusSelection myOpAgain (byBalWithName, supplierTableOutAgain, low, high,
+			"> ([l_name], string[Supplier#000005000])", projections);
+		cout << "running selection using the index without the name\n";
+		size_t reads = smallMgr->getNumReads ();
+		myOp.run ();
+		size_t fetchReads = smallMgr->getNumReads () - reads;
+		cout << "running selection using the index with the name\n";
+		reads = smallMgr->getNumReads ();
+		myOpAgain.run ();
+		size_t coveringReads = smallMgr->getNumReads () - reads;
+		cout << "Only the second should be index-only (0 1): " << myOp.usedIndexOnly () << " " <<
+			myOpAgain.usedIndexOnly () << "\n";
+
+		// both should get the same records
+		MyDB_RecordPtr temp = supplierTableOut->getEmptyRecord ();
+		map <string, int> counts;
+		int count = 0, same = 0;
+		MyDB_RecordIteratorAltPtr myIter = supplierTableOut->getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			counts[temp->getAtt (0)->toString () + temp->getAtt (1)->toString ()]++;
+			count++;
+		}
+		myIter = supplierTableOutAgain->getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			if (counts[temp->getAtt (0)->toString () + temp->getAtt (1)->toString ()]-- > 0)
+				same++;
+		}
+		cout << "Both selections should give the same " << count << " records: " << same << "\n";
+		cout << "Pages read without the name included: " << fetchReads << "; with the name included: " <<
+			coveringReads << "\n";
+	}
+
 	{
 		vector <pair <MyDB_AggType, string>> aggsToCompute;
 		aggsToCompute.push_back (make_pair (MyDB_AggType :: avg, "* ([r_suppkey], double[1.0])"));
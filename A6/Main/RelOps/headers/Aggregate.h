@@ -7,12 +7,20 @@
 #include <utility>
 #include <vector>
 
-// This class encapulates a simple, hash-based aggregation + group by.  It does not
-// need to work when there is not enough space in the buffer manager to store all of
-// the groups.
+// This class encapulates an aggregation + group by.  There are two ways to run it.  The
+// hash-based aggregation keeps every group in pinned pages, and it does not need to work
+// when there is not enough space in the buffer manager to store all of the groups.  The
+// sort-based aggregation fills about half of the buffer pool with one partial aggregate per
+// input record, sorts them on the groupings, and collapses each group into one record as the
+// run is written out.  The runs are then merged (see mergeSortedRuns in Sorting.h), and the
+// partial aggregates of each group are combined as they come out of the merge, so only the
+// buffer pool is ever used.
 
 enum MyDB_AggType {sum, avg, cnt};
 
+// how the aggregation is run
+enum class MyDB_AggKind {Hash, Sort};
+
 class Aggregate {
 
 public:
@@ -47,19 +55,41 @@ public:
 	// Finally, input records are excluded from the computation if they are not 
 	// accepted by selectionPredicate.  This effectively acts like a WHERE clause.
 	//
+	// The aggregation is run using a hash table if the catalog's distinct value counts for the
+	// grouping attributes say that the groups will fit into half of the buffer pool, and by
+	// sorting otherwise.
+	//
 	Aggregate (MyDB_TableReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
 		vector <pair <MyDB_AggType, string>> aggsToCompute,
 		vector <string> groupings, string selectionPredicate);
 	
+	// just like the above, except that the aggregation is run as given by kind
+	Aggregate (MyDB_TableReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
+		vector <pair <MyDB_AggType, string>> aggsToCompute,
+		vector <string> groupings, string selectionPredicate, MyDB_AggKind kind);
+
 	// execute the aggregation
 	void run ();
 
+	// how the last call to run executed the aggregation
+	MyDB_AggKind getKindUsed ();
+
 	private:
+		// the two ways of running the aggregation
+		void runHash ();
+		void runSort ();
+
+		// picks hash or sort, using the catalog's statistics for the input table
+		MyDB_AggKind chooseKind ();
+
 		MyDB_TableReaderWriterPtr               input;
 		MyDB_TableReaderWriterPtr               output;
 		vector <pair <MyDB_AggType, string>>    aggsToCompute;
 		vector <string>                         groupings;
 		string                                  selectionPredicate;
+		bool                                    kindGiven;
+		MyDB_AggKind                            kind;
+		MyDB_AggKind                            kindUsed;
 };
 
 #endif
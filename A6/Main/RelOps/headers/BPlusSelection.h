@@ -4,6 +4,7 @@
 
 #include "MyDB_TableReaderWriter.h"
 #include "MyDB_BPlusTreeReaderWriter.h"
+#include "MyDB_SecondaryIndex.h"
 #include <string>
 #include <utility>
 #include <vector>
@@ -27,17 +28,31 @@ public:
 	BPlusSelection (MyDB_BPlusTreeReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
 		MyDB_AttValPtr low, MyDB_AttValPtr high,
 		string selectionPredicate, vector <string> projections);
+
+	// the same, except that the records come from the table indexed by a secondary index (see
+	// MyDB_SecondaryIndex.h), and it is the index's att that has to be between low and high.  The
+	// records are fetched in the order that they are stored in the table.  If the index covers the
+	// predicate and all of the projections (see MyDB_SecondaryIndex :: covers), then the table is
+	// not read at all, and the output is computed from the index's entries, in key order
+	BPlusSelection (MyDB_SecondaryIndexPtr index, MyDB_TableReaderWriterPtr output,
+		MyDB_AttValPtr low, MyDB_AttValPtr high,
+		string selectionPredicate, vector <string> projections);
 	
 	// execute the selection operation
 	void run ();
 
+	// after run () is called, tells whether the records came from the index alone
+	bool usedIndexOnly ();
+
 	private: 
 		MyDB_BPlusTreeReaderWriterPtr input;
+		MyDB_SecondaryIndexPtr index;
 		MyDB_TableReaderWriterPtr output;
 		MyDB_AttValPtr low;
 		MyDB_AttValPtr high;
 		string selectionPredicate;
 		vector <string> projections;
+		bool indexOnly;
 };
 
 #endif
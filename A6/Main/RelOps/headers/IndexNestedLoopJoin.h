@@ -0,0 +1,56 @@
+
+#ifndef INDEX_NESTED_LOOP_JOIN_H
+#define INDEX_NESTED_LOOP_JOIN_H
+
+#include "MyDB_TableReaderWriter.h"
+#include "MyDB_BPlusTreeReaderWriter.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+// This class encapsulates an index nested-loop join, where the right input is a B+-Tree
+// whose sort att is one side of an equality in the join predicate.  The left input is
+// scanned, and instead of hashing it or scanning the right input, the tree is probed for
+// the matches to each left record.  The left records are read in batches that fill about
+// a quarter of the buffer pool, and each batch is looked up in the tree in key order (see
+// MyDB_BPlusTreeReaderWriter :: lookup), so that the probes walk down the tree from left to
+// right, and each leaf is read at most once per batch.  This is the join to use when the
+// left input (after its selection) is small, and the right input is big: only the leaves
+// that have a match are ever read.
+//
+class IndexNestedLoopJoin {
+
+public:
+	// This creates an index nested-loop join of the tables managed by leftInput and rightInput;
+	// the output records are created from a record from leftInput followed by a record from
+	// rightInput, just like in a ScanJoin (see ScanJoin.h).
+	//
+	// The string leftKey encodes the computation over the left records whose value has to be
+	// equal to the sort att of rightInput; the records that match it are found in the tree.
+	// For example, if rightInput is sorted on r_suppkey, we could use "[l_suppkey]".  The
+	// equality itself should also be part of finalSelectionPredicate.
+	//
+	// finalSelectionPredicate, projections, leftSelectionPredicate and rightSelectionPredicate
+	// are the same as for a ScanJoin.
+	//
+	IndexNestedLoopJoin (MyDB_TableReaderWriterPtr leftInput, MyDB_BPlusTreeReaderWriterPtr rightInput,
+		MyDB_TableReaderWriterPtr output, string finalSelectionPredicate,
+		vector <string> projections, string leftKey, string leftSelectionPredicate,
+		string rightSelectionPredicate);
+
+	// execute the join
+	void run ();
+
+private:
+
+	MyDB_TableReaderWriterPtr leftTable;
+	MyDB_BPlusTreeReaderWriterPtr rightTable;
+	MyDB_TableReaderWriterPtr output;
+	string finalSelectionPredicate;
+	vector <string> projections;
+	string leftKey;
+	string leftSelectionPredicate;
+	string rightSelectionPredicate;
+};
+
+#endif
@@ -0,0 +1,66 @@
+
+#ifndef TOP_N_H
+#define TOP_N_H
+
+#include "MyDB_TableReaderWriter.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+// This class encapsulates a top-N query, such as:
+//
+// SELECT name, acctbal
+// FROM input
+// WHERE selectionPredicate
+// ORDER BY acctbal DESC
+// LIMIT N
+//
+// The input is scanned one time, and the best N records seen so far are kept in a bounded
+// heap, ordered on the normalized key of each record (see MyDB_KeyNormalizer.h), with the
+// worst of them on top; a record that is not better than that one is never copied.  The
+// records themselves live in pinned anonymous pages, using about half of the buffer pool.
+// Records that are pushed out of the heap leave holes behind, so the pages are split into
+// two halves, and when one half fills up, the records still in the heap are copied into
+// the other half.  If N records do not fit into one half, then the operator falls back to
+// an external sort of the input (see Sorting.h), and the first N sorted records are taken.
+//
+class TopN {
+
+public:
+	//
+	// The string selectionPredicate encodes the predicate over the input records.
+	//
+	// The string sortKey is the computation that the records are ordered on (ex:
+	// "[acctbal]"); if descending is true, the N records with the largest keys are
+	// kept, and otherwise, the N records with the smallest keys are.
+	//
+	// The vector projections contains all of the computations that are performed
+	// to create the output records.  The output records are written in sorted order.
+	//
+	TopN (MyDB_TableReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
+		string selectionPredicate, vector <string> projections, string sortKey,
+		bool descending, int n):
+		input{input}, output{output}, selectionPredicate{selectionPredicate}, projections{projections},
+		sortKey{sortKey}, descending{descending}, n{n} {}
+
+	// execute the operation
+	void run ();
+
+	// true if the last call to run had to fall back to an external sort
+	bool usedExternalSort ();
+
+private:
+	MyDB_TableReaderWriterPtr input;
+	MyDB_TableReaderWriterPtr output;
+	string selectionPredicate;
+	vector <string> projections;
+	string sortKey;
+	bool descending;
+	int n;
+	bool fellBack = false;
+
+	// runs the query using an external sort; called when the heap does not fit
+	void runWithSort ();
+};
+
+#endif
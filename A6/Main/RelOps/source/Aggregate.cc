@@ -6,6 +6,7 @@
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_TableReaderWriter.h"
 #include "Aggregate.h"
+#include "Sorting.h"
 #include <map>
 
 using namespace std;
@@ -22,9 +23,260 @@ Aggregate :: Aggregate (
         this->aggsToCompute = aggsToCompute;
         this->groupings = groupings;
         this->selectionPredicate = selectionPredicate;
+        this->kindGiven = false;
+        this->kind = MyDB_AggKind :: Hash;
+        this->kindUsed = MyDB_AggKind :: Hash;
     }
 
+Aggregate :: Aggregate (
+    MyDB_TableReaderWriterPtr               input, 
+    MyDB_TableReaderWriterPtr               output,
+    vector <pair <MyDB_AggType, string>>    aggsToCompute,
+    vector <string>                         groupings, 
+    string                                  selectionPredicate,
+    MyDB_AggKind                            kind
+) : Aggregate (input, output, aggsToCompute, groupings, selectionPredicate) {
+        this->kindGiven = true;
+        this->kind = kind;
+    }
+
+MyDB_AggKind Aggregate :: getKindUsed () {
+    return this->kindUsed;
+}
+
 void Aggregate :: run () {
+    this->kindUsed = this->kindGiven ? this->kind : chooseKind ();
+    if (this->kindUsed == MyDB_AggKind :: Sort)
+        runSort ();
+    else
+        runHash ();
+}
+
+MyDB_AggKind Aggregate :: chooseKind () {
+
+    // with no groupings, there is only one group
+    MyDB_TablePtr table = input->getTable ();
+    size_t numTuples = table->getTupleCount ();
+    if (groupings.size () == 0 || numTuples == 0)
+        return MyDB_AggKind :: Hash;
+
+    // estimate the number of groups; a grouping that is not just an attribute could have
+    // as many values as there are records
+    size_t numGroups = 1;
+    for (auto &g : groupings) {
+        size_t start = g.find_first_not_of (" \t");
+        size_t end = g.find_last_not_of (" \t");
+        size_t distinct = numTuples;
+        if (start != string :: npos && g[start] == '[' && g[end] == ']' && 
+            table->getSchema ()->getAttByName (g.substr (start + 1, end - start - 1)).first != -1)
+            distinct = table->getDistinctValues (g.substr (start + 1, end - start - 1));
+        numGroups = (distinct > numTuples / numGroups) ? numTuples : numGroups * distinct;
+    }
+
+    // and see if that many groups (counting each as big as an average input record) would fit
+    // into the half of the buffer that the hash table gets
+    size_t pageSize = input->getBufferMgr ()->getPageSize ();
+    size_t bytesPerRecord = input->getNumPages () * pageSize / numTuples + 1;
+    size_t budget = input->getBufferMgr ()->numPages / 2 * pageSize;
+    if (numGroups * bytesPerRecord <= budget)
+        return MyDB_AggKind :: Hash;
+    return MyDB_AggKind :: Sort;
+}
+
+void Aggregate :: runSort () {
+
+    MyDB_BufferManagerPtr mgr = input->getBufferMgr ();
+    size_t runSize = mgr->numPages / 2;
+    if (runSize < 1)
+        runSize = 1;
+    int numGroups = groupings.size ();
+
+    // the partial aggregate of a group has all of the output attributes, plus a count; a sum or
+    // an average holds the sum so far, and a count holds the count so far
+    MyDB_SchemaPtr aggSchema = make_shared <MyDB_Schema> ();
+    for (auto &p : output->getTable ()->getSchema ()->getAtts ())
+        aggSchema->appendAtt (p);
+    string countName = "COUNT";
+    aggSchema->appendAtt (make_pair (countName, make_shared <MyDB_IntAttType> ()));
+    vector <pair <string, MyDB_AttTypePtr>> aggAttributes = aggSchema->getAtts ();
+
+    // two partial aggregates are combined using a record made from both of them, where the
+    // attributes of the second one are renamed
+    MyDB_SchemaPtr combinedSchema = make_shared <MyDB_Schema> ();
+    for (auto &p : aggAttributes)
+        combinedSchema->appendAtt (p);
+    for (auto &p : aggAttributes)
+        combinedSchema->appendAtt (make_pair ("other_" + p.first, p.second));
+
+    MyDB_RecordPtr aggRec = make_shared <MyDB_Record> (aggSchema);
+    MyDB_RecordPtr otherRec = make_shared <MyDB_Record> (aggSchema);
+    MyDB_RecordPtr combinedRec = make_shared <MyDB_Record> (combinedSchema);
+    combinedRec->buildFrom (aggRec, otherRec);
+
+    // the partial aggregate of a single input record
+    MyDB_RecordPtr inputRec = input->getEmptyRecord ();
+    vector <func> groupingFuncs;
+    for (auto &g : groupings)
+        groupingFuncs.push_back (inputRec->compileComputation (g));
+    vector <func> initialFuncs;
+    for (auto &agg : aggsToCompute) {
+        if (agg.first == MyDB_AggType :: cnt)
+            initialFuncs.push_back (inputRec->compileComputation ("int[1]"));
+        else
+            initialFuncs.push_back (inputRec->compileComputation (agg.second));
+    }
+    initialFuncs.push_back (inputRec->compileComputation ("int[1]"));
+
+    // combining two partial aggregates of the same group just adds them up
+    vector <func> combineFuncs;
+    for (size_t i = numGroups; i < aggAttributes.size (); i++)
+        combineFuncs.push_back (combinedRec->compileComputation ("+ ([" + aggAttributes[i].first + "], [other_" + 
+            aggAttributes[i].first + "])"));
+
+    // checks whether two partial aggregates are in the same group, and orders them
+    string sameGroup = "bool[true]";
+    string lessThan = "bool[false]";
+    for (int i = numGroups - 1; i >= 0; i--) {
+        string name = aggAttributes[i].first;
+        string eq = "== ([" + name + "], [other_" + name + "])";
+        string lt = "< ([" + name + "], [other_" + name + "])";
+        sameGroup = (i == numGroups - 1) ? eq : "&& (" + eq + ", " + sameGroup + ")";
+        lessThan = (i == numGroups - 1) ? lt : "|| (" + lt + ", && (" + eq + ", " + lessThan + "))";
+    }
+    func sameGroupFunc = combinedRec->compileComputation (sameGroup);
+
+    // a single grouping is sorted using its normalized key, and more than one using a comparator
+    MyDB_RecordPtr lhs = make_shared <MyDB_Record> (aggSchema);
+    MyDB_RecordPtr rhs = make_shared <MyDB_Record> (aggSchema);
+    MyDB_KeyNormalizerPtr keys;
+    if (numGroups == 1) {
+        keys = make_shared <MyDB_KeyNormalizer> (lhs, rhs, "[" + aggAttributes[0].first + "]");
+    } else {
+        MyDB_RecordPtr lhsAndRhs = make_shared <MyDB_Record> (combinedSchema);
+        lhsAndRhs->buildFrom (lhs, rhs);
+        func lessThanFunc = lhsAndRhs->compileComputation (lessThan);
+        keys = make_shared <MyDB_KeyNormalizer> ([lessThanFunc, lhsAndRhs] {return lessThanFunc ()->toBool ();}, lhs, rhs);
+    }
+
+    // the final aggregates
+    vector <func> finalFuncs;
+    for (size_t i = 0; i < aggsToCompute.size (); i++) {
+        string name = aggAttributes[i + numGroups].first;
+        if (aggsToCompute[i].first == MyDB_AggType :: avg)
+            finalFuncs.push_back (aggRec->compileComputation ("/ ([" + name + "], [" + countName + "])"));
+        else
+            finalFuncs.push_back (aggRec->compileComputation ("[" + name + "]"));
+    }
+
+    // the group being built up is in aggRec; once it is done, it is either written to the last
+    // run, or (during the final merge) to the output
+    vector <vector <MyDB_PageReaderWriter>> runs;
+    MyDB_RecordPtr outRec = output->getEmptyRecord ();
+    bool haveGroup = false;
+    auto finishGroup = [&] (bool toRun) {
+        if (toRun) {
+            aggRec->recordContentHasChanged ();
+            if (runs.back ().empty () || !runs.back ().back ().append (aggRec)) {
+                runs.back ().push_back (MyDB_PageReaderWriter (*mgr));
+                runs.back ().back ().append (aggRec);
+            }
+            return;
+        }
+        int i;
+        for (i = 0; i < numGroups; i++)
+            outRec->getAtt (i)->set (aggRec->getAtt (i));
+        for (auto &f : finalFuncs)
+            outRec->getAtt (i++)->set (f ());
+        outRec->recordContentHasChanged ();
+        output->append (outRec);
+    };
+
+    // adds the partial aggregate in otherRec to the group being built up (the partial
+    // aggregates come in sorted order, so when the group changes, the old one is done)
+    auto addPartial = [&] (bool toRun) {
+        if (haveGroup && sameGroupFunc ()->toBool ()) {
+            for (size_t i = 0; i < combineFuncs.size (); i++)
+                aggRec->getAtt (i + numGroups)->set (combineFuncs[i] ());
+            return;
+        }
+        if (haveGroup)
+            finishGroup (toRun);
+        for (size_t i = 0; i < aggAttributes.size (); i++)
+            aggRec->getAtt (i)->set (otherRec->getAtt (i));
+        haveGroup = true;
+    };
+
+    // the partial aggregates of the input records are put into up to runSize pinned pages; when
+    // they are full, the partial aggregates are sorted and collapsed into a run
+    vector <MyDB_PageReaderWriter> buffer;
+    buffer.push_back (MyDB_PageReaderWriter (true, *mgr));
+    size_t lastPage = 0;
+    auto writeRun = [&] () {
+        vector <pair <MyDB_NormalizedKey, void *>> positions, pagePositions;
+        vector <char> rows;
+        for (size_t i = 0; i <= lastPage; i++) {
+            pagePositions.clear ();
+            MyDB_PageReaderWriter :: getKeys (buffer[i].getBytes (), buffer[i].getPageSize (), keys, pagePositions, rows);
+            positions.insert (positions.end (), pagePositions.begin (), pagePositions.end ());
+        }
+        keys->sort (positions);
+
+        runs.push_back (vector <MyDB_PageReaderWriter> ());
+        for (auto &pos : positions) {
+            otherRec->fromBinary (pos.second);
+            addPartial (true);
+        }
+        if (haveGroup)
+            finishGroup (true);
+        haveGroup = false;
+
+        for (size_t i = 0; i <= lastPage; i++)
+            buffer[i].clear ();
+        lastPage = 0;
+    };
+
+    func pred = inputRec->compileComputation (selectionPredicate);
+    MyDB_RecordPtr partialRec = make_shared <MyDB_Record> (aggSchema);
+    MyDB_RecordIteratorAltPtr iter = input->getIteratorAlt ();
+    while (iter->advance ()) {
+        iter->getCurrent (inputRec);
+        if (!pred ()->toBool ())
+            continue;
+
+        for (int i = 0; i < numGroups; i++)
+            partialRec->getAtt (i)->set (groupingFuncs[i] ());
+        for (size_t i = 0; i < initialFuncs.size (); i++)
+            partialRec->getAtt (i + numGroups)->set (initialFuncs[i] ());
+        partialRec->recordContentHasChanged ();
+
+        if (buffer[lastPage].append (partialRec))
+            continue;
+        if (lastPage + 1 < runSize) {
+            lastPage++;
+            if (lastPage == buffer.size ())
+                buffer.push_back (MyDB_PageReaderWriter (true, *mgr));
+        } else {
+            writeRun ();
+        }
+        buffer[lastPage].append (partialRec);
+    }
+    if (lastPage > 0 || buffer[0].getNumRecords () > 0)
+        writeRun ();
+
+    // let go of the pinned pages, and merge the runs, finishing up the groups as they come out
+    buffer.clear ();
+    if (runs.size () == 0)
+        return;
+    MyDB_RecordIteratorAltPtr merged = mergeSortedRuns (runSize, mgr, runs, keys);
+    while (merged->advance ()) {
+        merged->getCurrent (otherRec);
+        addPartial (false);
+    }
+    if (haveGroup)
+        finishGroup (false);
+}
+
+void Aggregate :: runHash () {
     map <size_t, void *> myHash;
     // get all of the pages and pin them
     vector <MyDB_PageReaderWriter> allPages;
@@ -14,14 +14,43 @@ BPlusSelection :: BPlusSelection (MyDB_BPlusTreeReaderWriterPtr input, MyDB_Tabl
                     this->high = high;
                     this->selectionPredicate = selectionPredicate;
                     this->projections = projections;
+                    this->indexOnly = false;
+                }
+
+BPlusSelection :: BPlusSelection (MyDB_SecondaryIndexPtr index, MyDB_TableReaderWriterPtr output,
+                MyDB_AttValPtr low, MyDB_AttValPtr high,
+                string selectionPredicate, vector <string> projections)
+                {
+                    this->index = index;
+                    this->output = output;
+                    this->low = low;
+                    this->high = high;
+                    this->selectionPredicate = selectionPredicate;
+                    this->projections = projections;
+                    this->indexOnly = false;
                 }
 
 void BPlusSelection :: run () {
-    // get the input record
-    MyDB_RecordPtr inputRec = input->getEmptyRecord ();
+    // get the input record, and all the records in the specified range
+    MyDB_RecordPtr inputRec;
+    MyDB_RecordIteratorAltPtr iter;
+    if (index != nullptr) {
+        // see if we can get away with only reading the index
+        this->indexOnly = index->covers (selectionPredicate);
+        for (auto& projection : this->projections)
+            this->indexOnly = this->indexOnly && index->covers (projection);
+    }
 
-    // get all the records in the specified range
-    MyDB_RecordIteratorAltPtr iter = input->getRangeIteratorAlt(low, high);
+    if (this->indexOnly) {
+        inputRec = index->getTree ()->getEmptyRecord ();
+        iter = index->getTree ()->getRangeIteratorAlt (low, high);
+    } else if (index != nullptr) {
+        inputRec = index->getBaseTable ().getEmptyRecord ();
+        iter = index->getRangeIteratorAlt(low, high);
+    } else {
+        inputRec = input->getEmptyRecord ();
+        iter = input->getRangeIteratorAlt(low, high);
+    }
 
     // get the predicate
     func pred = inputRec->compileComputation (selectionPredicate);
@@ -53,4 +82,8 @@ void BPlusSelection :: run () {
     }
 }
 
+bool BPlusSelection :: usedIndexOnly () {
+    return this->indexOnly;
+}
+
 #endif
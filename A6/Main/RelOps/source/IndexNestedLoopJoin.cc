@@ -0,0 +1,98 @@
+
+#ifndef INDEX_NESTED_LOOP_JOIN_C
+#define INDEX_NESTED_LOOP_JOIN_C
+
+#include "IndexNestedLoopJoin.h"
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_Record.h"
+
+IndexNestedLoopJoin :: IndexNestedLoopJoin (MyDB_TableReaderWriterPtr leftInput, MyDB_BPlusTreeReaderWriterPtr rightInput,
+                MyDB_TableReaderWriterPtr output, string finalSelectionPredicate,
+                vector <string> projections, string leftKey, string leftSelectionPredicate,
+                string rightSelectionPredicate) {
+                    this->leftTable = leftInput;
+                    this->rightTable = rightInput;
+                    this->output = output;
+                    this->finalSelectionPredicate = finalSelectionPredicate;
+                    this->projections = projections;
+                    this->leftKey = leftKey;
+                    this->leftSelectionPredicate = leftSelectionPredicate;
+                    this->rightSelectionPredicate = rightSelectionPredicate;
+                }
+
+void IndexNestedLoopJoin :: run () {
+
+    MyDB_RecordPtr leftRecord = this->leftTable->getEmptyRecord();
+    MyDB_RecordPtr rightRecord = this->rightTable->getEmptyRecord();
+    func leftPred = leftRecord->compileComputation(this->leftSelectionPredicate);
+    func rightPred = rightRecord->compileComputation(this->rightSelectionPredicate);
+    func leftKeyComp = leftRecord->compileComputation(this->leftKey);
+
+    // the combined record, along with the final predicate and the projections over it
+    MyDB_SchemaPtr combinedSchema = make_shared<MyDB_Schema>();
+    for (auto &p : this->leftTable->getTable()->getSchema()->getAtts())
+        combinedSchema->appendAtt(p);
+    for (auto &p : this->rightTable->getTable()->getSchema()->getAtts())
+        combinedSchema->appendAtt(p);
+    MyDB_RecordPtr combinedRecord = make_shared<MyDB_Record>(combinedSchema);
+    combinedRecord->buildFrom(leftRecord, rightRecord);
+    func finalPred = combinedRecord->compileComputation(this->finalSelectionPredicate);
+    vector<func> computations;
+    for (auto &projection : this->projections)
+        computations.push_back(combinedRecord->compileComputation(projection));
+    MyDB_RecordPtr outputRecord = this->output->getEmptyRecord();
+
+    // the left records in the current batch live in pinned anonymous pages
+    size_t batchPages = this->leftTable->getBufferMgr()->numPages / 4;
+    if (batchPages < 1)
+        batchPages = 1;
+    vector<MyDB_PageReaderWriter> batch;
+    vector<void *> locations;
+    vector<MyDB_AttValPtr> keys;
+
+    // looks up the batch in the tree, and writes out the matches
+    auto probe = [&]() {
+        this->rightTable->lookup(keys, rightRecord, [&](size_t which) {
+            if (!rightPred()->toBool())
+                return;
+            leftRecord->fromBinary(locations[which]);
+            if (!finalPred()->toBool())
+                return;
+            int i = 0;
+            for (auto &computation : computations)
+                outputRecord->getAtt(i++)->set(computation());
+            outputRecord->recordContentHasChanged();
+            this->output->append(outputRecord);
+        });
+        keys.clear();
+        locations.clear();
+        if (batch.size() > 1)
+            batch.erase(batch.begin() + 1, batch.end());
+        if (!batch.empty())
+            batch[0].clear();
+    };
+
+    MyDB_RecordIteratorAltPtr iterator = this->leftTable->getIteratorAlt();
+    while (iterator->advance()) {
+        iterator->getCurrent(leftRecord);
+        if (!leftPred()->toBool())
+            continue;
+
+        // remember the record; if the batch is full, probe the tree with it first
+        void *location = batch.empty() ? nullptr : batch.back().appendAndReturnLocation(leftRecord);
+        if (location == nullptr) {
+            if (batch.size() == batchPages)
+                probe();
+            if (batch.empty() || batch.back().getNumRecords() > 0)
+                batch.push_back(MyDB_PageReaderWriter(true, *this->leftTable->getBufferMgr()));
+            location = batch.back().appendAndReturnLocation(leftRecord);
+        }
+        locations.push_back(location);
+        keys.push_back(leftKeyComp()->getCopy());
+    }
+
+    if (!keys.empty())
+        probe();
+}
+
+#endif
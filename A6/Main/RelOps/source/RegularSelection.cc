@@ -2,10 +2,40 @@
 #ifndef REG_SELECTION_C                                        
 #define REG_SELECTION_C
 
+#include <ctype.h>
 #include "RegularSelection.h"
 
+// adds the index of every attribute named in the computation (ex: "[suppkey]") to atts; a
+// '[' that follows a type name starts the value of a literal (ex: "string [abc]"), not a name
+static void findAtts(string &computation, MyDB_SchemaPtr schema, set<int> &atts) {
+    for (size_t pos = computation.find('['); pos != string::npos; pos = computation.find('[', pos)) {
+        size_t end = computation.find(']', pos);
+        if (end == string::npos)
+            return;
+        size_t before = pos;
+        while (before > 0 && isspace(computation[before - 1]))
+            before--;
+        if (before == 0 || !isalpha(computation[before - 1])) {
+            int whichAtt = schema->getAttByName(computation.substr(pos + 1, end - pos - 1)).first;
+            if (whichAtt != -1)
+                atts.insert(whichAtt);
+        }
+        pos = end + 1;
+    }
+}
+
 void RegularSelection :: run () {
-    MyDB_RecordIteratorAltPtr iterator = this->input->getIteratorAlt();
+
+    // the pages whose zones show that they have no matching records are never read; for a
+    // PAX file, the filter is also run over the minipages, and only the attributes that the
+    // selection and the projections use are loaded
+    MyDB_ZoneFilterPtr filter = make_shared<MyDB_ZoneFilter>(this->selectionPredicate, this->input->getTable());
+    set<int> usedAtts;
+    findAtts(this->selectionPredicate, this->input->getTable()->getSchema(), usedAtts);
+    for (auto& projection : this->projections)
+        findAtts(projection, this->input->getTable()->getSchema(), usedAtts);
+    vector<int> whichAtts(usedAtts.begin(), usedAtts.end());
+    MyDB_RecordIteratorAltPtr iterator = this->input->getIteratorAlt(filter, whichAtts);
     MyDB_RecordPtr inRecord = this->input->getEmptyRecord();
     MyDB_RecordPtr outRecord = this->output->getEmptyRecord();
 
@@ -6,6 +6,7 @@
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_TableReaderWriter.h"
 #include "ScanJoin.h"
+#include <list>
 #include <unordered_map>
 
 using namespace std;
@@ -56,6 +57,9 @@ void ScanJoin :: run () {
 	// of the records with that hsah value are located
 	unordered_map <size_t, vector <void *>> myHash;
 
+	// the copies of the records that are in the hash table, but not on a page
+	list <vector <char>> copies;
+
 	// get all of the pages
 	vector <MyDB_PageReaderWriter> allData;
 	for (int i = 0; i < leftTable->getNumPages (); i++) {
@@ -95,8 +99,15 @@ void ScanJoin :: run () {
 			hashVal ^= f ()->hash ();
 		}
 
-		// see if it is in the hash table
-		myHash [hashVal].push_back (myIter->getCurrentPointer ());
+		// see if it is in the hash table... a record on a PAX page has no location, so a
+		// copy of it is made instead
+		void *location = myIter->getCurrentPointer ();
+		if (location == nullptr) {
+			copies.emplace_back (leftInputRec->getBinarySize ());
+			leftInputRec->toBinary (copies.back ().data ());
+			location = copies.back ().data ();
+		}
+		myHash [hashVal].push_back (location);
 	}
 
 	// and now we iterate through the other table
@@ -29,14 +29,14 @@ void SortMergeJoin :: run () {
     // Sort the left table
     MyDB_RecordPtr leftRecord = this->leftTable->getEmptyRecord();
     MyDB_RecordPtr rightRecord = this->leftTable->getEmptyRecord();
-    function <bool ()> comparator = buildRecordComparator(leftRecord, rightRecord, this->equalityCheck.first);
-    MyDB_RecordIteratorAltPtr leftq = buildItertorOverSortedRuns(this->leftTable->getBufferMgr()->numPages / 2, *this->leftTable, comparator, leftRecord, rightRecord, this->leftSelectionPredicate);
+    MyDB_KeyNormalizerPtr keys = make_shared<MyDB_KeyNormalizer>(leftRecord, rightRecord, this->equalityCheck.first);
+    MyDB_RecordIteratorAltPtr leftq = buildItertorOverSortedRuns(this->leftTable->getBufferMgr()->numPages / 2, *this->leftTable, keys, this->leftSelectionPredicate);
 
     // Sort the right table
     leftRecord = this->rightTable->getEmptyRecord();
     rightRecord = this->rightTable->getEmptyRecord();
-    comparator = buildRecordComparator(leftRecord, rightRecord, this->equalityCheck.second);
-    MyDB_RecordIteratorAltPtr rightq = buildItertorOverSortedRuns(this->rightTable->getBufferMgr()->numPages / 2, *this->rightTable, comparator, leftRecord, rightRecord, this->rightSelectionPredicate);
+    keys = make_shared<MyDB_KeyNormalizer>(leftRecord, rightRecord, this->equalityCheck.second);
+    MyDB_RecordIteratorAltPtr rightq = buildItertorOverSortedRuns(this->rightTable->getBufferMgr()->numPages / 2, *this->rightTable, keys, this->rightSelectionPredicate);
 
     leftRecord = this->leftTable->getEmptyRecord();
     rightRecord = this->rightTable->getEmptyRecord();
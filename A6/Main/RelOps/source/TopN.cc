@@ -0,0 +1,189 @@
+
+#ifndef TOP_N_C
+#define TOP_N_C
+
+#include <algorithm>
+#include "MyDB_KeyNormalizer.h"
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_Record.h"
+#include "Sorting.h"
+#include "TopN.h"
+
+// one of the records in the heap: its normalized key and where it is stored
+struct TopNEntry {
+    MyDB_NormalizedKey key;
+    void *loc;
+};
+
+bool TopN :: usedExternalSort () {
+    return this->fellBack;
+}
+
+void TopN :: run () {
+
+    this->fellBack = false;
+    if (this->n <= 0)
+        return;
+
+    MyDB_RecordPtr lhs = this->input->getEmptyRecord();
+    MyDB_RecordPtr rhs = this->input->getEmptyRecord();
+    MyDB_RecordPtr inRecord = this->input->getEmptyRecord();
+    MyDB_RecordPtr moveRecord = this->input->getEmptyRecord();
+    MyDB_KeyNormalizerPtr keys = make_shared<MyDB_KeyNormalizer>(lhs, rhs, this->sortKey);
+    func pred = lhs->compileComputation(this->selectionPredicate);
+
+    // true if a comes before b in the output
+    bool descending = this->descending;
+    auto before = [&](const TopNEntry &a, const TopNEntry &b) {
+        const TopNEntry &first = descending ? b : a;
+        const TopNEntry &second = descending ? a : b;
+        bool isLess;
+        if (MyDB_KeyNormalizer :: keysDecide(first.key, second.key, isLess))
+            return isLess;
+        lhs->fromBinary(first.loc);
+        rhs->fromBinary(second.loc);
+        return keys->compare();
+    };
+
+    // the two halves of the pinned pages that the records are stored in
+    size_t halfPages = this->input->getBufferMgr()->numPages / 4;
+    if (halfPages < 1)
+        halfPages = 1;
+    vector<MyDB_PageReaderWriter> spaces[2];
+    int cur = 0;
+
+    // appends the record to the current half; returns nullptr if it is full
+    auto appendToSpace = [&](int which, MyDB_RecordPtr appendMe) -> void * {
+        vector<MyDB_PageReaderWriter> &space = spaces[which];
+        void *loc = space.empty() ? nullptr : space.back().appendAndReturnLocation(appendMe);
+        if (loc == nullptr && space.size() < halfPages) {
+            space.push_back(MyDB_PageReaderWriter(true, *this->input->getBufferMgr()));
+            loc = space.back().appendAndReturnLocation(appendMe);
+        }
+        return loc;
+    };
+
+    // empties out a half, keeping only its first page
+    auto clearSpace = [&](int which) {
+        vector<MyDB_PageReaderWriter> &space = spaces[which];
+        if (space.size() > 1)
+            space.erase(space.begin() + 1, space.end());
+        if (!space.empty())
+            space[0].clear();
+    };
+
+    // copies the records that are still in the heap into the other half, which is then the
+    // current one; returns false if they do not all fit.  This uses its own record, so that
+    // inRecord still holds the record that did not fit
+    vector<TopNEntry> heap;
+    auto collect = [&]() {
+        int other = 1 - cur;
+        clearSpace(other);
+        for (auto &entry : heap) {
+            moveRecord->fromBinary(entry.loc);
+            entry.loc = appendToSpace(other, moveRecord);
+            if (entry.loc == nullptr)
+                return false;
+        }
+        clearSpace(cur);
+        cur = other;
+        return true;
+    };
+
+    // a record that only ties the worst record in the heap on its key is written here, so
+    // that the two records can be compared
+    vector<char> scratch;
+
+    MyDB_RecordIteratorAltPtr iterator = this->input->getIteratorAlt();
+    while (iterator->advance()) {
+        iterator->getCurrent(lhs);
+        if (!pred()->toBool())
+            continue;
+
+        TopNEntry candidate;
+        keys->getLHSKey(candidate.key);
+        candidate.loc = nullptr;
+
+        // if the heap is full, the record has to beat the worst record in it
+        if (heap.size() == (size_t) this->n) {
+            bool isLess;
+            const TopNEntry &first = descending ? heap.front() : candidate;
+            const TopNEntry &second = descending ? candidate : heap.front();
+            if (!MyDB_KeyNormalizer :: keysDecide(first.key, second.key, isLess)) {
+                scratch.resize(lhs->getBinarySize());
+                lhs->toBinary(scratch.data());
+                candidate.loc = scratch.data();
+                isLess = before(candidate, heap.front());
+            }
+            if (!isLess)
+                continue;
+            pop_heap(heap.begin(), heap.end(), before);
+            heap.pop_back();
+        }
+
+        // remember the record
+        iterator->getCurrent(inRecord);
+        candidate.loc = appendToSpace(cur, inRecord);
+        if (candidate.loc == nullptr) {
+            if (!collect() || (candidate.loc = appendToSpace(cur, inRecord)) == nullptr) {
+                heap.clear();
+                spaces[0].clear();
+                spaces[1].clear();
+                runWithSort();
+                return;
+            }
+        }
+        heap.push_back(candidate);
+        push_heap(heap.begin(), heap.end(), before);
+    }
+
+    // write out the records, best first
+    sort_heap(heap.begin(), heap.end(), before);
+    MyDB_RecordPtr outRecord = this->output->getEmptyRecord();
+    vector<func> computations;
+    for (auto &projection : this->projections)
+        computations.push_back(inRecord->compileComputation(projection));
+
+    for (auto &entry : heap) {
+        inRecord->fromBinary(entry.loc);
+        int i = 0;
+        for (auto &computation : computations)
+            outRecord->getAtt(i++)->set(computation());
+        outRecord->recordContentHasChanged();
+        this->output->append(outRecord);
+    }
+}
+
+void TopN :: runWithSort () {
+
+    this->fellBack = true;
+
+    // a descending sort swaps the records given to the comparator
+    MyDB_RecordPtr lhs = this->input->getEmptyRecord();
+    MyDB_RecordPtr rhs = this->input->getEmptyRecord();
+    MyDB_KeyNormalizerPtr keys;
+    if (this->descending)
+        keys = make_shared<MyDB_KeyNormalizer>(buildRecordComparator(rhs, lhs, this->sortKey), lhs, rhs);
+    else
+        keys = make_shared<MyDB_KeyNormalizer>(lhs, rhs, this->sortKey);
+
+    MyDB_RecordIteratorAltPtr iterator = buildItertorOverSortedRuns(this->input->getBufferMgr()->numPages / 2,
+        *this->input, keys, this->selectionPredicate);
+
+    MyDB_RecordPtr inRecord = this->input->getEmptyRecord();
+    MyDB_RecordPtr outRecord = this->output->getEmptyRecord();
+    vector<func> computations;
+    for (auto &projection : this->projections)
+        computations.push_back(inRecord->compileComputation(projection));
+
+    for (int count = 0; count < this->n && iterator->advance(); count++) {
+        iterator->getCurrent(inRecord);
+        int i = 0;
+        for (auto &computation : computations)
+            outRecord->getAtt(i++)->set(computation());
+        outRecord->recordContentHasChanged();
+        this->output->append(outRecord);
+    }
+}
+
+#endif
@@ -5,7 +5,12 @@ friend struct SFWQuery *makeQueryNoWhere (struct ValueList *selectClause, struct
 friend struct SQLStatement *makeSelectQuery (struct SFWQuery *fromMe);
 friend struct SQLStatement *makeCreateTable (struct CreateTable *fromMe);
 friend struct CreateTable *makeTableRegular (char *tableName, struct AttList *fromMe);
+friend struct CreateTable *makeTableWithFormat (char *tableName, struct AttList *fromMe, char *pageFormat);
 friend struct CreateTable *makeTableBPlusTree (char *tableName, struct AttList *fromMe, char *attName);
+friend struct CreateTable *makeTableHash (char *tableName, struct AttList *fromMe, char *attName);
+friend struct SQLStatement *makeCreateIndex (struct CreateIndex *fromMe);
+friend struct CreateIndex *makeIndex (char *indexName, char *tableName, char *attName);
+friend struct CreateIndex *includeAtt (struct CreateIndex *addToMe, char *attName);
 friend struct AttList *makeAttList (char *attName, int whichType);
 friend struct FromList *makeFromList (char *tableName, char *aliasName);
 friend struct FromList *appendFromList (struct FromList *appendToMe, char *tableName, char *aliasName);
@@ -59,9 +59,24 @@ struct SQLStatement *makeCreateTable (struct CreateTable *fromMe);
 // makes a regular database table
 struct CreateTable *makeTableRegular (char *tableName, struct AttList *fromMe);
 
+// makes a regular database table with the given page format (ex: "slotted")
+struct CreateTable *makeTableWithFormat (char *tableName, struct AttList *fromMe, char *pageFormat);
+
 // makes a B+-Tree table
 struct CreateTable *makeTableBPlusTree (char *tableName, struct AttList *fromMe, char *attName);
 
+// makes a hash file table
+struct CreateTable *makeTableHash (char *tableName, struct AttList *fromMe, char *attName);
+
+// builds an SQL statement out of a create index
+struct SQLStatement *makeCreateIndex (struct CreateIndex *fromMe);
+
+// makes a secondary index over the given attribute of the given table
+struct CreateIndex *makeIndex (char *indexName, char *tableName, char *attName);
+
+// adds an attribute to the list of attributes that are included in the entries of an index
+struct CreateIndex *includeAtt (struct CreateIndex *addToMe, char *attName);
+
 // makes an attribute list out of a single attribute
 struct AttList *makeAttList (char *attName, int whichType);
 
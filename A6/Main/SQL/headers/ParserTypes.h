@@ -7,6 +7,7 @@
 #include "ExprTree.h"
 #include "MyDB_Catalog.h"
 #include "MyDB_Schema.h"
+#include "MyDB_SecondaryIndex.h"
 #include "MyDB_Table.h"
 #include <string>
 #include <utility>
@@ -97,12 +98,17 @@ private:
 	// the list of atts to create... the string is the att name
 	vector <pair <string, MyDB_AttTypePtr>> attsToCreate;
 
-	// true if we create a B+-Tree
-	bool isBPlusTree;
+	// the type of file to create, if it is organized on an attribute ("bplustree" or "hash");
+	// this is empty for a regular file
+	string keyedFileType;
 
-	// the attribute to organize the B+-Tree on
+	// the attribute to organize the B+-Tree (or hash file) on
 	string sortAtt;
 
+	// the page format for a regular file ("packed" or "slotted"); "pax" instead makes a file
+	// of type "pax", where each page stores its records a column at a time
+	string pageFormat;
+
 public:
 	string addToCatalog (string storageDir, MyDB_CatalogPtr addToMe) {
 
@@ -115,21 +121,31 @@ public:
 		// now, make the table
 		MyDB_TablePtr myTable;
 
+		// a PAX file
+		if (keyedFileType == "" && pageFormat == "pax") {
+			myTable =  make_shared <MyDB_Table> (tableName, 
+				storageDir + "/" + tableName + ".bin", mySchema, "pax", "none");	
+
 		// just a regular file
-		if (!isBPlusTree) {
+		} else if (keyedFileType == "") {
+			if (pageFormat != "packed" && pageFormat != "slotted") {
+				cout << "Unknown page format " << pageFormat << "; table not created.\n";
+				return "nothing";
+			}
 			myTable =  make_shared <MyDB_Table> (tableName, 
 				storageDir + "/" + tableName + ".bin", mySchema);	
+			myTable->setPageFormat (pageFormat);
 
-		// creating a B+-Tree
+		// creating a B+-Tree or a hash file
 		} else {
 			
 			// make sure that we have the attribute
 			if (mySchema->getAttByName (sortAtt).first == -1) {
-				cout << "B+-Tree not created.\n";
+				cout << (keyedFileType == "hash" ? "Hash file" : "B+-Tree") << " not created.\n";
 				return "nothing";
 			}
 			myTable =  make_shared <MyDB_Table> (tableName, 
-				storageDir + "/" + tableName + ".bin", mySchema, "bplustree", sortAtt);	
+				storageDir + "/" + tableName + ".bin", mySchema, keyedFileType, sortAtt);	
 		}
 
 		// and add to the catalog
@@ -143,14 +159,17 @@ public:
 	CreateTable (string tableNameIn, vector <pair <string, MyDB_AttTypePtr>> atts) {
 		tableName = tableNameIn;
 		attsToCreate = atts;
-		isBPlusTree = false;
+		keyedFileType = "";
+		pageFormat = "packed";
 	}
 
-	CreateTable (string tableNameIn, vector <pair <string, MyDB_AttTypePtr>> atts, string sortAttIn) {
+	CreateTable (string tableNameIn, vector <pair <string, MyDB_AttTypePtr>> atts, string sortAttIn,
+		string keyedFileTypeIn) {
 		tableName = tableNameIn;
 		attsToCreate = atts;
-		isBPlusTree = true;
+		keyedFileType = keyedFileTypeIn;
 		sortAtt = sortAttIn;
+		pageFormat = "packed";
 	}
 	
 	~CreateTable () {}
@@ -158,6 +177,60 @@ public:
 	#include "FriendDecls.h"
 };
 
+// structure to encapsulate a create index
+struct CreateIndex {
+
+private:
+
+	// the name of the index, and the table and attribute that it is over
+	string indexName;
+	string tableName;
+	string attName;
+
+	// the attributes that are stored in each entry, along with the key
+	vector <string> includedAtts;
+
+public:
+	string addToCatalog (string storageDir, MyDB_CatalogPtr addToMe) {
+
+		// make sure that we have the table, and that it is a heap (or PAX) file
+		MyDB_TablePtr baseTable = make_shared <MyDB_Table> ();
+		if (!baseTable->fromCatalog (tableName, addToMe)) {
+			cout << "Could not find table " << tableName << "; index not created.\n";
+			return "nothing";
+		}
+		if (baseTable->getFileType () != "heap" && baseTable->getFileType () != "pax") {
+			cout << "Only heap and PAX tables can have secondary indexes; index not created.\n";
+			return "nothing";
+		}
+
+		// and that we have the attributes
+		MyDB_TablePtr indexTable = MyDB_SecondaryIndex :: makeIndexTable (indexName,
+			storageDir + "/" + indexName + ".bin", baseTable, attName, includedAtts);
+		if (indexTable == nullptr) {
+			cout << "Could not find all of the attributes; index not created.\n";
+			return "nothing";
+		}
+
+		// and add to the catalog
+		indexTable->putInCatalog (addToMe);
+
+		return indexName;
+	}
+
+	CreateIndex () {}
+
+	CreateIndex (string indexNameIn, string tableNameIn, string attNameIn) {
+		indexName = indexNameIn;
+		tableName = tableNameIn;
+		attName = attNameIn;
+	}
+
+	~CreateIndex () {}
+
+	#include "FriendDecls.h"
+};
+
 // structure that stores a list of attributes
 struct AttList {
 
@@ -270,28 +343,48 @@ private:
 	CreateTable myTableToCreate;
 	bool isCreate;
 
+	// in case we are a create index
+	CreateIndex myIndexToCreate;
+	bool isIndex;
+
 public:
 	SQLStatement (struct SFWQuery* useMe) {
 		myQuery = *useMe;
 		isQuery = true;
 		isCreate = false;
+		isIndex = false;
 	}
 
 	SQLStatement (struct CreateTable *useMe) {
 		myTableToCreate = *useMe;
 		isQuery = false;
 		isCreate = true;
+		isIndex = false;
+	}
+
+	SQLStatement (struct CreateIndex *useMe) {
+		myIndexToCreate = *useMe;
+		isQuery = false;
+		isCreate = false;
+		isIndex = true;
 	}
 
 	bool isCreateTable () {
 		return isCreate;
 	}
 
+	bool isCreateIndex () {
+		return isIndex;
+	}
+
 	bool isSFWQuery () {
 		return isQuery;
 	}
 
+	// adds the table or index that is created to the catalog
 	string addToCatalog (string storageDir, MyDB_CatalogPtr addToMe) {
+		if (isIndex)
+			return myIndexToCreate.addToCatalog (storageDir, addToMe);
 		return myTableToCreate.addToCatalog (storageDir, addToMe);
 	}		
 	
@@ -14,6 +14,7 @@
 	struct SQLStatement *myStatement;
 	struct SFWQuery *mySelectQuery;
 	struct CreateTable *myCreateTable;
+	struct CreateIndex *myCreateIndex;
 	struct FromList *myFromList;
 	struct AttList *myAttList;
 	struct Value *myValue;
@@ -47,7 +48,10 @@
 %token INT
 %token BOOL
 %token BPLUSTREE
+%token HASH
 %token CREATE
+%token INDEX
+%token INCLUDE
 %token DOUBLE
 %token STRING
 %token ON
@@ -62,6 +66,8 @@
 %type <allValues> ValueList
 %type <myStatement> SQLStatement
 %type <myCreateTable> CreateTable
+%type <myCreateIndex> CreateIndex
+%type <myCreateIndex> IndexWithIncludes
 %type <myAttList> AttList
 %type <myAttList> Att
 %type <myFromList> FromList
@@ -90,6 +96,12 @@ SQLStatement: SelectQuery
 	*myStatement = $$;
 }
 
+| CreateIndex
+{
+	$$ = makeCreateIndex ($1);
+	*myStatement = $$;
+}
+
 //********* Create Table Statement
 
 CreateTable: CREATE TABLE IDENTIFIER '(' 
@@ -98,12 +110,46 @@ CreateTable: CREATE TABLE IDENTIFIER '('
 	$$ = makeTableRegular ($3, $5);	
 }
 
+| CREATE TABLE IDENTIFIER '(' 
+		AttList ')' AS IDENTIFIER 
+{
+	$$ = makeTableWithFormat ($3, $5, $8);
+}
+
 | CREATE TABLE IDENTIFIER '(' 
 		AttList ')' AS BPLUSTREE ON IDENTIFIER 
 {
 	$$ = makeTableBPlusTree ($3, $5, $10);
 }
 
+| CREATE TABLE IDENTIFIER '(' 
+		AttList ')' AS HASH ON IDENTIFIER 
+{
+	$$ = makeTableHash ($3, $5, $10);
+}
+
+//********* Create Index Statement
+
+CreateIndex: CREATE INDEX IDENTIFIER ON IDENTIFIER '(' IDENTIFIER ')'
+{
+	$$ = makeIndex ($3, $5, $7);
+}
+
+| IndexWithIncludes ')'
+{
+	$$ = $1;
+}
+
+IndexWithIncludes: CREATE INDEX IDENTIFIER ON IDENTIFIER '(' IDENTIFIER ')' INCLUDE '(' IDENTIFIER
+{
+	$$ = includeAtt (makeIndex ($3, $5, $7), $11);
+}
+
+| IndexWithIncludes ',' IDENTIFIER
+{
+	$$ = includeAtt ($1, $3);
+}
+
 AttList : AttList ',' Att 
 {
 	$$ = appendAttList ($1, $3);
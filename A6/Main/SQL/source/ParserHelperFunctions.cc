@@ -2,6 +2,7 @@
 #ifndef SQL_PARSER_C
 #define SQL_PARSER_C
 
+#include <ctype.h>
 #include <iostream>
 #include <stdlib.h>
 #include "ExprTree.h"
@@ -214,14 +215,53 @@ struct CreateTable *makeTableRegular (char *tableName, struct AttList *fromMe) {
 	return returnVal;
 }
 
+struct CreateTable *makeTableWithFormat (char *tableName, struct AttList *fromMe, char *pageFormat) {
+	auto returnVal = new CreateTable (string (tableName), fromMe->atts);
+	returnVal->pageFormat = string (pageFormat);
+	for (auto &c : returnVal->pageFormat)
+		c = tolower (c);
+	free (tableName);
+	free (pageFormat);
+	delete fromMe;
+	return returnVal;
+}
+
 struct CreateTable *makeTableBPlusTree (char *tableName, struct AttList *fromMe, char *attName) {
-	auto returnVal = new CreateTable (string (tableName), fromMe->atts, string (attName));
+	auto returnVal = new CreateTable (string (tableName), fromMe->atts, string (attName), "bplustree");
+	free (tableName);
+	delete fromMe;
+	delete attName;
+	return returnVal;
+}
+
+struct CreateTable *makeTableHash (char *tableName, struct AttList *fromMe, char *attName) {
+	auto returnVal = new CreateTable (string (tableName), fromMe->atts, string (attName), "hash");
 	free (tableName);
 	delete fromMe;
 	delete attName;
 	return returnVal;
 }
 
+struct SQLStatement *makeCreateIndex (struct CreateIndex *fromMe) {
+	auto returnVal = new SQLStatement (fromMe);
+	delete fromMe;
+	return returnVal;
+}
+
+struct CreateIndex *makeIndex (char *indexName, char *tableName, char *attName) {
+	auto returnVal = new CreateIndex (string (indexName), string (tableName), string (attName));
+	free (indexName);
+	free (tableName);
+	free (attName);
+	return returnVal;
+}
+
+struct CreateIndex *includeAtt (struct CreateIndex *addToMe, char *attName) {
+	addToMe->includedAtts.push_back (string (attName));
+	free (attName);
+	return addToMe;
+}
+
 // structure that stores a list of aliases from a FROM clause
 } // extern
 
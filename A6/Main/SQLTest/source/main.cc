@@ -5,11 +5,17 @@
 #include "MyDB_BufferManager.h"
 #include "MyDB_TableReaderWriter.h"
 #include "MyDB_BPlusTreeReaderWriter.h"
+#include "MyDB_HashReaderWriter.h"
+#include "MyDB_SecondaryIndex.h"
 #include <string>      
 #include <iostream>   
 #include <sstream>
 #include <algorithm>
 #include <iterator>
+#include <thread>
+
+// the number of records sampled by the analyze command
+#define ANALYZE_SAMPLE_SIZE 30000
 
 using namespace std;
 string toLower (string data) {
@@ -40,13 +46,32 @@ int main (int numArgs, char **args) {
 	// and this is just the B+-Trees
 	static map <string, MyDB_BPlusTreeReaderWriterPtr> allBPlusReaderWriters;
 
-	// load 'em up
+	// and the hash files
+	static map <string, MyDB_HashReaderWriterPtr> allHashReaderWriters;
+
+	// and the secondary indexes, which are not tables that can be queried
+	static map <string, MyDB_SecondaryIndexPtr> allIndexes;
+
+	// load 'em up; the indexes are opened once the tables that they index are
 	for (auto &a : allTables) {
-		if (a.second->getFileType () == "heap") {
+		if (a.second->getIndexOf () != "") {
+			continue;
+		} else if (a.second->getFileType () == "heap" || a.second->getFileType () == "pax") {
 			allTableReaderWriters[a.first] =  make_shared <MyDB_TableReaderWriter> (a.second, myMgr);
 		} else if (a.second->getFileType () == "bplustree") {
 			allBPlusReaderWriters[a.first] = make_shared <MyDB_BPlusTreeReaderWriter> (a.second->getSortAtt (), a.second, myMgr);
 			allTableReaderWriters[a.first] = allBPlusReaderWriters[a.first];	
+		} else if (a.second->getFileType () == "hash") {
+			allHashReaderWriters[a.first] = make_shared <MyDB_HashReaderWriter> (a.second->getSortAtt (), a.second, myMgr);
+			allTableReaderWriters[a.first] = allHashReaderWriters[a.first];
+		}
+	}
+
+	for (auto &a : allTables) {
+		if (a.second->getIndexOf () != "" && allTableReaderWriters.count (a.second->getIndexOf ()) != 0) {
+			MyDB_TableReaderWriterPtr baseTable = allTableReaderWriters[a.second->getIndexOf ()];
+			allIndexes[a.first] = make_shared <MyDB_SecondaryIndex> (a.second, *baseTable, myMgr);
+			baseTable->addIndex (allIndexes[a.first]);
 		}
 	}
 
@@ -99,8 +124,10 @@ int main (int numArgs, char **args) {
 					} else {
 						cout << "OK, loading " << tokens[1] << " from text file.\n";
 
-						// load up the file
-						pair <vector <size_t>, size_t> res = allTableReaderWriters[tokens[1]]->loadFromTextFile (tokens[3]);
+						// load up the file, using as many threads as we have cores
+						int numThreads = thread :: hardware_concurrency ();
+						pair <vector <size_t>, size_t> res = allTableReaderWriters[tokens[1]]->bulkLoadFromTextFile (tokens[3],
+							numThreads > 0 ? numThreads : 1);
 
 						// and record the tuple various counts
 						allTableReaderWriters[tokens[1]]->getTable ()->setDistinctValues (res.first);
@@ -109,6 +136,66 @@ int main (int numArgs, char **args) {
 					}
 				}
 
+				// see if we got a "load soandso into abplustree", with an optional fill factor
+				if ((tokens.size () == 4 || tokens.size () == 5) && toLower(tokens[0]) == "load" &&
+					toLower(tokens[2]) == "into") {
+
+					// make sure the tables are there
+					if (allTableReaderWriters.count (tokens[1]) == 0) {
+						cout << "Could not find table " << tokens[1] << ".\n";
+						break;
+					} else if (allBPlusReaderWriters.count (tokens[3]) == 0) {
+						cout << "Could not find B+-Tree " << tokens[3] << ".\n";
+						break;
+					} else {
+						double fillFactor = BPLUS_DEFAULT_FILL_FACTOR;
+						if (tokens.size () == 5)
+							fillFactor = atof (tokens[4].c_str ());
+						if (fillFactor <= 0.0 || fillFactor > 1.0) {
+							cout << "The fill factor must be in (0, 1].\n";
+							break;
+						}
+						cout << "OK, bulk loading " << tokens[3] << " from " << tokens[1] << ".\n";
+
+						// build the tree, and record the tuple various counts
+						pair <vector <size_t>, size_t> res = allBPlusReaderWriters[tokens[3]]->bulkLoad (
+							*allTableReaderWriters[tokens[1]], fillFactor);
+						allBPlusReaderWriters[tokens[3]]->getTable ()->setDistinctValues (res.first);
+						allBPlusReaderWriters[tokens[3]]->getTable ()->setTupleCount (res.second);
+						cout << "Loaded " << res.second << " records into " <<
+							allBPlusReaderWriters[tokens[3]]->getNumPages () << " pages.\n";
+						break;
+					}
+				}
+
+				// see if we got an "analyze soandso"
+				if (tokens.size () == 2 && toLower(tokens[0]) == "analyze") {
+
+					// make sure the table is there
+					if (allTableReaderWriters.count (tokens[1]) == 0) {
+						cout << "Could not find table " << tokens[1] << ".\n";
+						break;
+					} else {
+						cout << "OK, analyzing " << tokens[1] << ".\n";
+
+						// compute the stats
+						allTableReaderWriters[tokens[1]]->analyze (ANALYZE_SAMPLE_SIZE);
+
+						// and print a summary
+						MyDB_TablePtr myTable = allTableReaderWriters[tokens[1]]->getTable ();
+						cout << myTable->getTupleCount () << " tuples.\n";
+						int i = 0;
+						for (auto &a : myTable->getSchema ()->getAtts ()) {
+							MyDB_ColumnStats &stats = myTable->getColumnStats (i);
+							cout << a.first << ": [" << stats.getMin () << ", " << stats.getMax () << "], "
+								<< myTable->getDistinctValues (i) << " distinct, " << stats.getMCVs ().size ()
+								<< " most common values.\n";
+							i++;
+						}
+						break;
+					}
+				}
+
 				// get the string to parse
 				string parseMe = ss.str ();
 
@@ -147,7 +234,8 @@ int main (int numArgs, char **args) {
 						string tableName = final->addToCatalog (args[2], myCatalog);
 						if (tableName != "nothing") {
 							allTables = MyDB_Table :: getAllTables (myCatalog);
-							if (allTables [tableName]->getFileType () == "heap") {
+							if (allTables [tableName]->getFileType () == "heap" ||
+								allTables [tableName]->getFileType () == "pax") {
 								allTableReaderWriters[tableName] = 
 									make_shared <MyDB_TableReaderWriter> (allTables [tableName], myMgr);
 							} else if (allTables [tableName]->getFileType () == "bplustree") {
@@ -155,10 +243,31 @@ int main (int numArgs, char **args) {
 									make_shared <MyDB_BPlusTreeReaderWriter> 
 										(allTables [tableName]->getSortAtt (), allTables [tableName], myMgr);
 								allTableReaderWriters[tableName] = allBPlusReaderWriters[tableName];
+							} else if (allTables [tableName]->getFileType () == "hash") {
+								allHashReaderWriters[tableName] = 
+									make_shared <MyDB_HashReaderWriter> 
+										(allTables [tableName]->getSortAtt (), allTables [tableName], myMgr);
+								allTableReaderWriters[tableName] = allHashReaderWriters[tableName];
 							}
 							cout << "Added table " << final->addToCatalog (args[2], myCatalog) << "\n";
 						}	
 
+					// see if we got a create index
+					} else if (final->isCreateIndex ()) {
+
+						// build the index over the records that are already in the table
+						string indexName = final->addToCatalog (args[2], myCatalog);
+						if (indexName != "nothing") {
+							allTables = MyDB_Table :: getAllTables (myCatalog);
+							MyDB_TableReaderWriterPtr baseTable = 
+								allTableReaderWriters[allTables [indexName]->getIndexOf ()];
+							allIndexes[indexName] = make_shared <MyDB_SecondaryIndex> 
+								(allTables [indexName], *baseTable, myMgr);
+							baseTable->addIndex (allIndexes[indexName]);
+							size_t numEntries = allIndexes[indexName]->build ();
+							cout << "Added index " << indexName << " with " << numEntries << " entries\n";
+						}
+
 					} else if (final->isSFWQuery ()) {
 
 						// print it out
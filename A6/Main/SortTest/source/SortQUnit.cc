@@ -5,15 +5,23 @@
 #include "MyDB_AttType.h"  
 #include "MyDB_BufferManager.h"
 #include "MyDB_Catalog.h"  
+#include "MyDB_KeyNormalizer.h"
 #include "MyDB_Page.h"
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_Record.h"
 #include "MyDB_Table.h"
 #include "MyDB_TableReaderWriter.h"
 #include "MyDB_Schema.h"
+#include "MyDB_ZoneFilter.h"
 #include "QUnit.h"
+#include "RecordComparator.h"
 #include "Sorting.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <thread>
 
 int main () {
 
@@ -46,6 +54,93 @@ int main () {
 		myTable->putInCatalog (myCatalog);
 	}
 
+	{
+		// compare the parallel bulk loader with the record-at-a-time loader
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 128, "tempFile");
+		MyDB_TableReaderWriter supplierTable (allTables["supplier"], myMgr);
+
+		MyDB_TablePtr bulkTable = make_shared <MyDB_Table> ("supplierBulk", 
+			"supplierBulk.bin", allTables["supplier"]->getSchema ());
+		MyDB_TableReaderWriter bulkTableRW (bulkTable, myMgr);
+
+		// time the two loaders on the same file
+		int numThreads = thread :: hardware_concurrency ();
+		numThreads = numThreads > 0 ? numThreads : 1;
+		auto start = chrono :: steady_clock :: now ();
+		pair <vector <size_t>, size_t> regularRes = supplierTable.loadFromTextFile ("supplierBig.tbl");
+		auto middle = chrono :: steady_clock :: now ();
+		pair <vector <size_t>, size_t> res = bulkTableRW.bulkLoadFromTextFile ("supplierBig.tbl", numThreads);
+		auto end = chrono :: steady_clock :: now ();
+
+		ifstream textFile ("supplierBig.tbl", ifstream :: ate | ifstream :: binary);
+		double megs = textFile.tellg () / (1024.0 * 1024.0);
+		double regularSecs = chrono :: duration <double> (middle - start).count ();
+		double bulkSecs = chrono :: duration <double> (end - middle).count ();
+		cout << "loadFromTextFile: " << megs / regularSecs << " MB/s\n";
+		cout << "bulkLoadFromTextFile (" << numThreads << " threads): " << megs / bulkSecs << " MB/s\n";
+		QUNIT_IS_EQUAL (res.second, 320000);
+
+		// merging the per-thread sketches gives exactly the sketch of the whole file; there
+		// are 10000 distinct suppkeys and 25 distinct nationkeys
+		QUNIT_IS_TRUE (res.first == regularRes.first);
+		QUNIT_IS_TRUE (res.first[0] > 9700 && res.first[0] < 10300);
+		QUNIT_IS_EQUAL (res.first[3], 25);
+		QUNIT_IS_EQUAL (bulkTable->getTupleCount (), 320000);
+
+		// the two tables should have exactly the same records, in the same order
+		MyDB_RecordPtr rec1 = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rec2 = bulkTableRW.getEmptyRecord ();
+		MyDB_RecordIteratorAltPtr myIterOne = supplierTable.getIteratorAlt ();
+		MyDB_RecordIteratorAltPtr myIterTwo = bulkTableRW.getIteratorAlt ();
+		int matches = 0;
+		while (myIterOne->advance () && myIterTwo->advance ()) {
+			myIterOne->getCurrent (rec1);
+			myIterTwo->getCurrent (rec2);
+			stringstream one, two;
+			one << rec1;
+			two << rec2;
+			if (one.str () == two.str ())
+				matches++;
+		}
+		QUNIT_IS_EQUAL (matches, 320000);
+
+		// appending keeps the statistics up to date
+		rec2->getAtt (0)->fromInt (-1);
+		rec2->recordContentHasChanged ();
+		bulkTableRW.append (rec2);
+		QUNIT_IS_EQUAL (bulkTable->getTupleCount (), 320001);
+
+		// and the sketches survive a trip through the catalog
+		bulkTable->putInCatalog (myCatalog);
+		MyDB_TablePtr fromCat = make_shared <MyDB_Table> ();
+		fromCat->fromCatalog ("supplierBulk", myCatalog);
+		QUNIT_IS_EQUAL (fromCat->getDistinctValues ("suppkey"), bulkTable->getDistinctValues ("suppkey"));
+		QUNIT_IS_EQUAL (fromCat->getTupleCount (), 320001);
+		QUNIT_IS_TRUE (fromCat->getSketch (0).toString () == bulkTable->getSketch (0).toString ());
+
+		// analyze the table, and check the selectivity estimates; the suppkeys are uniform
+		// over 0..9999 (plus the -1 appended above) and there are 25 nationkeys
+		bulkTableRW.analyze (10000);
+		QUNIT_IS_EQUAL (bulkTable->getTupleCount (), 320001);
+		QUNIT_IS_EQUAL (bulkTable->getColumnStats (0).getMin (), "-1");
+		QUNIT_IS_EQUAL (bulkTable->getColumnStats (0).getMax (), "9999");
+		double sel = bulkTable->getSelectivity ("nationkey", MyDB_CompOp :: Equals, "5");
+		QUNIT_IS_TRUE (sel > 0.03 && sel < 0.05);
+		sel = bulkTable->getSelectivity ("suppkey", MyDB_CompOp :: LessThan, "5000");
+		QUNIT_IS_TRUE (sel > 0.45 && sel < 0.55);
+		sel = bulkTable->getRangeSelectivity ("suppkey", "1000", "2999");
+		QUNIT_IS_TRUE (sel > 0.17 && sel < 0.23);
+		QUNIT_IS_EQUAL (bulkTable->getSelectivity ("suppkey", MyDB_CompOp :: GreaterThan, "20000"), 0.0);
+
+		// and these survive a trip through the catalog
+		bulkTable->putInCatalog (myCatalog);
+		fromCat->fromCatalog ("supplierBulk", myCatalog);
+		QUNIT_IS_EQUAL (fromCat->getSelectivity ("suppkey", MyDB_CompOp :: LessThan, "5000"),
+			bulkTable->getSelectivity ("suppkey", MyDB_CompOp :: LessThan, "5000"));
+	}
+
 	{
 		// use the alternative iterator on the file
 	        // load up the table supplier table from the catalog
@@ -148,6 +243,305 @@ int main () {
 		outTable->putInCatalog (myCatalog);
 	}
 
+	{
+		// compare sorting with normalized keys to sorting with the comparator
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 128, "tempFile");
+		MyDB_TableReaderWriter supplierTable (allTables["supplier"], myMgr);
+		MyDB_TableReaderWriter sortedTable (allTables["supplierSorted"], myMgr);
+
+		MyDB_TablePtr outTable = make_shared <MyDB_Table> ("supplierSortedKeys", 
+			"supplierSortedKeys.bin", allTables["supplier"]->getSchema ());
+		MyDB_TableReaderWriter outputTable (outTable, myMgr);
+
+		MyDB_RecordPtr rec1 = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rec2 = supplierTable.getEmptyRecord ();
+		function <bool ()> myComp = buildRecordComparator (rec1, rec2, "[acctbal]");
+		MyDB_KeyNormalizerPtr keys = make_shared <MyDB_KeyNormalizer> (rec1, rec2, "[acctbal]");
+
+		// time the sort both ways, and check that the keyed sort gives the same order
+		auto start = chrono :: steady_clock :: now ();
+		MyDB_RecordIteratorAltPtr myIterOne = buildItertorOverSortedRuns (64, supplierTable, myComp, rec1, rec2);
+		while (myIterOne->advance ())
+			myIterOne->getCurrent (rec1);
+		auto middle = chrono :: steady_clock :: now ();
+		sort (64, supplierTable, outputTable, keys);
+		auto end = chrono :: steady_clock :: now ();
+		cout << "sort using the comparator: " << chrono :: duration <double> (middle - start).count () << " secs\n";
+		cout << "sort using normalized keys: " << chrono :: duration <double> (end - middle).count () << " secs\n";
+
+		myIterOne = sortedTable.getIteratorAlt ();
+		MyDB_RecordIteratorAltPtr myIterTwo = outputTable.getIteratorAlt ();
+		int matches = 0;
+		while (myIterOne->advance () && myIterTwo->advance ()) {
+			myIterOne->getCurrent (rec1);
+			myIterTwo->getCurrent (rec2);
+			if (rec1->getAtt (5)->toDouble () == rec2->getAtt (5)->toDouble ())
+				matches++;
+		}
+		QUNIT_IS_EQUAL (matches, 320000);
+
+		// now sort on a string, using a page that has strings that tie on their first 16 bytes
+		MyDB_PageReaderWriter tempPage (*myMgr);
+		vector <string> names {"Supplier#000000002", "Supplier#000000001", "Supplier#0000000", 
+			"Supplier#000000003", "Supplier", "Supplier#000000001"};
+		for (auto &s : names) {
+			rec1->getAtt (1)->fromString (s);
+			rec1->recordContentHasChanged ();
+			tempPage.append (rec1);
+		}
+		tempPage.sortInPlace (make_shared <MyDB_KeyNormalizer> (rec1, rec2, "[name]"));
+		std :: sort (names.begin (), names.end ());
+		MyDB_RecordIteratorAltPtr pageIter = tempPage.getIteratorAlt ();
+		matches = 0;
+		for (auto &s : names) {
+			pageIter->advance ();
+			pageIter->getCurrent (rec1);
+			if (rec1->getAtt (1)->toString () == s)
+				matches++;
+		}
+		QUNIT_IS_EQUAL (matches, 6);
+	}
+
+	{
+		// compare the radix sort of the keys with a comparison sort, on int, double, and string keys
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 128, "tempFile");
+		MyDB_TableReaderWriter supplierTable (allTables["supplier"], myMgr);
+		MyDB_RecordPtr rec1 = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rec2 = supplierTable.getEmptyRecord ();
+
+		vector <MyDB_PageReaderWriter> pages;
+		for (int i = 0; i < 64; i++)
+			pages.push_back (MyDB_PageReaderWriter (true, supplierTable, i));
+
+		for (string key : {"[suppkey]", "[nationkey]", "[acctbal]", "[name]"}) {
+			MyDB_KeyNormalizerPtr keys = make_shared <MyDB_KeyNormalizer> (rec1, rec2, key);
+			vector <pair <MyDB_NormalizedKey, void *>> positions, pagePositions;
+			vector <char> rows;
+			for (auto &page : pages) {
+				pagePositions.clear ();
+				MyDB_PageReaderWriter :: getKeys (page.getBytes (), page.getPageSize (), keys, pagePositions, rows);
+				positions.insert (positions.end (), pagePositions.begin (), pagePositions.end ());
+			}
+			vector <pair <MyDB_NormalizedKey, void *>> positionsAgain = positions;
+
+			auto start = chrono :: steady_clock :: now ();
+			std :: stable_sort (positions.begin (), positions.end (), KeyedRecordComparator (keys));
+			auto middle = chrono :: steady_clock :: now ();
+			keys->sort (positionsAgain);
+			auto end = chrono :: steady_clock :: now ();
+			cout << "sorting " << positions.size () << " keys on " << key << ": "
+				<< chrono :: duration <double> (middle - start).count () << " secs comparing, "
+				<< chrono :: duration <double> (end - middle).count () << " secs with the radix sort\n";
+
+			// both sorts are stable, so they have to put the records in exactly the same order
+			size_t same = 0;
+			for (size_t i = 0; i < positions.size (); i++)
+				if (positions[i].second == positionsAgain[i].second)
+					same++;
+			QUNIT_IS_EQUAL (same, positions.size ());
+		}
+	}
+
+	{
+		// compare merging with a loser tree to merging runs two at a time
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 128, "tempFile");
+		MyDB_TableReaderWriter supplierTable (allTables["supplier"], myMgr);
+
+		MyDB_RecordPtr rec1 = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rec2 = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rec3 = supplierTable.getEmptyRecord ();
+		MyDB_KeyNormalizerPtr keys = make_shared <MyDB_KeyNormalizer> (rec1, rec2, "[acctbal]");
+
+		auto start = chrono :: steady_clock :: now ();
+		MyDB_RecordIteratorAltPtr pairwiseIter = buildItertorOverSortedRuns (64, supplierTable, keys, "bool[true]",
+			MyDB_MergeKind :: Pairwise, 1, MyDB_RunKind :: SortPages);
+		vector <double> pairwise;
+		while (pairwiseIter->advance ()) {
+			pairwiseIter->getCurrent (rec3);
+			pairwise.push_back (rec3->getAtt (5)->toDouble ());
+		}
+		auto middle = chrono :: steady_clock :: now ();
+		MyDB_RecordIteratorAltPtr treeIter = buildItertorOverSortedRuns (64, supplierTable, keys, "bool[true]",
+			MyDB_MergeKind :: LoserTree, 1, MyDB_RunKind :: SortPages);
+		vector <double> tree;
+		while (treeIter->advance ()) {
+			treeIter->getCurrent (rec3);
+			tree.push_back (rec3->getAtt (5)->toDouble ());
+		}
+		auto end = chrono :: steady_clock :: now ();
+		cout << "sort merging pairwise: " << chrono :: duration <double> (middle - start).count () << " secs\n";
+		cout << "sort merging with a loser tree: " << chrono :: duration <double> (end - middle).count () << " secs\n";
+
+		QUNIT_IS_EQUAL (tree.size (), 320000);
+		QUNIT_IS_TRUE (tree == pairwise);
+		QUNIT_IS_TRUE (is_sorted (tree.begin (), tree.end ()));
+
+		// a run of small pages, so that there are lots of runs to merge, with a predicate
+		treeIter = buildItertorOverSortedRuns (2, supplierTable, keys, "== ([nationkey], int[4])");
+		int count = 0;
+		double last = -1000000.0;
+		bool sorted = true;
+		while (treeIter->advance ()) {
+			treeIter->getCurrent (rec3);
+			sorted = sorted && rec3->getAtt (5)->toDouble () >= last && rec3->getAtt (3)->toInt () == 4;
+			last = rec3->getAtt (5)->toDouble ();
+			count++;
+		}
+		QUNIT_IS_TRUE (sorted);
+		QUNIT_IS_EQUAL (count, 13280);
+	}
+
+	{
+		// build the sorted runs with several threads
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 128, "tempFile");
+		MyDB_TableReaderWriter supplierTable (allTables["supplier"], myMgr);
+		MyDB_TableReaderWriter sortedTable (allTables["supplierSorted"], myMgr);
+
+		MyDB_TablePtr outTable = make_shared <MyDB_Table> ("supplierSortedParallel", 
+			"supplierSortedParallel.bin", allTables["supplier"]->getSchema ());
+		MyDB_TableReaderWriter outputTable (outTable, myMgr);
+
+		MyDB_RecordPtr rec1 = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rec2 = supplierTable.getEmptyRecord ();
+		MyDB_KeyNormalizerPtr keys = make_shared <MyDB_KeyNormalizer> (rec1, rec2, "[acctbal]");
+
+		int numThreads = thread :: hardware_concurrency () < 4 ? 4 : thread :: hardware_concurrency ();
+		auto start = chrono :: steady_clock :: now ();
+		sort (64, supplierTable, outputTable, keys, numThreads);
+		auto end = chrono :: steady_clock :: now ();
+		cout << "sort using " << numThreads << " threads: " << chrono :: duration <double> (end - start).count () << " secs\n";
+
+		MyDB_RecordIteratorAltPtr myIterOne = sortedTable.getIteratorAlt ();
+		MyDB_RecordIteratorAltPtr myIterTwo = outputTable.getIteratorAlt ();
+		int matches = 0;
+		while (myIterOne->advance () && myIterTwo->advance ()) {
+			myIterOne->getCurrent (rec1);
+			myIterTwo->getCurrent (rec2);
+			if (rec1->getAtt (5)->toDouble () == rec2->getAtt (5)->toDouble ())
+				matches++;
+		}
+		QUNIT_IS_EQUAL (matches, 320000);
+		QUNIT_IS_FALSE (myIterTwo->advance ());
+
+		// with a predicate, and with more threads than pages in a run
+		MyDB_RecordIteratorAltPtr myIter = buildItertorOverSortedRuns (2, supplierTable, keys, 
+			"== ([nationkey], int[4])", 3);
+		int count = 0;
+		double last = -1000000.0;
+		bool sorted = true;
+		while (myIter->advance ()) {
+			myIter->getCurrent (rec1);
+			sorted = sorted && rec1->getAtt (5)->toDouble () >= last && rec1->getAtt (3)->toInt () == 4;
+			last = rec1->getAtt (5)->toDouble ();
+			count++;
+		}
+		QUNIT_IS_TRUE (sorted);
+		QUNIT_IS_EQUAL (count, 13280);
+	}
+
+	{
+		// make the runs using replacement selection
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 128, "tempFile");
+		MyDB_TableReaderWriter supplierTable (allTables["supplier"], myMgr);
+		MyDB_TableReaderWriter sortedTable (allTables["supplierSorted"], myMgr);
+
+		MyDB_RecordPtr rec1 = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rec2 = supplierTable.getEmptyRecord ();
+		MyDB_KeyNormalizerPtr keys = make_shared <MyDB_KeyNormalizer> (rec1, rec2, "[acctbal]");
+
+		// on random input, the runs should be about twice as long as the memory used
+		auto start = chrono :: steady_clock :: now ();
+		vector <vector <MyDB_PageReaderWriter>> runs = replacementSelection (8, supplierTable, keys, "bool[true]");
+		auto end = chrono :: steady_clock :: now ();
+		int numPagesToSort = supplierTable.getNumPages ();
+		cout << "replacement selection made " << runs.size () << " runs from " << numPagesToSort << " pages with 8 pages of memory in "
+			<< chrono :: duration <double> (end - start).count () << " secs\n";
+		QUNIT_IS_TRUE (runs.size () * 3 < (size_t) numPagesToSort / 8 * 2);
+		runs.clear ();
+
+		// and on sorted input, there should be just one run
+		runs = replacementSelection (8, sortedTable, keys, "bool[true]");
+		QUNIT_IS_EQUAL (runs.size (), 1);
+		runs.clear ();
+
+		// the whole sort should give the same answer as before
+		MyDB_RecordIteratorAltPtr myIterOne = sortedTable.getIteratorAlt ();
+		MyDB_RecordIteratorAltPtr myIterTwo = buildItertorOverSortedRuns (8, supplierTable, keys, "bool[true]",
+			MyDB_RunKind :: ReplacementSelection);
+		MyDB_RecordPtr rec3 = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rec4 = supplierTable.getEmptyRecord ();
+		int matches = 0;
+		while (myIterOne->advance () && myIterTwo->advance ()) {
+			myIterOne->getCurrent (rec3);
+			myIterTwo->getCurrent (rec4);
+			if (rec3->getAtt (5)->toDouble () == rec4->getAtt (5)->toDouble ())
+				matches++;
+		}
+		QUNIT_IS_EQUAL (matches, 320000);
+		QUNIT_IS_FALSE (myIterTwo->advance ());
+
+		// with a predicate, over input that is already sorted
+		myIterTwo = buildItertorOverSortedRuns (8, sortedTable, keys, "== ([nationkey], int[4])",
+			MyDB_RunKind :: ReplacementSelection);
+		int count = 0;
+		double last = -1000000.0;
+		bool sorted = true;
+		while (myIterTwo->advance ()) {
+			myIterTwo->getCurrent (rec3);
+			sorted = sorted && rec3->getAtt (5)->toDouble () >= last && rec3->getAtt (3)->toInt () == 4;
+			last = rec3->getAtt (5)->toDouble ();
+			count++;
+		}
+		QUNIT_IS_TRUE (sorted);
+		QUNIT_IS_EQUAL (count, 13280);
+	}
+
+	{
+		// sort a table that is a lot bigger than the buffer, so that the runs have to be merged
+		// in more than one pass
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 16, "tempFile");
+		MyDB_TableReaderWriter supplierTable (allTables["supplier"], myMgr);
+		MyDB_TableReaderWriter sortedTable (allTables["supplierSorted"], myMgr);
+
+		MyDB_TablePtr outTable = make_shared <MyDB_Table> ("supplierSortedSmallBuffer", 
+			"supplierSortedSmallBuffer.bin", allTables["supplier"]->getSchema ());
+		MyDB_TableReaderWriter outputTable (outTable, myMgr);
+
+		MyDB_RecordPtr rec1 = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rec2 = supplierTable.getEmptyRecord ();
+		MyDB_KeyNormalizerPtr keys = make_shared <MyDB_KeyNormalizer> (rec1, rec2, "[acctbal]");
+
+		auto start = chrono :: steady_clock :: now ();
+		sort (8, supplierTable, outputTable, keys);
+		auto end = chrono :: steady_clock :: now ();
+		cout << "sort of " << supplierTable.getNumPages () << " pages with 16 pages of buffer: " 
+			<< chrono :: duration <double> (end - start).count () << " secs\n";
+
+		MyDB_RecordIteratorAltPtr myIterOne = sortedTable.getIteratorAlt ();
+		MyDB_RecordIteratorAltPtr myIterTwo = outputTable.getIteratorAlt ();
+		int matches = 0;
+		while (myIterOne->advance () && myIterTwo->advance ()) {
+			myIterOne->getCurrent (rec1);
+			myIterTwo->getCurrent (rec2);
+			if (rec1->getAtt (5)->toDouble () == rec2->getAtt (5)->toDouble ())
+				matches++;
+		}
+		QUNIT_IS_EQUAL (matches, 320000);
+		QUNIT_IS_FALSE (myIterTwo->advance ());
+	}
+
 	{
 
 		// load up the two tables from the catalog
@@ -192,6 +586,81 @@ int main () {
 
                 QUNIT_IS_EQUAL (matches, 320000);
 	}
+
+	{
+		// zone maps: scan data that is clustered on acctbal, with and without skipping pages
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 128, "tempFile");
+
+		// one copy is built by the bulk loader, and one a record at a time
+		MyDB_TablePtr bulkTable = make_shared <MyDB_Table> ("supplierClustered", "supplierClustered.bin",
+			allTables["supplier"]->getSchema ());
+		MyDB_TableReaderWriter bulkTableRW (bulkTable, myMgr);
+		int numThreads = thread :: hardware_concurrency () < 2 ? 2 : thread :: hardware_concurrency ();
+		bulkTableRW.bulkLoadFromTextFile ("supplierBigSorted.tbl", numThreads);
+		bulkTable->putInCatalog (myCatalog);
+		MyDB_TableReaderWriter appendTableRW (allTables["supplierSorted"], myMgr);
+
+		vector <string> predicates {
+			"< ([acctbal], double[-900.0])",
+			"&& (> ([acctbal], double[1000.0]), > (double[1100.0], [acctbal]))",
+			"&& (== ([name], string[Supplier#000000092]), > ([acctbal], double[2000.0]))",
+			"|| (< ([acctbal], double[-900.0]), > ([acctbal], double[9900.0]))"};
+
+		for (size_t i = 0; i < predicates.size (); i++) {
+			for (MyDB_TableReaderWriter *table : {&bulkTableRW, &appendTableRW}) {
+
+				MyDB_RecordPtr rec = table->getEmptyRecord ();
+				func pred = rec->compileComputation (predicates[i]);
+
+				// scan the whole table
+				auto start = chrono :: high_resolution_clock :: now ();
+				int fullMatches = 0;
+				MyDB_RecordIteratorAltPtr myIter = table->getIteratorAlt ();
+				while (myIter->advance ()) {
+					myIter->getCurrent (rec);
+					if (pred ()->toBool ())
+						fullMatches++;
+				}
+				auto middle = chrono :: high_resolution_clock :: now ();
+
+				// and skip pages using the zones
+				int matches = 0;
+				MyDB_ZoneFilterPtr filter = make_shared <MyDB_ZoneFilter> (predicates[i], table->getTable ());
+				myIter = table->getIteratorAlt (filter);
+				while (myIter->advance ()) {
+					myIter->getCurrent (rec);
+					if (pred ()->toBool ())
+						matches++;
+				}
+				auto end = chrono :: high_resolution_clock :: now ();
+
+				cout << table->getTable ()->getName () << " where " << predicates[i] << ": " << matches << " matches; "
+					<< filter->getPagesRead () << " pages read, " << filter->getPagesSkipped () << " skipped; "
+					<< chrono :: duration <double> (middle - start).count () << " secs without zones, "
+					<< chrono :: duration <double> (end - middle).count () << " secs with zones\n";
+				QUNIT_IS_EQUAL (matches, fullMatches);
+				QUNIT_IS_EQUAL ((int) (filter->getPagesRead () + filter->getPagesSkipped ()), table->getNumPages ());
+				if (i < 3) {
+					QUNIT_IS_TRUE (filter->getPagesSkipped () > filter->getPagesRead ());
+				} else {
+					QUNIT_IS_EQUAL (filter->getPagesSkipped (), 0);
+				}
+			}
+		}
+
+		// the zones should come back from the side file
+		MyDB_TablePtr fromCat = MyDB_Table :: getAllTables (myCatalog)["supplierClustered"];
+		MyDB_ZoneFilter fromCatFilter (predicates[0], fromCat);
+		MyDB_ZoneFilter bulkFilter (predicates[0], bulkTable);
+		int same = 0;
+		for (int page = 0; page < bulkTableRW.getNumPages (); page++)
+			if (fromCatFilter.canSkip (page) == bulkFilter.canSkip (page))
+				same++;
+		QUNIT_IS_EQUAL (same, bulkTableRW.getNumPages ());
+		QUNIT_IS_EQUAL (fromCatFilter.getPagesSkipped (), bulkFilter.getPagesSkipped ());
+	}
 }
 
 #endif